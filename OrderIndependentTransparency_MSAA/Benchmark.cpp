@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "OIT/CommandLine.hpp"
+#include "OIT/Engine.hpp"
+#include "OIT/ImageCompare.hpp"
+#include "OIT/PerfCounters.hpp"
+#include "OIT/Scenes.hpp"
+
+namespace {
+
+	constexpr char const* USAGE =
+		"Usage: OITBenchmark [options], list options take comma separated values and run their cross product\n"
+		"  --width N, --height N       default render target size (1920x1280)\n"
+		"  --resolution WxH,...        render target sizes\n"
+		"  --scene NAME,...            default, uniform, heavy-tail, tiny, glass\n"
+		"  --scene-layers N,...        --scene-triangles N,...\n"
+		"  --triangle-size X, --alpha X, --seed N\n"
+		"  --method NAME,...           linked-list, weighted, mlab, adaptive, moments, depth-peeling, prefix-sum\n"
+		"  --mlab-layers N,...         --at-nodes N,...\n"
+		"  --msaa N,...                --fragments N,...   --layers N,...   --threads N,...   --chunk N,...\n"
+		"  --heads NAME,...            linear, tiled\n"
+		"  --allocation NAME,...       thread, tile\n"
+		"  --isa NAME,...              auto, scalar, sse4.2, avx2, avx512\n"
+		"  --resolve NAME,...          per-sample, single, front-to-back\n"
+		"  --epsilon X,...             transmittance threshold of the front-to-back resolve\n"
+		"  --networks 0|1,...          --compact 0|1,...\n"
+		"  --warmup N                  frames before measuring (2)\n"
+		"  --frames N                  measured frames (10)\n"
+		"  --json FILE                 write every result to FILE\n"
+		"  --compare                   compare against the depth peeling reference\n"
+		"  --help                      print this text\n";
+
+	struct Configuration {
+		OIT::SceneDesc  Scene;
+		OIT::EngineDesc Engine;
+	};
+
+	struct Result {
+		Configuration        Config;
+		uint32_t             ThreadCount = 0;
+		OIT::InstructionSet  InstructionSet = OIT::InstructionSet::Scalar;
+		double               FrameMs = 0.0;
+		double               BuildMs = 0.0;
+		double               ResolveMs = 0.0;
+		double               BuildNsPerPixel = 0.0;
+		double               ResolveNsPerPixel = 0.0;
+		double               NodesPerSecond = 0.0;
+		double               FetchesPerPixel = 0.0;
+		double               LinesPerTile = 0.0;
+		uint64_t             Fragments = 0;
+		uint64_t             DroppedFragments = 0;
+		uint64_t             ChunkClaims = 0;
+		uint64_t             CounterRetries = 0;
+		uint64_t             PeakMemoryBytes = 0;
+		uint64_t             ImageHash = 0;
+		// CPU duration percentiles of every EnginePass over the measured frames.
+		std::vector<OIT::SampleSummary> Passes;
+		bool                 HasCacheMisses = false;
+		double               L1DMissesPerPixel = 0.0;
+		double               LLCMissesPerPixel = 0.0;
+		// Last frame against RenderReference and the median frame over the reference frame, only with --compare.
+		bool                 HasError = false;
+		OIT::ImageError      Error;
+		double               ReferenceMs = 0.0;
+		double               TimeRatio = 0.0;
+	};
+
+	auto ParseResolution(std::string const& value) -> std::pair<uint32_t, uint32_t> {
+		auto const separator = value.find('x');
+		try {
+			if (separator != std::string::npos)
+				return { static_cast<uint32_t>(std::stoul(value.substr(0, separator))), static_cast<uint32_t>(std::stoul(value.substr(separator + 1))) };
+		}
+		catch (std::exception const&) {
+		}
+		throw std::invalid_argument("Invalid resolution, expected WIDTHxHEIGHT: " + value);
+	}
+
+	// FNV-1a over the back buffer, so runs can be compared for identical output without keeping the images.
+	auto HashImage(OIT::Image const& image) -> uint64_t {
+		uint64_t hash = 0xCBF29CE484222325ull;
+		for (auto const texel : image.Texels) {
+			for (uint32_t shift = 0; shift < 32; shift += 8) {
+				hash ^= (texel >> shift) & 0xFF;
+				hash *= 0x100000001B3ull;
+			}
+		}
+		return hash;
+	}
+
+	auto RunConfiguration(Configuration const& config, OIT::Scene const& scene, OIT::ReferenceFrame const* pReference, uint32_t warmupCount, uint32_t frameCount) -> Result {
+		OIT::Engine engine(config.Engine);
+
+		for (uint32_t frameIdx = 0; frameIdx < warmupCount; frameIdx++)
+			engine.RenderFrame(scene);
+		engine.ResetProfiler();
+
+		// The counters follow the calling thread, so they only cover a frame when the engine runs single-threaded.
+		OIT::CacheMissCounters cacheMissCounters;
+		auto const isCountingMisses = cacheMissCounters.IsAvailable() && engine.GetThreadCount() == 1;
+		OIT::CacheMissCounts cacheMisses;
+
+		uint64_t peakMemoryBytes = engine.GetMemoryUsage();
+		for (uint32_t frameIdx = 0; frameIdx < frameCount; frameIdx++) {
+			cacheMissCounters.Start();
+			engine.RenderFrame(scene);
+			auto const frameMisses = cacheMissCounters.Stop();
+			cacheMisses.L1DReadMisses += frameMisses.L1DReadMisses;
+			cacheMisses.LLCMisses += frameMisses.LLCMisses;
+			peakMemoryBytes = std::max(peakMemoryBytes, engine.GetMemoryUsage());
+		}
+
+		auto const statistics = engine.GetListBuilderStatistics();
+		auto const& resolveStatistics = engine.GetResolveStatistics();
+		auto const locality = engine.MeasureNodeLocality();
+		auto const pixelCount = static_cast<double>(config.Engine.Width) * config.Engine.Height;
+
+		Result result;
+		result.Config = config;
+		result.ThreadCount = engine.GetThreadCount();
+		result.InstructionSet = engine.GetResolveInstructionSet();
+		for (uint32_t passIdx = 0; passIdx < engine.GetProfiler().GetPassCount(); passIdx++)
+			result.Passes.push_back(engine.GetProfiler().GetCPUSummary(passIdx));
+		result.FrameMs = result.Passes[static_cast<uint32_t>(OIT::EnginePass::Frame)].P50;
+		result.BuildMs = result.Passes[static_cast<uint32_t>(OIT::EnginePass::Transparent)].P50;
+		result.ResolveMs = result.Passes[static_cast<uint32_t>(OIT::EnginePass::ResolveOIT)].P50;
+		result.BuildNsPerPixel = result.BuildMs * 1e6 / pixelCount;
+		result.ResolveNsPerPixel = result.ResolveMs * 1e6 / pixelCount;
+		result.NodesPerSecond = result.BuildMs > 0.0 ? (engine.GetTransparentFragmentCount() - statistics.DroppedFragments) / (result.BuildMs * 1e-3) : 0.0;
+		result.FetchesPerPixel = resolveStatistics.ResolvedPixels ? static_cast<double>(resolveStatistics.NodesFetched) / resolveStatistics.ResolvedPixels : 0.0;
+		result.LinesPerTile = locality.Tiles ? static_cast<double>(locality.CacheLines) / locality.Tiles : 0.0;
+		result.Fragments = engine.GetTransparentFragmentCount();
+		result.DroppedFragments = statistics.DroppedFragments;
+		result.ChunkClaims = statistics.ChunkClaims;
+		result.CounterRetries = statistics.CounterRetries;
+		result.PeakMemoryBytes = peakMemoryBytes;
+		result.ImageHash = HashImage(engine.GetBackBuffer());
+		result.HasCacheMisses = isCountingMisses;
+		result.L1DMissesPerPixel = cacheMisses.L1DReadMisses / (pixelCount * frameCount);
+		result.LLCMissesPerPixel = cacheMisses.LLCMisses / (pixelCount * frameCount);
+		if (pReference) {
+			result.HasError = true;
+			result.Error = OIT::CompareImages(engine.GetBackBuffer(), pReference->BackBuffer);
+			result.ReferenceMs = pReference->FrameMs;
+			result.TimeRatio = pReference->FrameMs > 0.0 ? result.FrameMs / pReference->FrameMs : 0.0;
+		}
+		return result;
+	}
+
+	auto PrintResult(Result const& result) -> void {
+		auto const& scene = result.Config.Scene;
+		auto const& desc = result.Config.Engine;
+
+		char missColumns[2][16] = { "-", "-" };
+		if (result.HasCacheMisses) {
+			std::snprintf(missColumns[0], sizeof(missColumns[0]), "%.2f", result.L1DMissesPerPixel);
+			std::snprintf(missColumns[1], sizeof(missColumns[1]), "%.2f", result.LLCMissesPerPixel);
+		}
+
+		char errorColumns[4][16] = { "-", "-", "-", "-" };
+		if (result.HasError) {
+			std::snprintf(errorColumns[0], sizeof(errorColumns[0]), "%u", result.Error.MaxDelta);
+			std::snprintf(errorColumns[1], sizeof(errorColumns[1]), "%.4f", result.Error.MeanDelta);
+			std::snprintf(errorColumns[2], sizeof(errorColumns[2]), "%.2f", result.Error.PSNR);
+			std::snprintf(errorColumns[3], sizeof(errorColumns[3]), "%.3f", result.TimeRatio);
+		}
+
+		char layerColumn[16] = "-";
+		if (desc.Method == OIT::TransparencyMethod::MultiLayerAlphaBlending)
+			std::snprintf(layerColumn, sizeof(layerColumn), "%u", desc.MLABLayerCount);
+		if (desc.Method == OIT::TransparencyMethod::AdaptiveTransparency)
+			std::snprintf(layerColumn, sizeof(layerColumn), "%u", desc.ATNodeCount);
+
+		char epsilonColumn[16] = "-";
+		if (desc.Resolve == OIT::ResolveMode::FrontToBack)
+			std::snprintf(epsilonColumn, sizeof(epsilonColumn), "%.3g", desc.ResolveTransmittanceEpsilon);
+
+		auto const resolution = std::to_string(desc.Width) + "x" + std::to_string(desc.Height);
+		std::printf("%10s %13s %4s %10s %5u %5u %6u %7u %7u %6s %6s %7s %13s %9s %8s %7s %10.3f %10.3f %10.3f %10.1f %10.2f %10.1f %12llu %9.1f %12llu %12llu %12s %12s %8s %9s %8s %8s\n",
+			OIT::ToString(scene.Kind), OIT::ToString(desc.Method), layerColumn, resolution.c_str(), desc.MSAASamples, desc.FragmentCount, desc.OITLayerCount, result.ThreadCount, desc.NodeChunkSize,
+			OIT::ToString(desc.HeadPointers), OIT::ToString(desc.Allocation), OIT::ToString(result.InstructionSet), OIT::ToString(desc.Resolve), desc.ResolveSortingNetworks ? "network" : "insertion", epsilonColumn, desc.CompactNodes ? "on" : "off",
+			result.FrameMs, result.BuildNsPerPixel, result.ResolveNsPerPixel, result.NodesPerSecond * 1e-6, result.FetchesPerPixel, result.LinesPerTile,
+			static_cast<unsigned long long>(result.DroppedFragments), result.PeakMemoryBytes / (1024.0 * 1024.0),
+			static_cast<unsigned long long>(result.ChunkClaims), static_cast<unsigned long long>(result.CounterRetries), missColumns[0], missColumns[1], errorColumns[0], errorColumns[1], errorColumns[2], errorColumns[3]);
+	}
+
+	auto WriteJson(std::string const& fileName, std::vector<Result> const& results, uint32_t warmupCount, uint32_t frameCount) -> void {
+		std::unique_ptr<FILE, decltype(&std::fclose)> pFile(std::fopen(fileName.c_str(), "w"), &std::fclose);
+		if (!pFile)
+			throw std::runtime_error("Failed to open " + fileName);
+
+		auto const file = pFile.get();
+		std::fprintf(file, "{\n  \"node_encoding\": %u,\n  \"node_layout\": \"%s\",\n  \"warmup_frames\": %u,\n  \"frames\": %u,\n  \"results\": [",
+			OIT::NODE_ENCODING, OIT::NODE_LAYOUT_SOA ? "soa" : "aos", warmupCount, frameCount);
+		for (size_t resultIdx = 0; resultIdx < results.size(); resultIdx++) {
+			auto const& result = results[resultIdx];
+			auto const& scene = result.Config.Scene;
+			auto const& desc = result.Config.Engine;
+			std::fprintf(file, "%s\n    {\n", resultIdx ? "," : "");
+			std::fprintf(file, "      \"scene\": \"%s\", \"scene_layers\": %u, \"scene_triangles\": %u, \"triangle_size\": %g, \"alpha\": %g, \"seed\": %u,\n",
+				OIT::ToString(scene.Kind), scene.Layers, scene.TriangleCount, scene.TriangleSize, scene.Alpha, scene.Seed);
+			std::fprintf(file, "      \"method\": \"%s\", \"mlab_layers\": %u, \"at_nodes\": %u, \"width\": %u, \"height\": %u, \"msaa\": %u, \"fragment_count\": %u, \"oit_layer_count\": %u,\n",
+				OIT::ToString(desc.Method), desc.MLABLayerCount, desc.ATNodeCount, desc.Width, desc.Height, desc.MSAASamples, desc.FragmentCount, desc.OITLayerCount);
+			std::fprintf(file, "      \"threads\": %u, \"chunk\": %u, \"heads\": \"%s\", \"allocation\": \"%s\", \"isa\": \"%s\", \"resolve\": \"%s\", \"sorting_networks\": %s, \"transmittance_epsilon\": %.6g, \"compact_nodes\": %s,\n",
+				result.ThreadCount, desc.NodeChunkSize, OIT::ToString(desc.HeadPointers), OIT::ToString(desc.Allocation), OIT::ToString(result.InstructionSet),
+				OIT::ToString(desc.Resolve), desc.ResolveSortingNetworks ? "true" : "false", desc.ResolveTransmittanceEpsilon, desc.CompactNodes ? "true" : "false");
+			std::fprintf(file, "      \"frame_ms\": %.4f, \"build_ms\": %.4f, \"resolve_ms\": %.4f, \"build_ns_per_pixel\": %.4f, \"resolve_ns_per_pixel\": %.4f, \"nodes_per_second\": %.1f,\n",
+				result.FrameMs, result.BuildMs, result.ResolveMs, result.BuildNsPerPixel, result.ResolveNsPerPixel, result.NodesPerSecond);
+			std::fprintf(file, "      \"fragments\": %llu, \"dropped_fragments\": %llu, \"chunk_claims\": %llu, \"cas_retries\": %llu, \"fetches_per_pixel\": %.4f, \"lines_per_tile\": %.4f,\n",
+				static_cast<unsigned long long>(result.Fragments), static_cast<unsigned long long>(result.DroppedFragments), static_cast<unsigned long long>(result.ChunkClaims),
+				static_cast<unsigned long long>(result.CounterRetries), result.FetchesPerPixel, result.LinesPerTile);
+			if (result.HasCacheMisses)
+				std::fprintf(file, "      \"l1d_misses_per_pixel\": %.4f, \"llc_misses_per_pixel\": %.4f,\n", result.L1DMissesPerPixel, result.LLCMissesPerPixel);
+			if (result.HasError) {
+				// JSON has no infinity, identical images write a null PSNR.
+				char psnr[32] = "null";
+				if (std::isfinite(result.Error.PSNR))
+					std::snprintf(psnr, sizeof(psnr), "%.4f", result.Error.PSNR);
+				std::fprintf(file, "      \"max_delta\": %u, \"mean_delta\": %.4f, \"rmse\": %.4f, \"psnr\": %s, \"reference_ms\": %.4f, \"time_ratio\": %.4f,\n",
+					result.Error.MaxDelta, result.Error.MeanDelta, result.Error.RMSE, psnr, result.ReferenceMs, result.TimeRatio);
+			}
+			std::fprintf(file, "      \"passes\": {");
+			for (uint32_t passIdx = 0; passIdx < result.Passes.size(); passIdx++) {
+				auto const& summary = result.Passes[passIdx];
+				std::fprintf(file, "%s\n        \"%s\": { \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }", passIdx ? "," : "",
+					OIT::ToString(static_cast<OIT::EnginePass>(passIdx)), summary.P50, summary.P95, summary.P99, summary.Max);
+			}
+			std::fprintf(file, "\n      },\n");
+			std::fprintf(file, "      \"peak_memory_bytes\": %llu, \"image_hash\": \"%016llx\"\n    }",
+				static_cast<unsigned long long>(result.PeakMemoryBytes), static_cast<unsigned long long>(result.ImageHash));
+		}
+		std::fprintf(file, "\n  ]\n}\n");
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		OIT::CommandLine const commandLine(argc, argv);
+		if (commandLine.HasFlag("help")) {
+			std::printf("%s", USAGE);
+			return 0;
+		}
+
+		Configuration baseConfig;
+		baseConfig.Engine.Width         = commandLine.GetUint("width", 1920);
+		baseConfig.Engine.Height        = commandLine.GetUint("height", 1280);
+		baseConfig.Scene.TriangleSize   = commandLine.GetFloat("triangle-size", baseConfig.Scene.TriangleSize);
+		baseConfig.Scene.Alpha          = commandLine.GetFloat("alpha", baseConfig.Scene.Alpha);
+		baseConfig.Scene.Seed           = commandLine.GetUint("seed", baseConfig.Scene.Seed);
+
+		auto const warmupCount = commandLine.GetUint("warmup", 2);
+		auto const frameCount  = std::max(1u, commandLine.GetUint("frames", 10));
+		baseConfig.Engine.ProfileHistory = frameCount;
+		auto const jsonName    = commandLine.GetString("json", std::string());
+		auto const isCompare   = commandLine.HasFlag("compare");
+
+		// Cross product of every list option, the first option varying slowest. Options of a single method only take
+		// their first value for the other methods, which would otherwise repeat identical runs.
+		std::vector<Configuration> configurations = { baseConfig };
+		auto const Expand = [&](auto const& values, auto&& apply, std::initializer_list<OIT::TransparencyMethod> methods = {}) -> void {
+			std::vector<Configuration> expanded;
+			for (auto const& config : configurations) {
+				for (auto const& value : values) {
+					auto variant = config;
+					apply(variant, value);
+					expanded.push_back(variant);
+					if (methods.size() != 0 && std::find(methods.begin(), methods.end(), variant.Engine.Method) == methods.end())
+						break;
+				}
+			}
+			configurations = std::move(expanded);
+		};
+
+		auto const defaultResolution = std::to_string(baseConfig.Engine.Width) + "x" + std::to_string(baseConfig.Engine.Height);
+		Expand(commandLine.GetStringList("scene", { "default" }), [](Configuration& config, std::string const& value) { config.Scene.Kind = OIT::ParseSceneKind(value); });
+		Expand(commandLine.GetUintList("scene-layers", { baseConfig.Scene.Layers }), [](Configuration& config, uint32_t value) { config.Scene.Layers = value; });
+		Expand(commandLine.GetUintList("scene-triangles", { baseConfig.Scene.TriangleCount }), [](Configuration& config, uint32_t value) { config.Scene.TriangleCount = value; });
+		Expand(commandLine.GetStringList("method", { "linked-list" }), [](Configuration& config, std::string const& value) { config.Engine.Method = OIT::ParseTransparencyMethod(value); });
+		Expand(commandLine.GetUintList("mlab-layers", { baseConfig.Engine.MLABLayerCount }), [](Configuration& config, uint32_t value) { config.Engine.MLABLayerCount = value; }, { OIT::TransparencyMethod::MultiLayerAlphaBlending });
+		Expand(commandLine.GetUintList("at-nodes", { baseConfig.Engine.ATNodeCount }), [](Configuration& config, uint32_t value) { config.Engine.ATNodeCount = value; }, { OIT::TransparencyMethod::AdaptiveTransparency });
+		Expand(commandLine.GetStringList("resolution", { defaultResolution }), [](Configuration& config, std::string const& value) {
+			std::tie(config.Engine.Width, config.Engine.Height) = ParseResolution(value);
+		});
+		Expand(commandLine.GetUintList("msaa", { baseConfig.Engine.MSAASamples }), [](Configuration& config, uint32_t value) { config.Engine.MSAASamples = value; });
+		Expand(commandLine.GetUintList("fragments", { baseConfig.Engine.FragmentCount }), [](Configuration& config, uint32_t value) { config.Engine.FragmentCount = value; }, { OIT::TransparencyMethod::LinkedList, OIT::TransparencyMethod::PrefixSum });
+		Expand(commandLine.GetUintList("layers", { baseConfig.Engine.OITLayerCount }), [](Configuration& config, uint32_t value) { config.Engine.OITLayerCount = value; }, { OIT::TransparencyMethod::LinkedList });
+		Expand(commandLine.GetUintList("threads", { 0 }), [](Configuration& config, uint32_t value) { config.Engine.ThreadCount = value; });
+		Expand(commandLine.GetUintList("chunk", { baseConfig.Engine.NodeChunkSize }), [](Configuration& config, uint32_t value) { config.Engine.NodeChunkSize = value; }, { OIT::TransparencyMethod::LinkedList });
+		Expand(commandLine.GetStringList("heads", { "linear" }), [](Configuration& config, std::string const& value) { config.Engine.HeadPointers = OIT::ParseHeadLayout(value); }, { OIT::TransparencyMethod::LinkedList });
+		Expand(commandLine.GetStringList("allocation", { "thread" }), [](Configuration& config, std::string const& value) { config.Engine.Allocation = OIT::ParseNodeAllocation(value); }, { OIT::TransparencyMethod::LinkedList });
+		Expand(commandLine.GetStringList("isa", { "auto" }), [](Configuration& config, std::string const& value) { config.Engine.ResolveInstructionSet = OIT::ParseInstructionSet(value); }, { OIT::TransparencyMethod::LinkedList, OIT::TransparencyMethod::PrefixSum });
+		Expand(commandLine.GetStringList("resolve", { "per-sample", "single" }), [](Configuration& config, std::string const& value) { config.Engine.Resolve = OIT::ParseResolveMode(value); }, { OIT::TransparencyMethod::LinkedList, OIT::TransparencyMethod::PrefixSum });
+		// The epsilon only matters to the front to back resolve, the other resolves take its first value.
+		{
+			auto const epsilons = commandLine.GetFloatList("epsilon", { baseConfig.Engine.ResolveTransmittanceEpsilon });
+			std::vector<Configuration> expanded;
+			for (auto const& config : configurations) {
+				for (auto const epsilon : epsilons) {
+					auto variant = config;
+					variant.Engine.ResolveTransmittanceEpsilon = epsilon;
+					expanded.push_back(variant);
+					if (variant.Engine.Resolve != OIT::ResolveMode::FrontToBack)
+						break;
+				}
+			}
+			configurations = std::move(expanded);
+		}
+		Expand(commandLine.GetUintList("networks", { 0 }), [](Configuration& config, uint32_t value) { config.Engine.ResolveSortingNetworks = value != 0; }, { OIT::TransparencyMethod::LinkedList, OIT::TransparencyMethod::PrefixSum });
+		Expand(commandLine.GetUintList("compact", { 0 }), [](Configuration& config, uint32_t value) { config.Engine.CompactNodes = value != 0; }, { OIT::TransparencyMethod::LinkedList });
+		commandLine.CheckUnused();
+
+		std::printf("NODE_ENCODING %u %s, %u warmup + %u measured frames, medians\n", OIT::NODE_ENCODING, OIT::NODE_LAYOUT_SOA ? "SoA" : "AoS", warmupCount, frameCount);
+		std::printf("%10s %13s %4s %10s %5s %5s %6s %7s %7s %6s %6s %7s %13s %9s %8s %7s %10s %10s %10s %10s %10s %10s %12s %9s %12s %12s %12s %12s %8s %9s %8s %8s\n",
+			"scene", "method", "k", "resolution", "msaa", "frag", "layers", "threads", "chunk", "heads", "alloc", "isa", "resolve", "sort", "epsilon", "compact", "frame ms", "build ns/px", "resolve ns/px",
+			"M nodes/s", "fetches/px", "lines/tile", "dropped", "peak MB", "claims", "cas retries", "L1D miss/px", "LLC miss/px", "max err", "mean err", "PSNR", "time x");
+
+		std::vector<Result> results;
+		// One depth peeling reference per scene and render target size, shared by every method and option drawing it.
+		std::map<std::string, OIT::ReferenceFrame> references;
+		for (auto const& config : configurations) {
+			auto const scene = OIT::CreateScene(config.Scene);
+			OIT::ReferenceFrame const* pReference = nullptr;
+			if (isCompare) {
+				auto const& sceneDesc = config.Scene;
+				auto const key = std::string(OIT::ToString(sceneDesc.Kind)) + " " + std::to_string(sceneDesc.Layers) + " " + std::to_string(sceneDesc.TriangleCount) + " " +
+					std::to_string(sceneDesc.TriangleSize) + " " + std::to_string(sceneDesc.Alpha) + " " + std::to_string(sceneDesc.Seed) + " " +
+					std::to_string(config.Engine.Width) + "x" + std::to_string(config.Engine.Height) + " " + std::to_string(config.Engine.MSAASamples);
+				auto reference = references.find(key);
+				if (reference == references.end())
+					reference = references.emplace(key, OIT::RenderReference(config.Engine, scene)).first;
+				pReference = &reference->second;
+			}
+			results.push_back(RunConfiguration(config, scene, pReference, warmupCount, frameCount));
+			PrintResult(results.back());
+		}
+
+		if (!jsonName.empty()) {
+			WriteJson(jsonName, results, warmupCount, frameCount);
+			std::printf("Wrote %s\n", jsonName.c_str());
+		}
+	}
+	catch (std::exception const& e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <string>
+
+#include <wrl.h>
+#include <dxgi.h>
+#include <d3d11.h>
+#include <d3d11_3.h>
+#include <d3dcompiler.h>
+
+#include "OIT/ShaderCache.hpp"
+
+namespace DX {
+
+	class ComException : public std::exception {
+	public:
+		ComException(HRESULT hr) : m_Result(hr) {}
+
+		const char* what() const override {
+			static char s_str[64] = {};
+			sprintf_s(s_str, "Failure with HRESULT of %08X" ,static_cast<uint32_t>(m_Result));
+			return s_str;
+		}
+	private:
+		HRESULT m_Result;
+	};
+
+	inline auto ThrowIfFailed(HRESULT hr) -> void {
+		if (FAILED(hr))	
+			throw ComException(hr);
+	}
+
+	// Rasterizer ordered views are a D3D11.3 option that feature level 11_0 hardware may or may not expose.
+	inline auto IsROVSupported(Microsoft::WRL::ComPtr<ID3D11Device> pDevice) -> bool {
+		D3D11_FEATURE_DATA_D3D11_OPTIONS2 options = {};
+		return SUCCEEDED(pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS2, &options, sizeof(options))) && options.ROVsSupported;
+	}
+
+	// ID3DBlob over bytecode mapped from the shader cache, so a hit is never copied.
+	class MappedShaderBlob : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>, ID3DBlob> {
+	public:
+		MappedShaderBlob(std::unique_ptr<OIT::CachedShader> pShader) : m_pShader(std::move(pShader)) {}
+
+		LPVOID STDMETHODCALLTYPE GetBufferPointer() override { return const_cast<void*>(m_pShader->GetBytecode()); }
+
+		SIZE_T STDMETHODCALLTYPE GetBufferSize() override { return m_pShader->GetBytecodeSize(); }
+
+	private:
+		std::unique_ptr<OIT::CachedShader> m_pShader;
+	};
+
+	// With a cache, compiles only when no bytecode is stored for the source tree, defines, flags and compiler.
+	inline auto CompileShader(std::wstring const& fileName, std::string const& entryPoint, std::string const& target, std::vector<std::pair<std::string, std::string>> const& defines, OIT::ShaderCache* pShaderCache = nullptr) -> Microsoft::WRL::ComPtr<ID3DBlob> {
+		Microsoft::WRL::ComPtr<ID3DBlob> pCodeBlob;
+		Microsoft::WRL::ComPtr<ID3DBlob> pErrorBlob;
+
+		uint32_t shaderFlags = 0;
+#ifdef _DEBUG
+		shaderFlags |= D3DCOMPILE_DEBUG;
+		shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+		shaderFlags |= D3DCOMPILE_WARNINGS_ARE_ERRORS;
+#endif
+
+		uint64_t cacheKey = 0;
+		if (pShaderCache) {
+			cacheKey = pShaderCache->ComputeKey(fileName, entryPoint, target, defines, shaderFlags, D3D_COMPILER_VERSION);
+			if (auto pCachedShader = pShaderCache->Load(cacheKey))
+				return Microsoft::WRL::Make<MappedShaderBlob>(std::move(pCachedShader));
+		}
+
+		std::vector<D3D_SHADER_MACRO> d3dDefines;
+		for(auto const& e: defines)
+			d3dDefines.push_back({ e.first.c_str(), e.second.c_str() });
+
+		d3dDefines.push_back({ nullptr, nullptr });
+
+		if (FAILED(D3DCompileFromFile(fileName.c_str(), std::data(d3dDefines), D3D_COMPILE_STANDARD_FILE_INCLUDE, entryPoint.c_str(), target.c_str(), shaderFlags, 0, pCodeBlob.GetAddressOf(), pErrorBlob.GetAddressOf()))) {
+			std::printf(static_cast<const char*>(pErrorBlob->GetBufferPointer()));
+			throw std::runtime_error(static_cast<const char*>(pErrorBlob->GetBufferPointer()));
+		}	
+
+		if (pShaderCache)
+			pShaderCache->Store(cacheKey, pCodeBlob->GetBufferPointer(), pCodeBlob->GetBufferSize());
+		return pCodeBlob;
+	}
+
+	template<typename T>
+	auto CreateConstantBuffer(Microsoft::WRL::ComPtr<ID3D11Device> pDevice) -> Microsoft::WRL::ComPtr<ID3D11Buffer> {
+
+		Microsoft::WRL::ComPtr<ID3D11Buffer> pBuffer;
+		D3D11_BUFFER_DESC desc = {};
+		desc.ByteWidth = sizeof(T);
+		desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		desc.Usage = D3D11_USAGE_DYNAMIC;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		ThrowIfFailed(pDevice->CreateBuffer(&desc, nullptr, pBuffer.GetAddressOf()));
+		return pBuffer;
+	}
+
+	template<typename T>
+	auto CreateStructuredBuffer(Microsoft::WRL::ComPtr<ID3D11Device> pDevice, uint32_t numElements, bool isCPUWritable, bool isGPUWritable, const T* pInitialData = nullptr) -> Microsoft::WRL::ComPtr<ID3D11Buffer> {
+		Microsoft::WRL::ComPtr<ID3D11Buffer> pBuffer;
+
+		D3D11_BUFFER_DESC desc = {};
+		desc.ByteWidth = sizeof(T) * numElements;
+		if ((!isCPUWritable) && (!isGPUWritable)) {
+			desc.CPUAccessFlags = 0;
+			desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+			desc.Usage = D3D11_USAGE_IMMUTABLE;
+		}
+		else if (isCPUWritable && (!isGPUWritable)) {
+			desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+			desc.Usage = D3D11_USAGE_DYNAMIC;
+		}
+		else if ((!isCPUWritable) && isGPUWritable) {
+
+			desc.CPUAccessFlags = 0;
+			desc.BindFlags = (D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS);
+			desc.Usage = D3D11_USAGE_DEFAULT;
+		}
+		else {
+			assert((!(isCPUWritable && isGPUWritable)));
+		}
+
+		desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+		desc.StructureByteStride = sizeof(T);
+
+		D3D11_SUBRESOURCE_DATA data = {};
+		data.pSysMem = pInitialData;
+		ThrowIfFailed(pDevice->CreateBuffer((&desc), (pInitialData) ? (&data) : nullptr, pBuffer.GetAddressOf()));
+		return pBuffer;
+	}
+
+	class MSAAResolver{
+	public:
+		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pRTVSrc, Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pRTVDsv, DXGI_FORMAT format) const -> void {
+			Microsoft::WRL::ComPtr<ID3D11Resource> pTexture;
+			pRTVDsv->GetResource(pTexture.GetAddressOf());
+
+			Microsoft::WRL::ComPtr<ID3D11Resource> pTexture_MSAA;
+			pRTVSrc->GetResource(pTexture_MSAA.GetAddressOf());
+
+			pDeviceContext->ResolveSubresource(pTexture.Get(), 0, pTexture_MSAA.Get(), 0, format);
+		}
+
+		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDSVSrc, Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDSVDsv, DXGI_FORMAT format) const-> void {
+			static_assert(true, "No implementation");
+		}
+
+	};
+
+	// Reads the hidden counter of a UAV back without stalling the pipeline: every frame copies the counter into the
+	// next staging buffer of a small ring and the oldest copy is mapped with DO_NOT_WAIT. Frames are skipped while
+	// the ring is full, so the values arrive a few frames late and may have gaps. CopyElement reads a single uint of
+	// a buffer the same way. Each copy keeps a tag, e.g. the capacity it was recorded against, that TryRead hands
+	// back with the value.
+	class StructureCountReadback {
+	public:
+		static constexpr uint32_t LATENCY = 3;
+
+		auto Initialize(Microsoft::WRL::ComPtr<ID3D11Device> pDevice) -> void {
+			D3D11_BUFFER_DESC desc = {};
+			desc.ByteWidth = sizeof(uint32_t);
+			desc.Usage = D3D11_USAGE_STAGING;
+			desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+			for (auto& pBuffer : m_pBuffers)
+				ThrowIfFailed(pDevice->CreateBuffer(&desc, nullptr, pBuffer.ReleaseAndGetAddressOf()));
+			m_WriteIdx = 0;
+			m_ReadIdx = 0;
+		}
+
+		auto Copy(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAV, uint32_t tag = 0) -> void {
+			if (m_WriteIdx - m_ReadIdx == LATENCY)
+				return;
+			pDeviceContext->CopyStructureCount(m_pBuffers[m_WriteIdx % LATENCY].Get(), 0, pUAV.Get());
+			m_Tags[m_WriteIdx % LATENCY] = tag;
+			m_WriteIdx++;
+		}
+
+		auto CopyElement(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, Microsoft::WRL::ComPtr<ID3D11Buffer> pBuffer, uint32_t elementIdx, uint32_t tag = 0) -> void {
+			if (m_WriteIdx - m_ReadIdx == LATENCY)
+				return;
+			auto const box = CD3D11_BOX(sizeof(uint32_t) * elementIdx, 0, 0, sizeof(uint32_t) * (elementIdx + 1), 1, 1);
+			pDeviceContext->CopySubresourceRegion(m_pBuffers[m_WriteIdx % LATENCY].Get(), 0, 0, 0, 0, pBuffer.Get(), 0, &box);
+			m_Tags[m_WriteIdx % LATENCY] = tag;
+			m_WriteIdx++;
+		}
+
+		auto TryRead(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, uint32_t& value, uint32_t* pTag = nullptr) -> bool {
+			if (m_WriteIdx == m_ReadIdx)
+				return false;
+
+			D3D11_MAPPED_SUBRESOURCE mapped = {};
+			auto const pBuffer = m_pBuffers[m_ReadIdx % LATENCY].Get();
+			auto const hr = pDeviceContext->Map(pBuffer, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+			if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+				return false;
+			ThrowIfFailed(hr);
+
+			value = *static_cast<uint32_t const*>(mapped.pData);
+			pDeviceContext->Unmap(pBuffer, 0);
+			if (pTag)
+				*pTag = m_Tags[m_ReadIdx % LATENCY];
+			m_ReadIdx++;
+			return true;
+		}
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_pBuffers[LATENCY];
+		uint32_t                             m_Tags[LATENCY] = {};
+		uint64_t                             m_WriteIdx = 0;
+		uint64_t                             m_ReadIdx = 0;
+	};
+
+	// GPU duration between consecutive Timestamp calls of a frame, read back without stalling the pipeline. Every
+	// frame records into the next query set of a small ring and the oldest set is polled with DONOTFLUSH. Frames are
+	// skipped while the ring is full and dropped when the disjoint query reports an unreliable clock, so durations
+	// arrive a few frames late and may have gaps.
+	class TimestampQueries {
+	public:
+		static constexpr uint32_t LATENCY = 4;
+
+		auto Initialize(Microsoft::WRL::ComPtr<ID3D11Device> pDevice, uint32_t timestampCount) -> void {
+			for (auto& frame : m_Frames) {
+				D3D11_QUERY_DESC desc = {};
+				desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+				ThrowIfFailed(pDevice->CreateQuery(&desc, frame.pDisjoint.ReleaseAndGetAddressOf()));
+
+				desc.Query = D3D11_QUERY_TIMESTAMP;
+				frame.pTimestamps.resize(timestampCount);
+				for (auto& pTimestamp : frame.pTimestamps)
+					ThrowIfFailed(pDevice->CreateQuery(&desc, pTimestamp.ReleaseAndGetAddressOf()));
+			}
+			m_WriteIdx = 0;
+			m_ReadIdx = 0;
+			m_TimestampIdx = 0;
+			m_IsRecording = false;
+		}
+
+		auto BeginFrame(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext) -> void {
+			m_IsRecording = m_WriteIdx - m_ReadIdx < LATENCY;
+			m_TimestampIdx = 0;
+			if (m_IsRecording)
+				pDeviceContext->Begin(m_Frames[m_WriteIdx % LATENCY].pDisjoint.Get());
+		}
+
+		auto Timestamp(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext) -> void {
+			auto& frame = m_Frames[m_WriteIdx % LATENCY];
+			if (m_IsRecording && m_TimestampIdx < frame.pTimestamps.size())
+				pDeviceContext->End(frame.pTimestamps[m_TimestampIdx++].Get());
+		}
+
+		auto EndFrame(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext) -> void {
+			if (!m_IsRecording)
+				return;
+			assert(m_TimestampIdx == m_Frames[m_WriteIdx % LATENCY].pTimestamps.size());
+			pDeviceContext->End(m_Frames[m_WriteIdx % LATENCY].pDisjoint.Get());
+			m_WriteIdx++;
+			m_IsRecording = false;
+		}
+
+		// Milliseconds between each timestamp and the next one of the oldest finished frame.
+		auto TryRead(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, std::vector<double>& durations) -> bool {
+			if (m_WriteIdx == m_ReadIdx)
+				return false;
+
+			auto const& frame = m_Frames[m_ReadIdx % LATENCY];
+			D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+			if (pDeviceContext->GetData(frame.pDisjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+				return false;
+
+			std::vector<uint64_t> timestamps(frame.pTimestamps.size());
+			for (size_t timestampIdx = 0; timestampIdx < timestamps.size(); timestampIdx++) {
+				if (pDeviceContext->GetData(frame.pTimestamps[timestampIdx].Get(), &timestamps[timestampIdx], sizeof(uint64_t), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+					return false;
+			}
+			m_ReadIdx++;
+
+			if (disjoint.Disjoint || disjoint.Frequency == 0)
+				return false;
+
+			durations.clear();
+			for (size_t timestampIdx = 1; timestampIdx < timestamps.size(); timestampIdx++)
+				durations.push_back(static_cast<double>(timestamps[timestampIdx] - timestamps[timestampIdx - 1]) * 1000.0 / disjoint.Frequency);
+			return true;
+		}
+
+	private:
+		struct FrameQueries {
+			Microsoft::WRL::ComPtr<ID3D11Query>              pDisjoint;
+			std::vector<Microsoft::WRL::ComPtr<ID3D11Query>> pTimestamps;
+		};
+
+	private:
+		FrameQueries m_Frames[LATENCY];
+		uint64_t     m_WriteIdx = 0;
+		uint64_t     m_ReadIdx = 0;
+		size_t       m_TimestampIdx = 0;
+		bool         m_IsRecording = false;
+	};
+
+	class GraphicsPSO { 
+	public:
+		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext) const -> void {
+			pDeviceContext->IASetPrimitiveTopology(PrimitiveTopology);
+			pDeviceContext->IASetInputLayout(pInputLayout.Get());
+			pDeviceContext->VSSetShader(pVS.Get(), nullptr, 0);
+			pDeviceContext->PSSetShader(pPS.Get(), nullptr, 0);
+			pDeviceContext->RSSetState(pRasterState.Get());
+			pDeviceContext->OMSetDepthStencilState(pDepthStencilState.Get(), 0);
+			pDeviceContext->OMSetBlendState(pBlendState.Get(), nullptr, BlendMask);		
+		}
+	public:
+		Microsoft::WRL::ComPtr<ID3D11InputLayout>       pInputLayout = nullptr;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader>      pVS = nullptr;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader>       pPS = nullptr;
+		Microsoft::WRL::ComPtr<ID3D11RasterizerState>   pRasterState = nullptr;
+		Microsoft::WRL::ComPtr<ID3D11DepthStencilState> pDepthStencilState = nullptr;
+		Microsoft::WRL::ComPtr<ID3D11BlendState>        pBlendState  = nullptr;
+		uint32_t                                        BlendMask = 0xFFFFFFFF;
+		D3D11_PRIMITIVE_TOPOLOGY                        PrimitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	};
+
+	class ComputePSO {
+	public:
+		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext) const -> void {
+			pDeviceContext->CSSetShader(pCS.Get(), nullptr, 0);
+		}
+	public:
+		Microsoft::WRL::ComPtr<ID3D11ComputeShader> pCS = nullptr;
+	};
+
+}
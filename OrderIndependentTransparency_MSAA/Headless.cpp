@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "OIT/CommandLine.hpp"
+#include "OIT/DepthComplexity.hpp"
+#include "OIT/Engine.hpp"
+#include "OIT/ImageCompare.hpp"
+#include "OIT/ImageFile.hpp"
+#include "OIT/Scenes.hpp"
+
+namespace {
+
+	constexpr char const* USAGE =
+		"Usage: OITHeadless [options]\n"
+		"  --width N, --height N       render target size (1920x1280)\n"
+		"  --msaa N                    samples per pixel (4)\n"
+		"  --fragments N               fragments resolved per pixel (32)\n"
+		"  --layers N                  node pool layers per pixel (8)\n"
+		"  --threads N                 worker threads, 0 for all cores (0)\n"
+		"  --method NAME               linked-list, weighted, mlab, adaptive, moments, depth-peeling, prefix-sum\n"
+		"  --mlab-layers N             k-buffer layers of the mlab method\n"
+		"  --at-nodes N                visibility nodes of the adaptive method\n"
+		"  --isa NAME                  auto, scalar, sse4.2, avx2, avx512\n"
+		"  --resolve NAME              per-sample, single, front-to-back\n"
+		"  --networks 0|1              sort short lists with sorting networks\n"
+		"  --epsilon X                 transmittance threshold of the front-to-back resolve\n"
+		"  --adaptive-pool             size the node pool from the observed node counters\n"
+		"  --pool-max-mb N             upper bound of the adaptive node pool\n"
+		"  --pool-history N            frames of node counters the adaptive pool keeps\n"
+		"  --heads NAME                linear, tiled\n"
+		"  --allocation NAME           thread, tile\n"
+		"  --compact                   compact the lists before the resolve\n"
+		"  --scene NAME                default, uniform, heavy-tail, tiny, glass\n"
+		"  --scene-layers N, --scene-triangles N, --triangle-size X, --alpha X, --seed N\n"
+		"  --frames N                  frames to render (1)\n"
+		"  --output FILE               back buffer image (OrderIndependentTransparency_MSAA.ppm)\n"
+		"  --profile FILE              pass timings as .csv or .json\n"
+		"  --complexity NAME           depth complexity heat map and summary per frame\n"
+		"  --compare                   compare against the depth peeling reference\n"
+		"  --help                      print this text\n";
+
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		OIT::CommandLine const commandLine(argc, argv);
+		if (commandLine.HasFlag("help")) {
+			std::printf("%s", USAGE);
+			return 0;
+		}
+
+		OIT::EngineDesc desc;
+		desc.Width         = commandLine.GetUint("width", 1920);
+		desc.Height        = commandLine.GetUint("height", 1280);
+		desc.MSAASamples   = commandLine.GetUint("msaa", 4);
+		desc.FragmentCount = commandLine.GetUint("fragments", 32);
+		desc.OITLayerCount = commandLine.GetUint("layers", 8);
+		desc.ThreadCount   = commandLine.GetUint("threads", 0);
+		desc.Method        = OIT::ParseTransparencyMethod(commandLine.GetString("method", "linked-list"));
+		desc.MLABLayerCount = commandLine.GetUint("mlab-layers", desc.MLABLayerCount);
+		desc.ATNodeCount   = commandLine.GetUint("at-nodes", desc.ATNodeCount);
+		desc.ResolveInstructionSet = OIT::ParseInstructionSet(commandLine.GetString("isa", "auto"));
+		desc.Resolve       = OIT::ParseResolveMode(commandLine.GetString("resolve", "per-sample"));
+		desc.ResolveSortingNetworks = commandLine.GetUint("networks", 0) != 0;
+		desc.ResolveTransmittanceEpsilon = commandLine.GetFloat("epsilon", desc.ResolveTransmittanceEpsilon);
+		desc.AdaptiveNodePool = commandLine.HasFlag("adaptive-pool");
+		desc.NodePool.MaxBytes = static_cast<uint64_t>(commandLine.GetUint("pool-max-mb", 0)) << 20;
+		desc.NodePool.HistoryLength = commandLine.GetUint("pool-history", desc.NodePool.HistoryLength);
+		desc.HeadPointers  = OIT::ParseHeadLayout(commandLine.GetString("heads", "linear"));
+		desc.Allocation    = OIT::ParseNodeAllocation(commandLine.GetString("allocation", "thread"));
+		desc.CompactNodes  = commandLine.HasFlag("compact");
+
+		OIT::SceneDesc sceneDesc;
+		sceneDesc.Kind          = OIT::ParseSceneKind(commandLine.GetString("scene", "default"));
+		sceneDesc.Layers        = commandLine.GetUint("scene-layers", sceneDesc.Layers);
+		sceneDesc.TriangleCount = commandLine.GetUint("scene-triangles", sceneDesc.TriangleCount);
+		sceneDesc.TriangleSize  = commandLine.GetFloat("triangle-size", sceneDesc.TriangleSize);
+		sceneDesc.Alpha         = commandLine.GetFloat("alpha", sceneDesc.Alpha);
+		sceneDesc.Seed          = commandLine.GetUint("seed", sceneDesc.Seed);
+
+		auto const frameCount = commandLine.GetUint("frames", 1);
+		auto const outputName = commandLine.GetString("output", "OrderIndependentTransparency_MSAA.ppm");
+		auto const profileName = commandLine.GetString("profile", std::string());
+		auto const isCompare   = commandLine.HasFlag("compare");
+		// Base name of the heat map and JSON summary written for every frame.
+		auto const complexityName = commandLine.GetString("complexity", std::string());
+		if (!complexityName.empty() && desc.Method != OIT::TransparencyMethod::LinkedList)
+			throw std::invalid_argument("--complexity needs the linked-list method");
+		desc.ProfileHistory = std::max(1u, frameCount);
+		commandLine.CheckUnused();
+
+		OIT::Engine engine(desc);
+		auto const scene = OIT::CreateScene(sceneDesc);
+
+		for (uint32_t frameIdx = 0; frameIdx < frameCount; frameIdx++) {
+			engine.RenderFrame(scene);
+
+			if (desc.Method != OIT::TransparencyMethod::LinkedList) {
+				std::printf("Frame %u: %.3f ms, %llu fragments, %.1f MB total, %u threads, %s\n", frameIdx,
+					engine.GetPassTimings().Frame, static_cast<unsigned long long>(engine.GetTransparentFragmentCount()), engine.GetMemoryUsage() / (1024.0 * 1024.0),
+					engine.GetThreadCount(), OIT::ToString(desc.Method));
+				continue;
+			}
+
+			std::printf("Frame %u: %.3f ms, %u nodes, %.1f MB pool, %u threads, %s %s resolve%s\n", frameIdx,
+				engine.GetPassTimings().Frame, engine.GetNodeCount(), engine.GetNodeCapacity() * OIT::LIST_NODE_SIZE / (1024.0 * 1024.0),
+				engine.GetThreadCount(), OIT::ToString(engine.GetResolveInstructionSet()), OIT::ToString(desc.Resolve),
+				desc.CompactNodes ? " of compacted nodes" : "");
+
+			if (!complexityName.empty()) {
+				auto const complexity = engine.MeasureDepthComplexity();
+				auto const frameName = complexityName + "_" + std::to_string(frameIdx);
+				OIT::WriteImagePPM(frameName + ".ppm", OIT::CreateHeatMap(complexity));
+				OIT::WriteDepthComplexityJSON(frameName + ".json", complexity, frameIdx);
+				std::printf("Depth complexity: max %u, p50 %u, p90 %u, p99 %u nodes, %llu nodes visited, %llu pixels truncated by %u, wrote %s.ppm and .json\n",
+					complexity.MaxNodes, OIT::GetNodeCountPercentile(complexity, 50.0), OIT::GetNodeCountPercentile(complexity, 90.0), OIT::GetNodeCountPercentile(complexity, 99.0),
+					static_cast<unsigned long long>(complexity.NodesVisited), static_cast<unsigned long long>(complexity.TruncatedPixels), complexity.FragmentCount, frameName.c_str());
+			}
+		}
+
+		auto const& poolStatistics = engine.GetNodePoolStatistics();
+		if (desc.Method == OIT::TransparencyMethod::LinkedList)
+			std::printf("Node pool: capacity %llu, counter %llu, stored %llu, dropped %llu, peak counter %llu, resizes %llu\n",
+				static_cast<unsigned long long>(poolStatistics.Capacity), static_cast<unsigned long long>(poolStatistics.CounterValue),
+				static_cast<unsigned long long>(poolStatistics.StoredFragments), static_cast<unsigned long long>(poolStatistics.DroppedFragments),
+				static_cast<unsigned long long>(poolStatistics.PeakCounterValue), static_cast<unsigned long long>(poolStatistics.ResizeCount));
+
+		if (frameCount > 1) {
+			auto const& profiler = engine.GetProfiler();
+			for (uint32_t passIdx = 0; passIdx < profiler.GetPassCount(); passIdx++) {
+				auto const summary = profiler.GetCPUSummary(passIdx);
+				std::printf("%-12s p50 %8.3f ms, p95 %8.3f ms, p99 %8.3f ms\n", profiler.GetPassName(passIdx).c_str(), summary.P50, summary.P95, summary.P99);
+			}
+		}
+
+		if (!profileName.empty()) {
+			auto const isJSON = profileName.size() >= 5 && profileName.compare(profileName.size() - 5, 5, ".json") == 0;
+			if (isJSON)
+				engine.GetProfiler().WriteJSON(profileName);
+			else
+				engine.GetProfiler().WriteCSV(profileName);
+			std::printf("Wrote %s\n", profileName.c_str());
+		}
+
+		if (isCompare) {
+			auto const reference = OIT::RenderReference(desc, scene);
+			auto const error = OIT::CompareImages(engine.GetBackBuffer(), reference.BackBuffer);
+			std::printf("Error against depth peeling: max %u, mean %.4f, RMSE %.4f, PSNR %.2f dB, %llu pixels differ\n",
+				error.MaxDelta, error.MeanDelta, error.RMSE, error.PSNR, static_cast<unsigned long long>(error.DifferingPixels));
+			std::printf("Depth peeling: %.3f ms in %u passes, time ratio %.3f\n",
+				reference.FrameMs, reference.PeelPassCount, engine.GetPassTimings().Frame / reference.FrameMs);
+		}
+
+		OIT::WriteImagePPM(outputName, engine.GetBackBuffer());
+		std::printf("Wrote %s\n", outputName.c_str());
+	}
+	catch (std::exception const& e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
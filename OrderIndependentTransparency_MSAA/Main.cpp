@@ -1,162 +1,31 @@
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <stdexcept>
 #include <vector>
 #include <cassert>
 #include <cmath>
+#include <cstdio>
+#include <future>
+#include <iterator>
+#include <map>
 #include <utility>
 #include <string>
 
-#include <wrl.h>
-#include <dxgi.h>
-#include <d3d11.h>
-#include <d3dcompiler.h>
+#include "DX.hpp"
+#include "OIT/AdaptiveTransparency.hpp"
+#include "OIT/DepthComplexity.hpp"
+#include "OIT/ImageFile.hpp"
+#include "OIT/NodeEncoding.hpp"
+#include "OIT/PoolSizer.hpp"
+#include "OIT/Profiler.hpp"
+#include "OIT/ShaderPermutations.hpp"
+#include "OIT/ThreadPool.hpp"
+#include "OIT/TransparencyMethod.hpp"
 
 #include <SDL.h>
 #include <SDL_syswm.h>
 
-namespace DX {
-
-	class ComException : public std::exception {
-	public:
-		ComException(HRESULT hr) : m_Result(hr) {}
-
-		const char* what() const override {
-			static char s_str[64] = {};
-			sprintf_s(s_str, "Failure with HRESULT of %08X" ,static_cast<uint32_t>(m_Result));
-			return s_str;
-		}
-	private:
-		HRESULT m_Result;
-	};
-
-	inline auto ThrowIfFailed(HRESULT hr) -> void {
-		if (FAILED(hr))	
-			throw ComException(hr);
-	}
-
-	inline auto CompileShader(std::wstring const& fileName, std::string const& entryPoint, std::string const& target, std::vector<std::pair<std::string, std::string>> const& defines) -> Microsoft::WRL::ComPtr<ID3DBlob> {
-		Microsoft::WRL::ComPtr<ID3DBlob> pCodeBlob;
-		Microsoft::WRL::ComPtr<ID3DBlob> pErrorBlob;
-
-		uint32_t shaderFlags = 0;
-#ifdef _DEBUG
-		shaderFlags |= D3DCOMPILE_DEBUG;
-		shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
-		shaderFlags |= D3DCOMPILE_WARNINGS_ARE_ERRORS;
-#endif
-
-		std::vector<D3D_SHADER_MACRO> d3dDefines;
-		for(auto const& e: defines)
-			d3dDefines.push_back({ e.first.c_str(), e.second.c_str() });
-
-		d3dDefines.push_back({ nullptr, nullptr });
-
-		if (FAILED(D3DCompileFromFile(fileName.c_str(), std::data(d3dDefines), D3D_COMPILE_STANDARD_FILE_INCLUDE, entryPoint.c_str(), target.c_str(), shaderFlags, 0, pCodeBlob.GetAddressOf(), pErrorBlob.GetAddressOf()))) {
-			std::printf(static_cast<const char*>(pErrorBlob->GetBufferPointer()));
-			throw std::runtime_error(static_cast<const char*>(pErrorBlob->GetBufferPointer()));
-		}	
-		return pCodeBlob;
-	}
-
-	template<typename T>
-	auto CreateConstantBuffer(Microsoft::WRL::ComPtr<ID3D11Device> pDevice) -> Microsoft::WRL::ComPtr<ID3D11Buffer> {
-
-		Microsoft::WRL::ComPtr<ID3D11Buffer> pBuffer;
-		D3D11_BUFFER_DESC desc = {};
-		desc.ByteWidth = sizeof(T);
-		desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		desc.Usage = D3D11_USAGE_DYNAMIC;
-		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-		ThrowIfFailed(pDevice->CreateBuffer(&desc, nullptr, pBuffer.GetAddressOf()));
-		return pBuffer;
-	}
-
-	template<typename T>
-	auto CreateStructuredBuffer(Microsoft::WRL::ComPtr<ID3D11Device> pDevice, uint32_t numElements, bool isCPUWritable, bool isGPUWritable, const T* pInitialData = nullptr) -> Microsoft::WRL::ComPtr<ID3D11Buffer> {
-		Microsoft::WRL::ComPtr<ID3D11Buffer> pBuffer;
-
-		D3D11_BUFFER_DESC desc = {};
-		desc.ByteWidth = sizeof(T) * numElements;
-		if ((!isCPUWritable) && (!isGPUWritable)) {
-			desc.CPUAccessFlags = 0;
-			desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-			desc.Usage = D3D11_USAGE_IMMUTABLE;
-		}
-		else if (isCPUWritable && (!isGPUWritable)) {
-			desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-			desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-			desc.Usage = D3D11_USAGE_DYNAMIC;
-		}
-		else if ((!isCPUWritable) && isGPUWritable) {
-
-			desc.CPUAccessFlags = 0;
-			desc.BindFlags = (D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS);
-			desc.Usage = D3D11_USAGE_DEFAULT;
-		}
-		else {
-			assert((!(isCPUWritable && isGPUWritable)));
-		}
-
-		desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-		desc.StructureByteStride = sizeof(T);
-
-		D3D11_SUBRESOURCE_DATA data = {};
-		data.pSysMem = pInitialData;
-		ThrowIfFailed(pDevice->CreateBuffer((&desc), (pInitialData) ? (&data) : nullptr, pBuffer.GetAddressOf()));
-		return pBuffer;
-	}
-
-	class MSAAResolver{
-	public:
-		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pRTVSrc, Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pRTVDsv, DXGI_FORMAT format) const -> void {
-			Microsoft::WRL::ComPtr<ID3D11Resource> pTexture;
-			pRTVDsv->GetResource(pTexture.GetAddressOf());
-
-			Microsoft::WRL::ComPtr<ID3D11Resource> pTexture_MSAA;
-			pRTVSrc->GetResource(pTexture_MSAA.GetAddressOf());
-
-			pDeviceContext->ResolveSubresource(pTexture.Get(), 0, pTexture_MSAA.Get(), 0, format);
-		}
-
-		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext, Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDSVSrc, Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDSVDsv, DXGI_FORMAT format) const-> void {
-			static_assert(true, "No implementation");
-		}
-
-	};
-
-	class GraphicsPSO { 
-	public:
-		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext) const -> void {
-			pDeviceContext->IASetPrimitiveTopology(PrimitiveTopology);
-			pDeviceContext->IASetInputLayout(pInputLayout.Get());
-			pDeviceContext->VSSetShader(pVS.Get(), nullptr, 0);
-			pDeviceContext->PSSetShader(pPS.Get(), nullptr, 0);
-			pDeviceContext->RSSetState(pRasterState.Get());
-			pDeviceContext->OMSetDepthStencilState(pDepthStencilState.Get(), 0);
-			pDeviceContext->OMSetBlendState(pBlendState.Get(), nullptr, BlendMask);		
-		}
-	public:
-		Microsoft::WRL::ComPtr<ID3D11InputLayout>       pInputLayout = nullptr;
-		Microsoft::WRL::ComPtr<ID3D11VertexShader>      pVS = nullptr;
-		Microsoft::WRL::ComPtr<ID3D11PixelShader>       pPS = nullptr;
-		Microsoft::WRL::ComPtr<ID3D11RasterizerState>   pRasterState = nullptr;
-		Microsoft::WRL::ComPtr<ID3D11DepthStencilState> pDepthStencilState = nullptr;
-		Microsoft::WRL::ComPtr<ID3D11BlendState>        pBlendState  = nullptr;
-		uint32_t                                        BlendMask = 0xFFFFFFFF;
-		D3D11_PRIMITIVE_TOPOLOGY                        PrimitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	};
-
-	class ComputePSO {
-	public:
-		auto Apply(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pDeviceContext) const -> void {
-			pDeviceContext->CSSetShader(pCS.Get(), nullptr, 0);
-		}
-	public:
-		Microsoft::WRL::ComPtr<ID3D11ComputeShader> pCS = nullptr;
-	};
-
-}
-
 
 #undef main
 int main(int argc, char* argv)
@@ -168,6 +37,115 @@ int main(int argc, char* argv)
 	auto const MSAA_SAMPLES    = 4;
 	auto const FRAGMENT_COUNT  = 32;
 	auto const OIT_LAYER_COUNT = 8;
+	// Method of the first frame, M cycles through OIT::TRANSPARENCY_METHODS at runtime.
+	auto const OIT_METHOD = OIT::TransparencyMethod::LinkedList;
+	auto const OIT_MLAB_LAYER_COUNT = 4;
+	auto const OIT_AT_NODE_COUNT    = 4;
+	auto const RESOLVE_SINGLE_TRAVERSAL = true;
+	auto const RESOLVE_SORTING_NETWORKS = true;
+	// Front to back compositing that stops below the transmittance epsilon, see OIT::ResolveMode::FrontToBack.
+	auto const RESOLVE_FRONT_TO_BACK         = false;
+	auto const RESOLVE_TRANSMITTANCE_EPSILON = 1.0f / 512.0f;
+	auto const OIT_ADAPTIVE_NODE_POOL   = true;
+	auto const OIT_NODE_POOL_MAX_BYTES  = uint64_t(512) << 20;
+	auto const PROFILE_HISTORY = 1024;
+	auto const PROFILE_OUTPUT  = std::string("OrderIndependentTransparency_MSAA_Profile");
+	auto const SHADER_CACHE_DIRECTORY = "ShaderCache";
+	// Threads compiling shaders and creating PSOs next to the main thread, 0 for all cores, 1 for none.
+	auto const PSO_THREAD_COUNT = 0;
+
+	auto const startupTimeBegin = OIT::ProfilerClock::now();
+	auto pShaderCache = std::make_unique<OIT::ShaderCache>(SHADER_CACHE_DIRECTORY);
+	auto pThreadPool  = std::make_unique<OIT::ThreadPool>(PSO_THREAD_COUNT);
+
+	// Compiling needs no device, so every shader is queued right away and compiles while the window, the
+	// swap chain and the render targets are created.
+	auto const CompileShaderAsync = [&](wchar_t const* fileName, char const* entryPoint, char const* target, std::vector<std::pair<std::string, std::string>> const& defines) -> std::shared_future<Microsoft::WRL::ComPtr<ID3DBlob>> {
+		return pThreadPool->Submit([=, pShaderCache = pShaderCache.get()] { return DX::CompileShader(fileName, entryPoint, target, defines, pShaderCache); }).share();
+	};
+
+	std::vector<std::pair<std::string, std::string>> definesTransparent;
+	definesTransparent.push_back({ "NODE_ENCODING",   std::to_string(OIT::NODE_ENCODING) });
+	definesTransparent.push_back({ "NODE_LAYOUT_SOA", OIT::NODE_LAYOUT_SOA ? "1" : "0" });
+
+	// Nine significant digits round-trip a float, std::to_string would cut 1/512 to 0.001953.
+	char transmittanceEpsilon[32] = {};
+	std::snprintf(transmittanceEpsilon, sizeof(transmittanceEpsilon), "%.9g", RESOLVE_TRANSMITTANCE_EPSILON);
+
+	std::vector<std::pair<std::string, std::string>> definesResolve;
+	definesResolve.push_back({ "RESOLVE_SINGLE_TRAVERSAL", RESOLVE_SINGLE_TRAVERSAL ? "1" : "0" });
+	definesResolve.push_back({ "RESOLVE_SORTING_NETWORKS", RESOLVE_SORTING_NETWORKS ? "1" : "0" });
+	definesResolve.push_back({ "RESOLVE_FRONT_TO_BACK",    RESOLVE_FRONT_TO_BACK ? "1" : "0" });
+	definesResolve.push_back({ "RESOLVE_TRANSMITTANCE_EPSILON", transmittanceEpsilon });
+	definesResolve.push_back({ "NODE_ENCODING",            std::to_string(OIT::NODE_ENCODING) });
+	definesResolve.push_back({ "NODE_LAYOUT_SOA",          OIT::NODE_LAYOUT_SOA ? "1" : "0" });
+
+	auto const futureBlobOpaqueVS      = CompileShaderAsync(L"Shaders/OpaqueGeometry.hlsl", "VSMain", "vs_5_0", {});
+	auto const futureBlobOpaquePS      = CompileShaderAsync(L"Shaders/OpaqueGeometry.hlsl", "PSMain", "ps_5_0", {});
+	auto const futureBlobTransparentVS = CompileShaderAsync(L"Shaders/TransparentGeometry.hlsl", "VSMain", "vs_5_0", definesTransparent);
+	auto const futureBlobTransparentPS = CompileShaderAsync(L"Shaders/TransparentGeometry.hlsl", "PSMain", "ps_5_0", definesTransparent);
+	auto const futureBlobWeightedPS    = CompileShaderAsync(L"Shaders/WeightedBlended.hlsl", "PSAccumulate", "ps_5_0", {});
+	auto const futureBlobWeightedCS    = CompileShaderAsync(L"Shaders/WeightedBlended.hlsl", "CSComposite", "cs_5_0", { { "MSAA_SAMPLE_COUNT", std::to_string(MSAA_SAMPLES) } });
+	auto const futureBlobMomentsPS     = CompileShaderAsync(L"Shaders/MomentBased.hlsl", "PSGenerate", "ps_5_0", {});
+	auto const futureBlobMomentsResolvePS = CompileShaderAsync(L"Shaders/MomentBased.hlsl", "PSResolve", "ps_5_0", {});
+	auto const futureBlobMomentsCS     = CompileShaderAsync(L"Shaders/MomentBased.hlsl", "CSComposite", "cs_5_0", { { "MSAA_SAMPLE_COUNT", std::to_string(MSAA_SAMPLES) } });
+
+	std::vector<std::pair<std::string, std::string>> definesLayers;
+	definesLayers.push_back({ "MSAA_SAMPLE_COUNT", std::to_string(MSAA_SAMPLES) });
+	definesLayers.push_back({ "LAYER_COUNT",       std::to_string(OIT_MLAB_LAYER_COUNT) });
+
+	auto const futureBlobLayersPS      = CompileShaderAsync(L"Shaders/MultiLayerAlphaBlending.hlsl", "PSInsert", "ps_5_0", definesLayers);
+	auto const futureBlobLayersCS      = CompileShaderAsync(L"Shaders/MultiLayerAlphaBlending.hlsl", "CSComposite", "cs_5_0", definesLayers);
+
+	std::vector<std::pair<std::string, std::string>> definesAdaptive;
+	definesAdaptive.push_back({ "MSAA_SAMPLE_COUNT", std::to_string(MSAA_SAMPLES) });
+	definesAdaptive.push_back({ "NODE_COUNT",        std::to_string(OIT_AT_NODE_COUNT) });
+
+	auto const futureBlobAdaptivePS    = CompileShaderAsync(L"Shaders/AdaptiveTransparency.hlsl", "PSInsert", "ps_5_0", definesAdaptive);
+	auto const futureBlobAdaptiveCS    = CompileShaderAsync(L"Shaders/AdaptiveTransparency.hlsl", "CSComposite", "cs_5_0", definesAdaptive);
+
+	// The fragment arrays resolve with the startup fragment cap, [ and ] only switch the variants of the lists.
+	auto definesArrays = definesResolve;
+	definesArrays.push_back({ "FRAGMENT_COUNT",    std::to_string(FRAGMENT_COUNT) });
+	definesArrays.push_back({ "MSAA_SAMPLE_COUNT", std::to_string(MSAA_SAMPLES) });
+
+	auto const futureBlobArraysCountPS           = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "PSCount", "ps_5_0", definesArrays);
+	auto const futureBlobArraysFillPS            = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "PSFill", "ps_5_0", definesArrays);
+	auto const futureBlobArraysScanCS            = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "CSScanGroups", "cs_5_0", definesArrays);
+	auto const futureBlobArraysScanGroupSumsCS   = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "CSScanGroupSums", "cs_5_0", definesArrays);
+	auto const futureBlobArraysAddGroupOffsetsCS = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "CSAddGroupOffsets", "cs_5_0", definesArrays);
+	auto const futureBlobArraysResolveCS         = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "CSResolve", "cs_5_0", definesArrays);
+
+	// The compacted lists number their ranges by tile, C toggles them.
+	auto definesCompaction = definesArrays;
+	definesCompaction.push_back({ "FRAGMENT_SLOTS_TILED", "1" });
+
+	auto const futureBlobCompactionCountCS   = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "CSCountLists", "cs_5_0", definesCompaction);
+	auto const futureBlobCompactionCopyCS    = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "CSCompactLists", "cs_5_0", definesCompaction);
+	auto const futureBlobCompactionResolveCS = CompileShaderAsync(L"Shaders/FragmentArrays.hlsl", "CSResolve", "cs_5_0", definesCompaction);
+
+	// The resolve shader is built per fragment cap and sample count. FRAGMENT_COUNT only picks the variant the frame
+	// loop starts with, [ and ] step through the others at runtime.
+	auto const RESOLVE_PERMUTATION_OPTIONS = OIT::PERMUTATION_FRAGMENT_COUNT | OIT::PERMUTATION_SAMPLE_COUNT;
+	auto pResolveShaders = std::make_unique<OIT::PermutationRegistry<Microsoft::WRL::ComPtr<ID3DBlob>>>(
+		[=, pShaderCache = pShaderCache.get()](OIT::ShaderPermutation const& permutation) -> Microsoft::WRL::ComPtr<ID3DBlob> {
+			auto defines = definesResolve;
+			for (auto const& define : OIT::GetPermutationDefines(permutation, RESOLVE_PERMUTATION_OPTIONS))
+				defines.push_back(define);
+			return DX::CompileShader(L"Shaders/ResolveGeometry.hlsl", "CSMain", "cs_5_0", defines, pShaderCache);
+		}, RESOLVE_PERMUTATION_OPTIONS, *pThreadPool);
+
+	auto resolvePermutation = OIT::ShaderPermutation{ FRAGMENT_COUNT, MSAA_SAMPLES };
+	pResolveShaders->Prefetch(resolvePermutation);
+
+	// The depth complexity pass walks the lists like the resolve variant it reports on. Built on the first capture.
+	auto pComplexityShaders = std::make_unique<OIT::PermutationRegistry<Microsoft::WRL::ComPtr<ID3DBlob>>>(
+		[=, pShaderCache = pShaderCache.get()](OIT::ShaderPermutation const& permutation) -> Microsoft::WRL::ComPtr<ID3DBlob> {
+			auto defines = definesResolve;
+			for (auto const& define : OIT::GetPermutationDefines(permutation, RESOLVE_PERMUTATION_OPTIONS))
+				defines.push_back(define);
+			return DX::CompileShader(L"Shaders/DepthComplexity.hlsl", "CSCount", "cs_5_0", defines, pShaderCache);
+		}, RESOLVE_PERMUTATION_OPTIONS, *pThreadPool);
 
 	SDL_Init(SDL_INIT_EVERYTHING);
 	std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> pWindow(
@@ -183,6 +161,10 @@ int main(int argc, char* argv)
 
 	DXGI_FORMAT colorBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
 	DXGI_FORMAT depthBufferFormat = DXGI_FORMAT_D32_FLOAT;
+	DXGI_FORMAT accumulationBufferFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+	DXGI_FORMAT revealageBufferFormat    = DXGI_FORMAT_R16_FLOAT;
+	DXGI_FORMAT moment0BufferFormat      = DXGI_FORMAT_R32_FLOAT;
+	DXGI_FORMAT momentsBufferFormat      = DXGI_FORMAT_R32G32B32A32_FLOAT;
 
 	{
 		int32_t width  = 0;
@@ -218,6 +200,10 @@ int main(int argc, char* argv)
 		pDevice->GetImmediateContext(pDeviceContext.GetAddressOf());
 	}
 
+	auto const isROVSupported = DX::IsROVSupported(pDevice);
+	if (!isROVSupported)
+		std::printf("Rasterizer ordered views are not supported, %s and %s are disabled\n", OIT::ToString(OIT::TransparencyMethod::MultiLayerAlphaBlending), OIT::ToString(OIT::TransparencyMethod::AdaptiveTransparency));
+
 
 
 	Microsoft::WRL::ComPtr<ID3D11RenderTargetView>    pRTVSwapChain;
@@ -229,6 +215,164 @@ int main(int argc, char* argv)
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVTextureHeadOIT;
 	Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferLinkedListOIT;
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVBufferLinkedListOIT;
+	Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferLinkedListPayloadOIT;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVBufferLinkedListPayloadOIT;
+
+	Microsoft::WRL::ComPtr<ID3D11RenderTargetView>    pRTVAccumulationMSAA;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVAccumulationMSAA;
+	Microsoft::WRL::ComPtr<ID3D11RenderTargetView>    pRTVRevealageMSAA;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVRevealageMSAA;
+	Microsoft::WRL::ComPtr<ID3D11RenderTargetView>    pRTVMoment0MSAA;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVMoment0MSAA;
+	Microsoft::WRL::ComPtr<ID3D11RenderTargetView>    pRTVMomentsMSAA;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVMomentsMSAA;
+
+	// Per-sample layers of multi-layer alpha blending or visibility nodes of adaptive transparency.
+	Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferLayersOIT;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVBufferLayersOIT;
+
+	// Row pitch of the per-sample layers or nodes, PSInsert only sees pixel coordinates.
+	struct LayerConstants {
+		uint32_t Width;
+		uint32_t Padding[3];
+	};
+	auto const pLayerConstantsOIT = DX::CreateConstantBuffer<LayerConstants>(pDevice);
+
+	// Fragment counts per pixel, their exclusive prefix sum, the sums of the scan groups and the fragments themselves
+	// of the prefix sum method. The counts and offsets have one element more than there are pixels, the last offset
+	// is the total fragment count. The compacted lists reuse them with one range per slot of the padded tiles.
+	Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferFragmentCountsOIT;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVBufferFragmentCountsOIT;
+	Microsoft::WRL::ComPtr<ID3D11Buffer>              pBufferFragmentOffsetsOIT;
+	Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferFragmentOffsetsOIT;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVBufferFragmentOffsetsOIT;
+	Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferScanGroupSumsOIT;
+	Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferFragmentsOIT;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>  pSRVBufferFragmentsOIT;
+
+	// Threads of a CSScanGroups group, SCAN_GROUP_SIZE of FragmentArrays.hlsl.
+	auto const FRAGMENT_SCAN_GROUP_SIZE = 1024u;
+	struct FragmentArrayConstants {
+		uint32_t Width;
+		uint32_t ElementCount;
+		uint32_t Height;
+		uint32_t Padding;
+	};
+	auto const pFragmentArrayConstantsOIT = DX::CreateConstantBuffer<FragmentArrayConstants>(pDevice);
+	uint32_t fragmentElementCountOIT = 0;
+	uint32_t fragmentCapacityOIT = 0;
+
+	// Sizes the fragment buffer from the read back totals like the adaptive node pool, so a changing total neither
+	// reallocates every frame nor drops fragments for the frames the readback lags behind.
+	OIT::PoolSizerDesc fragmentSizerDesc;
+	fragmentSizerDesc.MaxBytes = OIT_NODE_POOL_MAX_BYTES;
+	std::unique_ptr<OIT::PoolSizer> pFragmentSizerOIT;
+
+	auto oitMethod = OIT::IsRasterizerOrdered(OIT_METHOD) && !isROVSupported ? OIT::TransparencyMethod::LinkedList : OIT_METHOD;
+	auto isNodeCompactionOIT = false;
+	uint32_t nodeCapacityOIT = 0;
+	uint32_t nodeCounterPeakOIT = 0;
+
+	OIT::PoolSizerDesc poolSizerDesc;
+	poolSizerDesc.MaxBytes = (std::min)(OIT_NODE_POOL_MAX_BYTES, uint64_t(OIT::LIST_NODE_MAX_COUNT) * OIT::LIST_NODE_SIZE);
+	std::unique_ptr<OIT::PoolSizer> pPoolSizerOIT;
+
+	auto const ResizeNodeBuffer = [&](uint32_t nodeCapacity) -> void {
+		// The reported peak covers the frames since the last resize, as NodePoolStatistics does in the CPU engine.
+		nodeCapacityOIT = nodeCapacity;
+		nodeCounterPeakOIT = 0;
+
+		auto const CreateViews = [&](Microsoft::WRL::ComPtr<ID3D11Buffer> pBufferOIT, uint32_t flags, ID3D11UnorderedAccessView** ppUAV, ID3D11ShaderResourceView** ppSRV) -> void {
+			{
+				D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
+				desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+				desc.Buffer.FirstElement = 0;
+				desc.Buffer.Flags = flags;
+				desc.Buffer.NumElements = nodeCapacity;
+				DX::ThrowIfFailed(pDevice->CreateUnorderedAccessView(pBufferOIT.Get(), &desc, ppUAV));
+			}
+
+			{
+				D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+				desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+				desc.Buffer.FirstElement = 0;
+				desc.Buffer.NumElements = nodeCapacity;
+				DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pBufferOIT.Get(), &desc, ppSRV));
+			}
+		};
+
+		// The node counter lives on the buffer the list walk reads, the link buffer in the SoA layout.
+		if (OIT::NODE_LAYOUT_SOA) {
+			CreateViews(DX::CreateStructuredBuffer<OIT::StoredListNodeLink>(pDevice, nodeCapacity, false, true), D3D11_BUFFER_UAV_FLAG_COUNTER,
+				pUAVBufferLinkedListOIT.ReleaseAndGetAddressOf(), pSRVBufferLinkedListOIT.ReleaseAndGetAddressOf());
+			CreateViews(DX::CreateStructuredBuffer<OIT::StoredListNodePayload>(pDevice, nodeCapacity, false, true), 0,
+				pUAVBufferLinkedListPayloadOIT.ReleaseAndGetAddressOf(), pSRVBufferLinkedListPayloadOIT.ReleaseAndGetAddressOf());
+		}
+		else {
+			CreateViews(DX::CreateStructuredBuffer<OIT::StoredListNode>(pDevice, nodeCapacity, false, true), D3D11_BUFFER_UAV_FLAG_COUNTER,
+				pUAVBufferLinkedListOIT.ReleaseAndGetAddressOf(), pSRVBufferLinkedListOIT.ReleaseAndGetAddressOf());
+		}
+	};
+
+	// The fragment buffer follows pFragmentSizerOIT, fragments past its end are dropped until the next resize.
+	auto const ResizeFragmentBuffer = [&](uint32_t fragmentCapacity) -> void {
+		fragmentCapacityOIT = fragmentCapacity;
+
+		auto const pBufferFragments = DX::CreateStructuredBuffer<OIT::ListSubNodeMS>(pDevice, (std::max)(fragmentCapacity, 1u), false, true);
+		{
+			D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
+			desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+			desc.Buffer.FirstElement = 0;
+			desc.Buffer.NumElements = (std::max)(fragmentCapacity, 1u);
+			DX::ThrowIfFailed(pDevice->CreateUnorderedAccessView(pBufferFragments.Get(), &desc, pUAVBufferFragmentsOIT.ReleaseAndGetAddressOf()));
+		}
+
+		{
+			D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+			desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+			desc.Buffer.FirstElement = 0;
+			desc.Buffer.NumElements = (std::max)(fragmentCapacity, 1u);
+			DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pBufferFragments.Get(), &desc, pSRVBufferFragmentsOIT.ReleaseAndGetAddressOf()));
+		}
+	};
+
+	// Counts, offsets and scan group sums for rangeCount ranges, and an empty fragment buffer.
+	auto const CreateFragmentArrays = [&](uint32_t width, uint32_t height, uint32_t rangeCount) -> void {
+		auto const CreateViews = [&](Microsoft::WRL::ComPtr<ID3D11Buffer> pBuffer, uint32_t elementCount, ID3D11UnorderedAccessView** ppUAV, ID3D11ShaderResourceView** ppSRV) -> void {
+			{
+				D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
+				desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+				desc.Buffer.FirstElement = 0;
+				desc.Buffer.NumElements = elementCount;
+				DX::ThrowIfFailed(pDevice->CreateUnorderedAccessView(pBuffer.Get(), &desc, ppUAV));
+			}
+
+			if (ppSRV) {
+				D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+				desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+				desc.Buffer.FirstElement = 0;
+				desc.Buffer.NumElements = elementCount;
+				DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pBuffer.Get(), &desc, ppSRV));
+			}
+		};
+
+		fragmentElementCountOIT = rangeCount + 1;
+		auto const scanGroupCount = (fragmentElementCountOIT + FRAGMENT_SCAN_GROUP_SIZE - 1) / FRAGMENT_SCAN_GROUP_SIZE;
+		pBufferFragmentOffsetsOIT = DX::CreateStructuredBuffer<uint32_t>(pDevice, fragmentElementCountOIT, false, true);
+		CreateViews(DX::CreateStructuredBuffer<uint32_t>(pDevice, fragmentElementCountOIT, false, true), fragmentElementCountOIT,
+			pUAVBufferFragmentCountsOIT.ReleaseAndGetAddressOf(), pSRVBufferFragmentCountsOIT.ReleaseAndGetAddressOf());
+		CreateViews(pBufferFragmentOffsetsOIT, fragmentElementCountOIT, pUAVBufferFragmentOffsetsOIT.ReleaseAndGetAddressOf(), pSRVBufferFragmentOffsetsOIT.ReleaseAndGetAddressOf());
+		CreateViews(DX::CreateStructuredBuffer<uint32_t>(pDevice, scanGroupCount, false, true), scanGroupCount, pUAVBufferScanGroupSumsOIT.ReleaseAndGetAddressOf(), nullptr);
+		pFragmentSizerOIT = std::make_unique<OIT::PoolSizer>(fragmentSizerDesc, sizeof(OIT::ListSubNodeMS), 0);
+		ResizeFragmentBuffer(static_cast<uint32_t>(pFragmentSizerOIT->GetCapacity()));
+
+		D3D11_MAPPED_SUBRESOURCE mapped = {};
+		DX::ThrowIfFailed(pDeviceContext->Map(pFragmentArrayConstantsOIT.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+		static_cast<FragmentArrayConstants*>(mapped.pData)->Width = width;
+		static_cast<FragmentArrayConstants*>(mapped.pData)->ElementCount = fragmentElementCountOIT;
+		static_cast<FragmentArrayConstants*>(mapped.pData)->Height = height;
+		pDeviceContext->Unmap(pFragmentArrayConstantsOIT.Get(), 0);
+	};
 
 	auto const ResizeRenderTargets = [&](uint32_t width, uint32_t height)-> void {
 
@@ -275,7 +419,103 @@ int main(int argc, char* argv)
 			DX::ThrowIfFailed(pDevice->CreateTexture2D(&desc, nullptr, pDepthBufferMSAA.GetAddressOf()));
 			DX::ThrowIfFailed(pDevice->CreateDepthStencilView(pDepthBufferMSAA.Get(), nullptr, pDSV_MSAA.ReleaseAndGetAddressOf()));
 		}
-		
+
+		// Only the resources of the active method are kept, so the memory of the methods can be compared.
+		pUAVTextureHeadOIT.Reset();
+		pSRVTextureHeadOIT.Reset();
+		pUAVBufferLinkedListOIT.Reset();
+		pSRVBufferLinkedListOIT.Reset();
+		pUAVBufferLinkedListPayloadOIT.Reset();
+		pSRVBufferLinkedListPayloadOIT.Reset();
+		pPoolSizerOIT.reset();
+		nodeCapacityOIT = 0;
+		pRTVAccumulationMSAA.Reset();
+		pSRVAccumulationMSAA.Reset();
+		pRTVRevealageMSAA.Reset();
+		pSRVRevealageMSAA.Reset();
+		pRTVMoment0MSAA.Reset();
+		pSRVMoment0MSAA.Reset();
+		pRTVMomentsMSAA.Reset();
+		pSRVMomentsMSAA.Reset();
+		pUAVBufferLayersOIT.Reset();
+		pSRVBufferLayersOIT.Reset();
+		pUAVBufferFragmentCountsOIT.Reset();
+		pSRVBufferFragmentCountsOIT.Reset();
+		pBufferFragmentOffsetsOIT.Reset();
+		pUAVBufferFragmentOffsetsOIT.Reset();
+		pSRVBufferFragmentOffsetsOIT.Reset();
+		pUAVBufferScanGroupSumsOIT.Reset();
+		pUAVBufferFragmentsOIT.Reset();
+		pSRVBufferFragmentsOIT.Reset();
+		pFragmentSizerOIT.reset();
+		fragmentElementCountOIT = 0;
+		fragmentCapacityOIT = 0;
+
+		// Both methods accumulate premultiplied colors, weighted blending with a revealage target and moment-based
+		// OIT with its two moment targets next to it.
+		if (oitMethod == OIT::TransparencyMethod::WeightedBlended || oitMethod == OIT::TransparencyMethod::MomentBased) {
+			auto const CreateTarget = [&](DXGI_FORMAT format, ID3D11RenderTargetView** ppRTV, ID3D11ShaderResourceView** ppSRV) -> void {
+				D3D11_TEXTURE2D_DESC desc = {};
+				desc.ArraySize = 1;
+				desc.MipLevels = 1;
+				desc.Width = width;
+				desc.Height = height;
+				desc.Format = format;
+				desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+				desc.SampleDesc.Count = MSAA_SAMPLES;
+				desc.SampleDesc.Quality = DXGI_STANDARD_MULTISAMPLE_QUALITY_PATTERN;
+				desc.Usage = D3D11_USAGE_DEFAULT;
+
+				Microsoft::WRL::ComPtr<ID3D11Texture2D> pTexture;
+				DX::ThrowIfFailed(pDevice->CreateTexture2D(&desc, nullptr, pTexture.GetAddressOf()));
+				DX::ThrowIfFailed(pDevice->CreateRenderTargetView(pTexture.Get(), nullptr, ppRTV));
+				DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pTexture.Get(), nullptr, ppSRV));
+			};
+			CreateTarget(accumulationBufferFormat, pRTVAccumulationMSAA.ReleaseAndGetAddressOf(), pSRVAccumulationMSAA.ReleaseAndGetAddressOf());
+			if (oitMethod == OIT::TransparencyMethod::WeightedBlended) {
+				CreateTarget(revealageBufferFormat, pRTVRevealageMSAA.ReleaseAndGetAddressOf(), pSRVRevealageMSAA.ReleaseAndGetAddressOf());
+			}
+			else {
+				CreateTarget(moment0BufferFormat, pRTVMoment0MSAA.ReleaseAndGetAddressOf(), pSRVMoment0MSAA.ReleaseAndGetAddressOf());
+				CreateTarget(momentsBufferFormat, pRTVMomentsMSAA.ReleaseAndGetAddressOf(), pSRVMomentsMSAA.ReleaseAndGetAddressOf());
+			}
+			return;
+		}
+
+		if (OIT::IsRasterizerOrdered(oitMethod)) {
+			auto const isMultiLayer = oitMethod == OIT::TransparencyMethod::MultiLayerAlphaBlending;
+			auto const layerCount = width * height * MSAA_SAMPLES * (isMultiLayer ? OIT_MLAB_LAYER_COUNT : OIT_AT_NODE_COUNT);
+			auto const pBufferLayers = isMultiLayer
+				? DX::CreateStructuredBuffer<OIT::ListSubNode>(pDevice, layerCount, false, true)
+				: DX::CreateStructuredBuffer<OIT::AdaptiveNode>(pDevice, layerCount, false, true);
+			{
+				D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
+				desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+				desc.Buffer.FirstElement = 0;
+				desc.Buffer.NumElements = layerCount;
+				DX::ThrowIfFailed(pDevice->CreateUnorderedAccessView(pBufferLayers.Get(), &desc, pUAVBufferLayersOIT.ReleaseAndGetAddressOf()));
+			}
+
+			{
+				D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+				desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+				desc.Buffer.FirstElement = 0;
+				desc.Buffer.NumElements = layerCount;
+				DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pBufferLayers.Get(), &desc, pSRVBufferLayersOIT.ReleaseAndGetAddressOf()));
+			}
+
+			D3D11_MAPPED_SUBRESOURCE mapped = {};
+			DX::ThrowIfFailed(pDeviceContext->Map(pLayerConstantsOIT.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+			static_cast<LayerConstants*>(mapped.pData)->Width = width;
+			pDeviceContext->Unmap(pLayerConstantsOIT.Get(), 0);
+			return;
+		}
+
+		if (oitMethod == OIT::TransparencyMethod::PrefixSum) {
+			CreateFragmentArrays(width, height, width * height);
+			return;
+		}
+
 		Microsoft::WRL::ComPtr<ID3D11Texture2D> pTextureOIT;
 		{
 			D3D11_TEXTURE2D_DESC desc = {};
@@ -293,41 +533,42 @@ int main(int argc, char* argv)
 			DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pTextureOIT.Get(), nullptr, pSRVTextureHeadOIT.ReleaseAndGetAddressOf()));
 		}
 
-		struct ListNode {
-			uint32_t  Next;
-			uint32_t  Color;
-			uint32_t  Depth;
-			uint32_t  Coverage;
-		};
-
-		Microsoft::WRL::ComPtr<ID3D11Buffer> pBufferOIT = DX::CreateStructuredBuffer<ListNode>(pDevice, width * height * OIT_LAYER_COUNT, false, true);;
-		{
-			D3D11_UNORDERED_ACCESS_VIEW_DESC desc = {};
-			desc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
-			desc.Buffer.FirstElement = 0;
-			desc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_COUNTER;
-			desc.Buffer.NumElements = width * height * OIT_LAYER_COUNT;
-			DX::ThrowIfFailed(pDevice->CreateUnorderedAccessView(pBufferOIT.Get(), &desc, pUAVBufferLinkedListOIT.ReleaseAndGetAddressOf()));
+		auto const nodeCapacity = (std::min<uint64_t>)(uint64_t(width) * height * OIT_LAYER_COUNT, OIT::LIST_NODE_MAX_COUNT);
+		if (OIT_ADAPTIVE_NODE_POOL) {
+			pPoolSizerOIT = std::make_unique<OIT::PoolSizer>(poolSizerDesc, OIT::LIST_NODE_SIZE, nodeCapacity);
+			ResizeNodeBuffer(static_cast<uint32_t>(pPoolSizerOIT->GetCapacity()));
+		}
+		else {
+			ResizeNodeBuffer(static_cast<uint32_t>(nodeCapacity));
 		}
 
-		{
-			D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
-			desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-			desc.Buffer.FirstElement = 0;
-			desc.Buffer.NumElements = width * height * OIT_LAYER_COUNT;
-			DX::ThrowIfFailed(pDevice->CreateShaderResourceView(pBufferOIT.Get(), &desc, pSRVBufferLinkedListOIT.ReleaseAndGetAddressOf()));
+		if (isNodeCompactionOIT) {
+			auto const tileCount = ((width + 7) / 8) * ((height + 7) / 8);
+			CreateFragmentArrays(width, height, tileCount * 64);
 		}
 	};
 	ResizeRenderTargets(WINDOW_WIDTH, WINDOW_HEIGHT);
 
 	auto pMSAAResolver           = std::make_unique<DX::MSAAResolver>();
-	auto pPSOGeometryOpaque      = std::make_unique<DX::GraphicsPSO>();
-	auto pPSOGeometryTransparent = std::make_unique<DX::GraphicsPSO>();
-	auto pPSOGeometryResolve     = std::make_unique<DX::ComputePSO>();
+	auto pCounterReadbackOIT     = std::make_unique<DX::StructureCountReadback>();
+	auto pFragmentTotalReadbackOIT = std::make_unique<DX::StructureCountReadback>();
+
+	pCounterReadbackOIT->Initialize(pDevice);
+	pFragmentTotalReadbackOIT->Initialize(pDevice);
 
+	// Same pass names as OIT::EnginePass, so captures of both implementations line up.
+	enum ProfilePass : uint32_t { PROFILE_PASS_CLEAR, PROFILE_PASS_OPAQUE, PROFILE_PASS_TRANSPARENT, PROFILE_PASS_RESOLVE_MSAA, PROFILE_PASS_RESOLVE_OIT, PROFILE_PASS_FRAME };
+	auto pProfiler   = std::make_unique<OIT::PassProfiler>(std::vector<std::string>{ "Clear", "Opaque", "Transparent", "ResolveMSAA", "ResolveOIT", "Frame" }, PROFILE_HISTORY);
+	auto pTimestamps = std::make_unique<DX::TimestampQueries>();
+	pTimestamps->Initialize(pDevice, PROFILE_PASS_FRAME + 1);
+	std::vector<double> gpuPassDurations;
 
+	// PSO creation only depends on the device and the shader jobs queued ahead of it, which keeps the workers
+	// from ever waiting on a job that has not been picked up yet.
 	//Create PSO opaque
-	{	
+	auto futurePSOGeometryOpaque = pThreadPool->Submit([=]() -> std::unique_ptr<DX::GraphicsPSO> {
+		auto pPSO = std::make_unique<DX::GraphicsPSO>();
+
 		Microsoft::WRL::ComPtr<ID3D11VertexShader> pVS;
 		Microsoft::WRL::ComPtr<ID3D11PixelShader>  pPS;
 		Microsoft::WRL::ComPtr<ID3D11RasterizerState> pRasterState;
@@ -335,8 +576,8 @@ int main(int argc, char* argv)
 		Microsoft::WRL::ComPtr<ID3D11BlendState> pBlendState;
 
 
-		auto const pBlobVS = DX::CompileShader(L"Shaders/OpaqueGeometry.hlsl", "VSMain", "vs_5_0", {});
-		auto const pBlobPS = DX::CompileShader(L"Shaders/OpaqueGeometry.hlsl", "PSMain", "ps_5_0", {});
+		auto const pBlobVS = futureBlobOpaqueVS.get();
+		auto const pBlobPS = futureBlobOpaquePS.get();
 
 		DX::ThrowIfFailed(pDevice->CreateVertexShader(pBlobVS->GetBufferPointer(), pBlobVS->GetBufferSize(), nullptr, pVS.ReleaseAndGetAddressOf()));
 		DX::ThrowIfFailed(pDevice->CreatePixelShader(pBlobPS->GetBufferPointer(), pBlobPS->GetBufferSize(), nullptr, pPS.ReleaseAndGetAddressOf()));
@@ -368,25 +609,28 @@ int main(int argc, char* argv)
 			DX::ThrowIfFailed(pDevice->CreateBlendState(&desc, pBlendState.GetAddressOf()));
 		}
 
-		pPSOGeometryOpaque->pInputLayout = nullptr;
-		pPSOGeometryOpaque->pVS = pVS;
-		pPSOGeometryOpaque->pPS = pPS;
-		pPSOGeometryOpaque->pRasterState = pRasterState;
-		pPSOGeometryOpaque->pDepthStencilState = pDepthStencilState;
-		pPSOGeometryOpaque->pBlendState = pBlendState;
-	}
+		pPSO->pInputLayout = nullptr;
+		pPSO->pVS = pVS;
+		pPSO->pPS = pPS;
+		pPSO->pRasterState = pRasterState;
+		pPSO->pDepthStencilState = pDepthStencilState;
+		pPSO->pBlendState = pBlendState;
+		return pPSO;
+	});
+
+	//Create PSO transparent. Every transparent geometry pass shades per sample against the opaque depth without writing
+	//it, the passes only differ in their pixel shader and in what they blend into.
+	auto const CreateTransparentGeometryPSO = [=](std::shared_future<Microsoft::WRL::ComPtr<ID3DBlob>> futureBlobPS, D3D11_BLEND_DESC const& blendDesc) -> std::unique_ptr<DX::GraphicsPSO> {
+		auto pPSO = std::make_unique<DX::GraphicsPSO>();
 
-	//Create PSO transparent 
-	{
-		
 		Microsoft::WRL::ComPtr<ID3D11VertexShader> pVS;
 		Microsoft::WRL::ComPtr<ID3D11PixelShader>  pPS;
 		Microsoft::WRL::ComPtr<ID3D11RasterizerState> pRasterState;
 		Microsoft::WRL::ComPtr<ID3D11DepthStencilState> pDepthStencilState;
 		Microsoft::WRL::ComPtr<ID3D11BlendState> pBlendState;
 
-		auto const pBlobVS = DX::CompileShader(L"Shaders/TransparentGeometry.hlsl", "VSMain", "vs_5_0", {});
-		auto const pBlobPS = DX::CompileShader(L"Shaders/TransparentGeometry.hlsl", "PSMain", "ps_5_0", {});
+		auto const pBlobVS = futureBlobTransparentVS.get();
+		auto const pBlobPS = futureBlobPS.get();
 
 		DX::ThrowIfFailed(pDevice->CreateVertexShader(pBlobVS->GetBufferPointer(), pBlobVS->GetBufferSize(), nullptr, pVS.ReleaseAndGetAddressOf()));
 		DX::ThrowIfFailed(pDevice->CreatePixelShader(pBlobPS->GetBufferPointer(), pBlobPS->GetBufferSize(), nullptr, pPS.ReleaseAndGetAddressOf()));
@@ -410,36 +654,234 @@ int main(int argc, char* argv)
 			DX::ThrowIfFailed(pDevice->CreateDepthStencilState(&desc, pDepthStencilState.GetAddressOf()));
 		}
 
-		{
-			D3D11_BLEND_DESC desc = {};
-			desc.AlphaToCoverageEnable = false;
-			desc.IndependentBlendEnable = false;
-			desc.RenderTarget[0].BlendEnable = false;
-			desc.RenderTarget[0].RenderTargetWriteMask = 0;
-			DX::ThrowIfFailed(pDevice->CreateBlendState(&desc, pBlendState.GetAddressOf()));
-		}
+		DX::ThrowIfFailed(pDevice->CreateBlendState(&blendDesc, pBlendState.GetAddressOf()));
 
-		pPSOGeometryTransparent->pInputLayout = nullptr;
-		pPSOGeometryTransparent->pVS = pVS;
-		pPSOGeometryTransparent->pPS = pPS;
-		pPSOGeometryTransparent->pRasterState = pRasterState;
-		pPSOGeometryTransparent->pDepthStencilState = pDepthStencilState;
-		pPSOGeometryTransparent->pBlendState = pBlendState;
-	}
+		pPSO->pInputLayout = nullptr;
+		pPSO->pVS = pVS;
+		pPSO->pPS = pPS;
+		pPSO->pRasterState = pRasterState;
+		pPSO->pDepthStencilState = pDepthStencilState;
+		pPSO->pBlendState = pBlendState;
+		return pPSO;
+	};
+
+	// The linked list, the rasterizer ordered methods and the fragment arrays only write UAVs.
+	D3D11_BLEND_DESC blendDescUAVOnly = {};
+	blendDescUAVOnly.AlphaToCoverageEnable = false;
+	blendDescUAVOnly.IndependentBlendEnable = false;
+	blendDescUAVOnly.RenderTarget[0].BlendEnable = false;
+	blendDescUAVOnly.RenderTarget[0].RenderTargetWriteMask = 0;
+
+	auto futurePSOGeometryTransparent = pThreadPool->Submit([=] { return CreateTransparentGeometryPSO(futureBlobTransparentPS, blendDescUAVOnly); });
+
+	//Create PSO weighted blended transparent. Accumulation: sum of the weighted premultiplied colors. Revealage: product of 1 - alpha.
+	D3D11_BLEND_DESC blendDescWeighted = {};
+	blendDescWeighted.AlphaToCoverageEnable = false;
+	blendDescWeighted.IndependentBlendEnable = true;
+	blendDescWeighted.RenderTarget[0].BlendEnable = true;
+	blendDescWeighted.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+	blendDescWeighted.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
+	blendDescWeighted.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	blendDescWeighted.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+	blendDescWeighted.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ONE;
+	blendDescWeighted.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	blendDescWeighted.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+	blendDescWeighted.RenderTarget[1].BlendEnable = true;
+	blendDescWeighted.RenderTarget[1].SrcBlend = D3D11_BLEND_ZERO;
+	blendDescWeighted.RenderTarget[1].DestBlend = D3D11_BLEND_INV_SRC_COLOR;
+	blendDescWeighted.RenderTarget[1].BlendOp = D3D11_BLEND_OP_ADD;
+	blendDescWeighted.RenderTarget[1].SrcBlendAlpha = D3D11_BLEND_ZERO;
+	blendDescWeighted.RenderTarget[1].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+	blendDescWeighted.RenderTarget[1].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	blendDescWeighted.RenderTarget[1].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_RED;
+	auto futurePSOGeometryWeighted = pThreadPool->Submit([=] { return CreateTransparentGeometryPSO(futureBlobWeightedPS, blendDescWeighted); });
+
+	//Create PSO moment-based transparent. Both passes shade per sample and add up every render target.
+	D3D11_BLEND_DESC blendDescMoments = {};
+	blendDescMoments.AlphaToCoverageEnable = false;
+	blendDescMoments.IndependentBlendEnable = false;
+	blendDescMoments.RenderTarget[0].BlendEnable = true;
+	blendDescMoments.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+	blendDescMoments.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
+	blendDescMoments.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	blendDescMoments.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+	blendDescMoments.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ONE;
+	blendDescMoments.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	blendDescMoments.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+	auto futurePSOGeometryMoments        = pThreadPool->Submit([=] { return CreateTransparentGeometryPSO(futureBlobMomentsPS, blendDescMoments); });
+	auto futurePSOGeometryMomentsResolve = pThreadPool->Submit([=] { return CreateTransparentGeometryPSO(futureBlobMomentsResolvePS, blendDescMoments); });
+
+	//Create PSO multi-layer alpha blending and adaptive transparent. Creating a shader that uses ROVs fails without driver support.
+	auto const CreateOrderedGeometryPSO = [=](std::shared_future<Microsoft::WRL::ComPtr<ID3DBlob>> futureBlobPS) -> std::unique_ptr<DX::GraphicsPSO> {
+		if (!isROVSupported)
+			return nullptr;
+		return CreateTransparentGeometryPSO(futureBlobPS, blendDescUAVOnly);
+	};
+	auto futurePSOGeometryLayers   = pThreadPool->Submit([=] { return CreateOrderedGeometryPSO(futureBlobLayersPS); });
+	auto futurePSOGeometryAdaptive = pThreadPool->Submit([=] { return CreateOrderedGeometryPSO(futureBlobAdaptivePS); });
+
+	//Create PSO fragment array count and fill. UAV writes only, like the linked list.
+	auto futurePSOGeometryArraysCount = pThreadPool->Submit([=] { return CreateTransparentGeometryPSO(futureBlobArraysCountPS, blendDescUAVOnly); });
+	auto futurePSOGeometryArraysFill  = pThreadPool->Submit([=] { return CreateTransparentGeometryPSO(futureBlobArraysFillPS, blendDescUAVOnly); });
 
 	//Create PSO resolve transparent and opaque
-	{
-		std::vector<std::pair<std::string, std::string>> defines;
-		defines.push_back({ "FRAGMENT_COUNT",     std::to_string(FRAGMENT_COUNT) });
-		defines.push_back({ "MSAA_SAMPLE_COUNT",  std::to_string(MSAA_SAMPLES)   });
+	auto const CreateResolvePSO = [pDevice](Microsoft::WRL::ComPtr<ID3DBlob> pBlobCS) -> std::unique_ptr<DX::ComputePSO> {
+		auto pPSO = std::make_unique<DX::ComputePSO>();
 
 		Microsoft::WRL::ComPtr<ID3D11ComputeShader> pCS;
-		auto const pBlobCS = DX::CompileShader(L"Shaders/ResolveGeometry.hlsl", "CSMain", "cs_5_0", defines);
 		DX::ThrowIfFailed(pDevice->CreateComputeShader(pBlobCS->GetBufferPointer(), pBlobCS->GetBufferSize(), nullptr, pCS.ReleaseAndGetAddressOf()));
-		pPSOGeometryResolve->pCS = pCS;
+		pPSO->pCS = pCS;
+		return pPSO;
+	};
+	auto futurePSOGeometryResolve = pThreadPool->Submit([=, pResolveShaders = pResolveShaders.get()] { return CreateResolvePSO(pResolveShaders->Get(resolvePermutation)); });
+	auto futurePSOCompositeWeighted = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobWeightedCS.get()); });
+	auto futurePSOCompositeLayers   = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobLayersCS.get()); });
+	auto futurePSOCompositeAdaptive = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobAdaptiveCS.get()); });
+	auto futurePSOCompositeMoments  = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobMomentsCS.get()); });
+	auto futurePSOArraysScan            = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobArraysScanCS.get()); });
+	auto futurePSOArraysScanGroupSums   = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobArraysScanGroupSumsCS.get()); });
+	auto futurePSOArraysAddGroupOffsets = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobArraysAddGroupOffsetsCS.get()); });
+	auto futurePSOArraysResolve         = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobArraysResolveCS.get()); });
+	auto futurePSOCompactionCount       = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobCompactionCountCS.get()); });
+	auto futurePSOCompactionCopy        = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobCompactionCopyCS.get()); });
+	auto futurePSOCompactionResolve     = pThreadPool->Submit([=] { return CreateResolvePSO(futureBlobCompactionResolveCS.get()); });
+
+	// The frame loop records nothing before every PSO exists. Exceptions of the jobs surface here. Resolve PSOs of
+	// the variants selected later are created on first use.
+	auto const pPSOGeometryOpaque      = futurePSOGeometryOpaque.get();
+	auto const pPSOGeometryTransparent = futurePSOGeometryTransparent.get();
+	auto const pPSOGeometryWeighted    = futurePSOGeometryWeighted.get();
+	auto const pPSOCompositeWeighted   = futurePSOCompositeWeighted.get();
+	auto const pPSOGeometryLayers      = futurePSOGeometryLayers.get();
+	auto const pPSOCompositeLayers     = futurePSOCompositeLayers.get();
+	auto const pPSOGeometryAdaptive    = futurePSOGeometryAdaptive.get();
+	auto const pPSOCompositeAdaptive   = futurePSOCompositeAdaptive.get();
+	auto const pPSOGeometryMoments        = futurePSOGeometryMoments.get();
+	auto const pPSOGeometryMomentsResolve = futurePSOGeometryMomentsResolve.get();
+	auto const pPSOCompositeMoments       = futurePSOCompositeMoments.get();
+	auto const pPSOGeometryArraysCount    = futurePSOGeometryArraysCount.get();
+	auto const pPSOGeometryArraysFill     = futurePSOGeometryArraysFill.get();
+	auto const pPSOArraysScan             = futurePSOArraysScan.get();
+	auto const pPSOArraysScanGroupSums    = futurePSOArraysScanGroupSums.get();
+	auto const pPSOArraysAddGroupOffsets  = futurePSOArraysAddGroupOffsets.get();
+	auto const pPSOArraysResolve          = futurePSOArraysResolve.get();
+	auto const pPSOCompactionCount        = futurePSOCompactionCount.get();
+	auto const pPSOCompactionCopy         = futurePSOCompactionCopy.get();
+	auto const pPSOCompactionResolve      = futurePSOCompactionResolve.get();
+	std::map<OIT::ShaderPermutation, std::unique_ptr<DX::ComputePSO>> resolvePSOs;
+	resolvePSOs[resolvePermutation] = futurePSOGeometryResolve.get();
+	{
+		auto const statistics = pShaderCache->GetStatistics();
+		std::printf("PSOs ready after %.1f ms: %u shaders cached, %u compiled on %u threads\n",
+			std::chrono::duration<double, std::milli>(OIT::ProfilerClock::now() - startupTimeBegin).count(), statistics.Hits, statistics.Misses, pThreadPool->GetThreadCount());
 	}
 
+	// H captures the lists of the next linked-list frame: CSCount of DepthComplexity.hlsl counts the nodes of every
+	// pixel, which are read back, stalling the pipeline once, into a heat map and a JSON summary.
+	auto isComplexityCaptureRequested = false;
+	uint32_t complexityCaptureIdx = 0;
+	auto const CaptureDepthComplexity = [&](uint32_t width, uint32_t height) -> void {
+		auto const STATISTICS_COUNT = OIT::DEPTH_COMPLEXITY_BIN_COUNT + 4;
+
+		Microsoft::WRL::ComPtr<ID3D11ComputeShader> pCS;
+		auto const pBlobCS = pComplexityShaders->Get(resolvePermutation);
+		DX::ThrowIfFailed(pDevice->CreateComputeShader(pBlobCS->GetBufferPointer(), pBlobCS->GetBufferSize(), nullptr, pCS.GetAddressOf()));
 
+		Microsoft::WRL::ComPtr<ID3D11Texture2D>           pTextureNodeCounts;
+		Microsoft::WRL::ComPtr<ID3D11Texture2D>           pTextureNodeCountsStaging;
+		Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVTextureNodeCounts;
+		{
+			D3D11_TEXTURE2D_DESC desc = {};
+			desc.Width = width;
+			desc.Height = height;
+			desc.MipLevels = 1;
+			desc.ArraySize = 1;
+			desc.Format = DXGI_FORMAT_R32_UINT;
+			desc.SampleDesc.Count = 1;
+			desc.Usage = D3D11_USAGE_DEFAULT;
+			desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+			DX::ThrowIfFailed(pDevice->CreateTexture2D(&desc, nullptr, pTextureNodeCounts.GetAddressOf()));
+			DX::ThrowIfFailed(pDevice->CreateUnorderedAccessView(pTextureNodeCounts.Get(), nullptr, pUAVTextureNodeCounts.GetAddressOf()));
+
+			desc.Usage = D3D11_USAGE_STAGING;
+			desc.BindFlags = 0;
+			desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+			DX::ThrowIfFailed(pDevice->CreateTexture2D(&desc, nullptr, pTextureNodeCountsStaging.GetAddressOf()));
+		}
+
+		Microsoft::WRL::ComPtr<ID3D11Buffer>              pBufferStatistics;
+		Microsoft::WRL::ComPtr<ID3D11Buffer>              pBufferStatisticsStaging;
+		Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> pUAVBufferStatistics;
+		{
+			D3D11_BUFFER_DESC desc = {};
+			desc.ByteWidth = sizeof(uint32_t) * STATISTICS_COUNT;
+			desc.Usage = D3D11_USAGE_DEFAULT;
+			desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+			desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+			DX::ThrowIfFailed(pDevice->CreateBuffer(&desc, nullptr, pBufferStatistics.GetAddressOf()));
+
+			D3D11_UNORDERED_ACCESS_VIEW_DESC descUAV = {};
+			descUAV.Format = DXGI_FORMAT_R32_TYPELESS;
+			descUAV.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+			descUAV.Buffer.NumElements = STATISTICS_COUNT;
+			descUAV.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
+			DX::ThrowIfFailed(pDevice->CreateUnorderedAccessView(pBufferStatistics.Get(), &descUAV, pUAVBufferStatistics.GetAddressOf()));
+
+			desc.Usage = D3D11_USAGE_STAGING;
+			desc.BindFlags = 0;
+			desc.MiscFlags = 0;
+			desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+			DX::ThrowIfFailed(pDevice->CreateBuffer(&desc, nullptr, pBufferStatisticsStaging.GetAddressOf()));
+		}
+
+		{
+			ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr, nullptr };
+			ID3D11ShaderResourceView*  ppSRVClear[] = { nullptr, nullptr };
+
+			pDeviceContext->ClearUnorderedAccessViewUint(pUAVBufferStatistics.Get(), std::data({ 0u, 0u, 0u, 0u }));
+			pDeviceContext->CSSetShader(pCS.Get(), nullptr, 0);
+			pDeviceContext->CSSetShaderResources(0, 2, std::data({ pSRVTextureHeadOIT.Get(), pSRVBufferLinkedListOIT.Get() }));
+			pDeviceContext->CSSetUnorderedAccessViews(0, 2, std::data({ pUAVTextureNodeCounts.Get(), pUAVBufferStatistics.Get() }), nullptr);
+			pDeviceContext->Dispatch((width + 7) / 8, (height + 7) / 8, 1);
+			pDeviceContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+			pDeviceContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+			pDeviceContext->CopyResource(pTextureNodeCountsStaging.Get(), pTextureNodeCounts.Get());
+			pDeviceContext->CopyResource(pBufferStatisticsStaging.Get(), pBufferStatistics.Get());
+		}
+
+		OIT::DepthComplexity complexity;
+		complexity.Width = width;
+		complexity.Height = height;
+		complexity.FragmentCount = resolvePermutation.FragmentCount;
+
+		D3D11_MAPPED_SUBRESOURCE mapped = {};
+		DX::ThrowIfFailed(pDeviceContext->Map(pBufferStatisticsStaging.Get(), 0, D3D11_MAP_READ, 0, &mapped));
+		auto const pStatistics = static_cast<uint32_t const*>(mapped.pData);
+		complexity.Histogram.assign(pStatistics, pStatistics + OIT::DEPTH_COMPLEXITY_BIN_COUNT);
+		complexity.MaxNodes = pStatistics[OIT::DEPTH_COMPLEXITY_BIN_COUNT + 0];
+		complexity.Nodes = pStatistics[OIT::DEPTH_COMPLEXITY_BIN_COUNT + 1];
+		complexity.NodesVisited = pStatistics[OIT::DEPTH_COMPLEXITY_BIN_COUNT + 2];
+		complexity.TruncatedPixels = pStatistics[OIT::DEPTH_COMPLEXITY_BIN_COUNT + 3];
+		pDeviceContext->Unmap(pBufferStatisticsStaging.Get(), 0);
+
+		DX::ThrowIfFailed(pDeviceContext->Map(pTextureNodeCountsStaging.Get(), 0, D3D11_MAP_READ, 0, &mapped));
+		complexity.NodeCounts.resize(size_t(width) * height);
+		for (uint32_t y = 0; y < height; y++) {
+			auto const pRow = reinterpret_cast<uint32_t const*>(static_cast<uint8_t const*>(mapped.pData) + size_t(y) * mapped.RowPitch);
+			std::copy(pRow, pRow + width, &complexity.NodeCounts[size_t(y) * width]);
+		}
+		pDeviceContext->Unmap(pTextureNodeCountsStaging.Get(), 0);
+
+		auto const fileName = "DepthComplexity_" + std::to_string(complexityCaptureIdx);
+		OIT::WriteImagePPM(fileName + ".ppm", OIT::CreateHeatMap(complexity));
+		OIT::WriteDepthComplexityJSON(fileName + ".json", complexity, complexityCaptureIdx);
+		std::printf("Depth complexity: max %u, p50 %u, p90 %u, p99 %u nodes, %u nodes visited, %u pixels truncated by %u, wrote %s.ppm and .json\n",
+			complexity.MaxNodes, OIT::GetNodeCountPercentile(complexity, 50.0), OIT::GetNodeCountPercentile(complexity, 90.0), OIT::GetNodeCountPercentile(complexity, 99.0),
+			static_cast<uint32_t>(complexity.NodesVisited), static_cast<uint32_t>(complexity.TruncatedPixels), complexity.FragmentCount, fileName.c_str());
+		complexityCaptureIdx++;
+	};
+
+	auto isFirstFrame = true;
 	auto isRun = true;
 	while (isRun) {
 		SDL_Event event;
@@ -454,6 +896,45 @@ int main(int argc, char* argv)
 							break;
 					}			
 					break;
+				case SDL_KEYDOWN:
+					if (event.key.keysym.sym == SDLK_LEFTBRACKET || event.key.keysym.sym == SDLK_RIGHTBRACKET) {
+						auto const pFragmentCounts = std::begin(OIT::PERMUTATION_FRAGMENT_COUNTS);
+						auto fragmentCountIdx = static_cast<size_t>(std::find(pFragmentCounts, std::end(OIT::PERMUTATION_FRAGMENT_COUNTS), resolvePermutation.FragmentCount) - pFragmentCounts);
+						if (event.key.keysym.sym == SDLK_LEFTBRACKET)
+							fragmentCountIdx = fragmentCountIdx > 0 ? fragmentCountIdx - 1 : 0;
+						else
+							fragmentCountIdx = (std::min)(fragmentCountIdx + 1, std::size(OIT::PERMUTATION_FRAGMENT_COUNTS) - 1);
+						resolvePermutation.FragmentCount = pFragmentCounts[fragmentCountIdx];
+						std::printf("Resolve: FRAGMENT_COUNT %u, MSAA_SAMPLE_COUNT %u\n", resolvePermutation.FragmentCount, resolvePermutation.SampleCount);
+					}
+					if (event.key.keysym.sym == SDLK_h) {
+						isComplexityCaptureRequested = true;
+						if (oitMethod != OIT::TransparencyMethod::LinkedList)
+							std::printf("Depth complexity is captured on the next %s frame\n", OIT::ToString(OIT::TransparencyMethod::LinkedList));
+					}
+					if (event.key.keysym.sym == SDLK_m) {
+						auto const pMethods = std::begin(OIT::TRANSPARENCY_METHODS);
+						auto methodIdx = static_cast<size_t>(std::find(pMethods, std::end(OIT::TRANSPARENCY_METHODS), oitMethod) - pMethods);
+						// Depth peeling is the exact reference of the CPU engine and has no pipeline here.
+						do {
+							methodIdx = (methodIdx + 1) % std::size(OIT::TRANSPARENCY_METHODS);
+						} while ((OIT::IsRasterizerOrdered(pMethods[methodIdx]) && !isROVSupported) || pMethods[methodIdx] == OIT::TransparencyMethod::DepthPeeling);
+						oitMethod = pMethods[methodIdx];
+						int32_t width = 0;
+						int32_t height = 0;
+						SDL_GetWindowSize(pWindow.get(), &width, &height);
+						ResizeRenderTargets(width, height);
+						std::printf("OIT method: %s\n", OIT::ToString(oitMethod));
+					}
+					if (event.key.keysym.sym == SDLK_c) {
+						isNodeCompactionOIT = !isNodeCompactionOIT;
+						int32_t width = 0;
+						int32_t height = 0;
+						SDL_GetWindowSize(pWindow.get(), &width, &height);
+						ResizeRenderTargets(width, height);
+						std::printf("OIT node compaction: %s\n", isNodeCompactionOIT ? "on" : "off");
+					}
+					break;
 				case SDL_QUIT:
 					isRun = false;
 					break;
@@ -466,6 +947,11 @@ int main(int argc, char* argv)
 		int32_t height = 0;
 		SDL_GetWindowSize(pWindow.get(), &width, &height);
 
+		// Waits for the variant if its background build has not finished yet.
+		auto& pPSOGeometryResolve = resolvePSOs[resolvePermutation];
+		if (!pPSOGeometryResolve)
+			pPSOGeometryResolve = CreateResolvePSO(pResolveShaders->Get(resolvePermutation));
+
 
 		auto const clearColor = { 0.0f, 0.0f, 0.0f, 0.0f };
 		auto const viewport = CD3D11_VIEWPORT(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
@@ -474,12 +960,48 @@ int main(int argc, char* argv)
 		auto const threadGroupsY = static_cast<uint32_t>(std::ceil(height / 8.0f));
 
 
+		// CPU time spent recording each pass, and a timestamp behind it for the GPU time.
+		auto const frameBegin = OIT::ProfilerClock::now();
+		auto passBegin = frameBegin;
+		auto const EndPass = [&](ProfilePass pass) -> void {
+			auto const passEnd = OIT::ProfilerClock::now();
+			pProfiler->RecordCPU(pass, std::chrono::duration<double, std::milli>(passEnd - passBegin).count());
+			pTimestamps->Timestamp(pDeviceContext);
+			passBegin = passEnd;
+		};
+
+		pTimestamps->BeginFrame(pDeviceContext);
+		pTimestamps->Timestamp(pDeviceContext);
+
 		pDeviceContext->ClearRenderTargetView(pRTV_MSAA.Get(), std::data(clearColor));
 		pDeviceContext->ClearDepthStencilView(pDSV_MSAA.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
-		pDeviceContext->ClearUnorderedAccessViewUint(pUAVTextureHeadOIT.Get(), std::data({ 0xFFFFFFFF }));
+		if (oitMethod == OIT::TransparencyMethod::WeightedBlended) {
+			pDeviceContext->ClearRenderTargetView(pRTVAccumulationMSAA.Get(), std::data({ 0.0f, 0.0f, 0.0f, 0.0f }));
+			pDeviceContext->ClearRenderTargetView(pRTVRevealageMSAA.Get(), std::data({ 1.0f, 1.0f, 1.0f, 1.0f }));
+		}
+		else if (oitMethod == OIT::TransparencyMethod::MomentBased) {
+			pDeviceContext->ClearRenderTargetView(pRTVAccumulationMSAA.Get(), std::data({ 0.0f, 0.0f, 0.0f, 0.0f }));
+			pDeviceContext->ClearRenderTargetView(pRTVMoment0MSAA.Get(), std::data({ 0.0f, 0.0f, 0.0f, 0.0f }));
+			pDeviceContext->ClearRenderTargetView(pRTVMomentsMSAA.Get(), std::data({ 0.0f, 0.0f, 0.0f, 0.0f }));
+		}
+		else if (oitMethod == OIT::TransparencyMethod::MultiLayerAlphaBlending) {
+			pDeviceContext->ClearUnorderedAccessViewUint(pUAVBufferLayersOIT.Get(), std::data({ 0xFF800000u, 0xFF800000u, 0xFF800000u, 0xFF800000u }));
+		}
+		else if (oitMethod == OIT::TransparencyMethod::AdaptiveTransparency) {
+			pDeviceContext->ClearUnorderedAccessViewUint(pUAVBufferLayersOIT.Get(), std::data({ 0x7F800000u, 0x7F800000u, 0x7F800000u, 0x7F800000u }));
+		}
+		else if (oitMethod == OIT::TransparencyMethod::PrefixSum) {
+			pDeviceContext->ClearUnorderedAccessViewUint(pUAVBufferFragmentCountsOIT.Get(), std::data({ 0u, 0u, 0u, 0u }));
+		}
+		else {
+			pDeviceContext->ClearUnorderedAccessViewUint(pUAVTextureHeadOIT.Get(), std::data({ 0xFFFFFFFF }));
+			if (isNodeCompactionOIT)
+				pDeviceContext->ClearUnorderedAccessViewUint(pUAVBufferFragmentCountsOIT.Get(), std::data({ 0u, 0u, 0u, 0u }));
+		}
 
 		pDeviceContext->RSSetViewports(1, &viewport);
 		pDeviceContext->RSSetScissorRects(1, &scissor);
+		EndPass(PROFILE_PASS_CLEAR);
 
 		{
 			ID3D11RenderTargetView* ppRTVClear[] = { nullptr };
@@ -489,34 +1011,244 @@ int main(int argc, char* argv)
 			pDeviceContext->OMSetRenderTargets(1, pRTV_MSAA.GetAddressOf(), pDSV_MSAA.Get());
 			pDeviceContext->DrawInstanced(3, 5, 0, 0);
 			pDeviceContext->OMSetRenderTargets(_countof(ppRTVClear), ppRTVClear, pDSVClear);
+			EndPass(PROFILE_PASS_OPAQUE);
 		}
 	
-		{
-			
+		if (oitMethod == OIT::TransparencyMethod::WeightedBlended) {
+			ID3D11RenderTargetView* ppRTVClear[] = { nullptr, nullptr };
+			ID3D11DepthStencilView* pDSVClear = nullptr;
+
+			pPSOGeometryWeighted->Apply(pDeviceContext);
+			pDeviceContext->OMSetRenderTargets(2, std::data({ pRTVAccumulationMSAA.Get(), pRTVRevealageMSAA.Get() }), pDSV_MSAA.Get());
+			pDeviceContext->DrawInstanced(3, 5, 0, 0);
+			pDeviceContext->OMSetRenderTargets(_countof(ppRTVClear), ppRTVClear, pDSVClear);
+			EndPass(PROFILE_PASS_TRANSPARENT);
+		}
+		else if (oitMethod == OIT::TransparencyMethod::MomentBased) {
+			ID3D11RenderTargetView*   ppRTVClear[] = { nullptr, nullptr };
+			ID3D11ShaderResourceView* ppSRVClear[] = { nullptr, nullptr };
+			ID3D11DepthStencilView*   pDSVClear = nullptr;
+
+			pPSOGeometryMoments->Apply(pDeviceContext);
+			pDeviceContext->OMSetRenderTargets(2, std::data({ pRTVMoment0MSAA.Get(), pRTVMomentsMSAA.Get() }), pDSV_MSAA.Get());
+			pDeviceContext->DrawInstanced(3, 5, 0, 0);
+
+			pPSOGeometryMomentsResolve->Apply(pDeviceContext);
+			pDeviceContext->OMSetRenderTargets(1, pRTVAccumulationMSAA.GetAddressOf(), pDSV_MSAA.Get());
+			pDeviceContext->PSSetShaderResources(0, 2, std::data({ pSRVMoment0MSAA.Get(), pSRVMomentsMSAA.Get() }));
+			pDeviceContext->DrawInstanced(3, 5, 0, 0);
+			pDeviceContext->PSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+			pDeviceContext->OMSetRenderTargets(_countof(ppRTVClear), ppRTVClear, pDSVClear);
+			EndPass(PROFILE_PASS_TRANSPARENT);
+		}
+		else if (OIT::IsRasterizerOrdered(oitMethod)) {
+			ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr };
+			ID3D11DepthStencilView*    pDSVClear    = nullptr;
+
+			(oitMethod == OIT::TransparencyMethod::MultiLayerAlphaBlending ? pPSOGeometryLayers : pPSOGeometryAdaptive)->Apply(pDeviceContext);
+			pDeviceContext->PSSetConstantBuffers(0, 1, pLayerConstantsOIT.GetAddressOf());
+			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSV_MSAA.Get(), 1, 1, pUAVBufferLayersOIT.GetAddressOf(), nullptr);
+			pDeviceContext->DrawInstanced(3, 5, 0, 0);
+			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSVClear, 1, _countof(ppUAVClear), ppUAVClear, nullptr);
+			EndPass(PROFILE_PASS_TRANSPARENT);
+		}
+		else if (oitMethod == OIT::TransparencyMethod::PrefixSum) {
 			ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr, nullptr };
+			ID3D11ShaderResourceView*  ppSRVClear[] = { nullptr };
+			ID3D11DepthStencilView*    pDSVClear    = nullptr;
+			auto const scanGroupCount = (fragmentElementCountOIT + FRAGMENT_SCAN_GROUP_SIZE - 1) / FRAGMENT_SCAN_GROUP_SIZE;
+
+			pPSOGeometryArraysCount->Apply(pDeviceContext);
+			pDeviceContext->PSSetConstantBuffers(0, 1, pFragmentArrayConstantsOIT.GetAddressOf());
+			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSV_MSAA.Get(), 1, 1, pUAVBufferFragmentCountsOIT.GetAddressOf(), nullptr);
+			pDeviceContext->DrawInstanced(3, 5, 0, 0);
+			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSVClear, 1, 1, ppUAVClear, nullptr);
+
+			pDeviceContext->CSSetConstantBuffers(0, 1, pFragmentArrayConstantsOIT.GetAddressOf());
+			pDeviceContext->CSSetShaderResources(0, 1, pSRVBufferFragmentCountsOIT.GetAddressOf());
+			pDeviceContext->CSSetUnorderedAccessViews(0, 2, std::data({ pUAVBufferFragmentOffsetsOIT.Get(), pUAVBufferScanGroupSumsOIT.Get() }), nullptr);
+			pPSOArraysScan->Apply(pDeviceContext);
+			pDeviceContext->Dispatch(scanGroupCount, 1, 1);
+			pPSOArraysScanGroupSums->Apply(pDeviceContext);
+			pDeviceContext->Dispatch(1, 1, 1);
+			pPSOArraysAddGroupOffsets->Apply(pDeviceContext);
+			pDeviceContext->Dispatch(scanGroupCount, 1, 1);
+			pDeviceContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+			pDeviceContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
+			pFragmentTotalReadbackOIT->CopyElement(pDeviceContext, pBufferFragmentOffsetsOIT, fragmentElementCountOIT - 1);
+
+			pPSOGeometryArraysFill->Apply(pDeviceContext);
+			pDeviceContext->PSSetShaderResources(0, 1, pSRVBufferFragmentOffsetsOIT.GetAddressOf());
+			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSV_MSAA.Get(), 1, 2, std::data({ pUAVBufferFragmentCountsOIT.Get(), pUAVBufferFragmentsOIT.Get() }), nullptr);
+			pDeviceContext->DrawInstanced(3, 5, 0, 0);
+			pDeviceContext->PSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
+			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSVClear, 1, _countof(ppUAVClear), ppUAVClear, nullptr);
+			EndPass(PROFILE_PASS_TRANSPARENT);
+		}
+		else {
+			
+			ID3D11UnorderedAccessView* ppUAVClear[] = { nullptr, nullptr, nullptr };
 			ID3D11DepthStencilView*    pDSVClear    = nullptr;
 
 			pPSOGeometryTransparent->Apply(pDeviceContext);
-			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSV_MSAA.Get(), 0, 2, std::data({ pUAVTextureHeadOIT.Get(),pUAVBufferLinkedListOIT.Get() }), std::data({ 0x0u, 0x0u }));
+			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSV_MSAA.Get(), 0, 3, std::data({ pUAVTextureHeadOIT.Get(), pUAVBufferLinkedListOIT.Get(), pUAVBufferLinkedListPayloadOIT.Get() }), std::data({ 0x0u, 0x0u, 0x0u }));
 			pDeviceContext->DrawInstanced(3, 5, 0, 0);
 			pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews(0, nullptr, pDSVClear, 0, _countof(ppUAVClear), ppUAVClear, nullptr);
+			pCounterReadbackOIT->Copy(pDeviceContext, pUAVBufferLinkedListOIT, nodeCapacityOIT);
+			EndPass(PROFILE_PASS_TRANSPARENT);
+		}
+
+		if (oitMethod == OIT::TransparencyMethod::LinkedList) {
+			// Total of the compacted nodes of a frame a few frames back, which goes through the fragment array sizer.
+			// CSCompactLists cuts the lists of a frame whose total does not fit.
+			uint32_t fragmentTotal = 0;
+			uint32_t fragmentCapacitySubmitted = 0;
+			if (isNodeCompactionOIT && pFragmentTotalReadbackOIT->TryRead(pDeviceContext, fragmentTotal, &fragmentCapacitySubmitted)) {
+				if (fragmentTotal > fragmentCapacitySubmitted)
+					std::printf("OIT node compaction: %u of %u nodes cut\n", fragmentTotal - fragmentCapacitySubmitted, fragmentTotal);
+				auto const fragmentCapacity = static_cast<uint32_t>(pFragmentSizerOIT->Update(fragmentTotal));
+				if (fragmentCapacity != fragmentCapacityOIT) {
+					std::printf("OIT node compaction: resized to %u nodes (%.1f MB)\n", fragmentCapacity, fragmentCapacity * sizeof(OIT::ListSubNodeMS) / (1024.0 * 1024.0));
+					ResizeFragmentBuffer(fragmentCapacity);
+				}
+			}
+			if (isComplexityCaptureRequested) {
+				CaptureDepthComplexity(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+				isComplexityCaptureRequested = false;
+			}
+			// Pool upkeep and captures are not part of any pass.
+			passBegin = OIT::ProfilerClock::now();
 		}
 
 		{
-			ID3D11UnorderedAccessView* ppUAVClear[]  = { nullptr };
-			ID3D11ShaderResourceView*  ppSRVClear[] = { nullptr, nullptr };
+			ID3D11UnorderedAccessView* ppUAVClear[]  = { nullptr, nullptr, nullptr };
+			ID3D11ShaderResourceView*  ppSRVClear[] = { nullptr, nullptr, nullptr, nullptr, nullptr };
 		
 			pMSAAResolver->Apply(pDeviceContext, pRTV_MSAA, pRTVSwapChain, colorBufferFormat);		
-			pPSOGeometryResolve->Apply(pDeviceContext);
-			pDeviceContext->CSSetShaderResources(0, 2, std::data({ pSRVTextureHeadOIT.Get(), pSRVBufferLinkedListOIT.Get() }));
+			EndPass(PROFILE_PASS_RESOLVE_MSAA);
+			if (oitMethod == OIT::TransparencyMethod::WeightedBlended) {
+				pPSOCompositeWeighted->Apply(pDeviceContext);
+				pDeviceContext->CSSetShaderResources(0, 2, std::data({ pSRVAccumulationMSAA.Get(), pSRVRevealageMSAA.Get() }));
+			}
+			else if (oitMethod == OIT::TransparencyMethod::MomentBased) {
+				pPSOCompositeMoments->Apply(pDeviceContext);
+				pDeviceContext->CSSetShaderResources(0, 3, std::data({ pSRVMoment0MSAA.Get(), pSRVMomentsMSAA.Get(), pSRVAccumulationMSAA.Get() }));
+			}
+			else if (OIT::IsRasterizerOrdered(oitMethod)) {
+				(oitMethod == OIT::TransparencyMethod::MultiLayerAlphaBlending ? pPSOCompositeLayers : pPSOCompositeAdaptive)->Apply(pDeviceContext);
+				pDeviceContext->CSSetConstantBuffers(0, 1, pLayerConstantsOIT.GetAddressOf());
+				pDeviceContext->CSSetShaderResources(0, 1, pSRVBufferLayersOIT.GetAddressOf());
+			}
+			else if (oitMethod == OIT::TransparencyMethod::PrefixSum) {
+				pPSOArraysResolve->Apply(pDeviceContext);
+				pDeviceContext->CSSetConstantBuffers(0, 1, pFragmentArrayConstantsOIT.GetAddressOf());
+				pDeviceContext->CSSetShaderResources(0, 2, std::data({ pSRVBufferFragmentOffsetsOIT.Get(), pSRVBufferFragmentsOIT.Get() }));
+			}
+			else if (isNodeCompactionOIT) {
+				// Count, scan and copy the lists into the tiled ranges, then resolve those. Part of the resolve pass.
+				auto const scanGroupCount = (fragmentElementCountOIT + FRAGMENT_SCAN_GROUP_SIZE - 1) / FRAGMENT_SCAN_GROUP_SIZE;
+				pDeviceContext->CSSetConstantBuffers(0, 1, pFragmentArrayConstantsOIT.GetAddressOf());
+				pDeviceContext->CSSetShaderResources(2, 3, std::data({ pSRVTextureHeadOIT.Get(), pSRVBufferLinkedListOIT.Get(), pSRVBufferLinkedListPayloadOIT.Get() }));
+				pPSOCompactionCount->Apply(pDeviceContext);
+				pDeviceContext->CSSetUnorderedAccessViews(1, 1, pUAVBufferFragmentCountsOIT.GetAddressOf(), nullptr);
+				pDeviceContext->Dispatch(threadGroupsX, threadGroupsY, 1);
+
+				pDeviceContext->CSSetUnorderedAccessViews(1, 1, ppUAVClear, nullptr);
+				pDeviceContext->CSSetShaderResources(0, 1, pSRVBufferFragmentCountsOIT.GetAddressOf());
+				pDeviceContext->CSSetUnorderedAccessViews(0, 2, std::data({ pUAVBufferFragmentOffsetsOIT.Get(), pUAVBufferScanGroupSumsOIT.Get() }), nullptr);
+				pPSOArraysScan->Apply(pDeviceContext);
+				pDeviceContext->Dispatch(scanGroupCount, 1, 1);
+				pPSOArraysScanGroupSums->Apply(pDeviceContext);
+				pDeviceContext->Dispatch(1, 1, 1);
+				pPSOArraysAddGroupOffsets->Apply(pDeviceContext);
+				pDeviceContext->Dispatch(scanGroupCount, 1, 1);
+				pDeviceContext->CSSetUnorderedAccessViews(0, 2, ppUAVClear, nullptr);
+				pFragmentTotalReadbackOIT->CopyElement(pDeviceContext, pBufferFragmentOffsetsOIT, fragmentElementCountOIT - 1, fragmentCapacityOIT);
+
+				pPSOCompactionCopy->Apply(pDeviceContext);
+				pDeviceContext->CSSetShaderResources(0, 1, pSRVBufferFragmentOffsetsOIT.GetAddressOf());
+				pDeviceContext->CSSetUnorderedAccessViews(2, 1, pUAVBufferFragmentsOIT.GetAddressOf(), nullptr);
+				pDeviceContext->Dispatch(threadGroupsX, threadGroupsY, 1);
+				pDeviceContext->CSSetShaderResources(2, 3, ppSRVClear);
+				pDeviceContext->CSSetUnorderedAccessViews(2, 1, ppUAVClear, nullptr);
+
+				pPSOCompactionResolve->Apply(pDeviceContext);
+				pDeviceContext->CSSetShaderResources(0, 2, std::data({ pSRVBufferFragmentOffsetsOIT.Get(), pSRVBufferFragmentsOIT.Get() }));
+			}
+			else {
+				pPSOGeometryResolve->Apply(pDeviceContext);
+				pDeviceContext->CSSetShaderResources(0, 3, std::data({ pSRVTextureHeadOIT.Get(), pSRVBufferLinkedListOIT.Get(), pSRVBufferLinkedListPayloadOIT.Get() }));
+			}
 			pDeviceContext->CSSetUnorderedAccessViews(0, 1, pUAVSwapChain.GetAddressOf(), nullptr);
 			pDeviceContext->Dispatch(threadGroupsX, threadGroupsY, 1);
 			pDeviceContext->CSSetShaderResources(0, _countof(ppSRVClear), ppSRVClear);
 			pDeviceContext->CSSetUnorderedAccessViews(0, _countof(ppUAVClear), ppUAVClear, nullptr);
-		
+			EndPass(PROFILE_PASS_RESOLVE_OIT);
 		}
+		pTimestamps->EndFrame(pDeviceContext);
 
 		DX::ThrowIfFailed(pSwapChain->Present(0, 0));
+		if (isFirstFrame) {
+			std::printf("Time to first frame: %.1f ms\n", std::chrono::duration<double, std::milli>(OIT::ProfilerClock::now() - startupTimeBegin).count());
+			isFirstFrame = false;
+
+			// Build the other fragment caps in the background now that startup no longer competes for the workers.
+			for (auto const fragmentCount : OIT::PERMUTATION_FRAGMENT_COUNTS)
+				pResolveShaders->Prefetch({ fragmentCount, MSAA_SAMPLES });
+		}
+
+		// Pool upkeep runs after the resolve has read this frame's nodes or fragments and before the next frame clears
+		// the heads, as Engine::UpdateNodePool does in the CPU engine.
+		if (oitMethod == OIT::TransparencyMethod::LinkedList) {
+			// Counter of a frame a few frames back, compared against the capacity that frame rendered with. Report
+			// whenever the peak grows so the pool can be budgeted.
+			uint32_t nodeCounter = 0;
+			uint32_t nodeCapacitySubmitted = 0;
+			if (pCounterReadbackOIT->TryRead(pDeviceContext, nodeCounter, &nodeCapacitySubmitted)) {
+				if (nodeCounter > nodeCounterPeakOIT) {
+					nodeCounterPeakOIT = nodeCounter;
+					std::printf("OIT node pool: counter %u, capacity %u, dropped %u\n", nodeCounter, nodeCapacitySubmitted, nodeCounter > nodeCapacitySubmitted ? nodeCounter - nodeCapacitySubmitted : 0);
+				}
+
+				if (pPoolSizerOIT) {
+					auto const nodeCapacity = static_cast<uint32_t>(pPoolSizerOIT->Update(nodeCounter));
+					if (nodeCapacity != nodeCapacityOIT) {
+						std::printf("OIT node pool: resized to %u nodes (%.1f MB)\n", nodeCapacity, nodeCapacity * OIT::LIST_NODE_SIZE / (1024.0 * 1024.0));
+						ResizeNodeBuffer(nodeCapacity);
+					}
+				}
+			}
+		}
+		else if (oitMethod == OIT::TransparencyMethod::PrefixSum) {
+			// Total of a frame a few frames back, the fragment buffer keeps headroom above the recent peak.
+			uint32_t fragmentTotal = 0;
+			if (pFragmentTotalReadbackOIT->TryRead(pDeviceContext, fragmentTotal)) {
+				auto const fragmentCapacity = static_cast<uint32_t>(pFragmentSizerOIT->Update(fragmentTotal));
+				if (fragmentCapacity != fragmentCapacityOIT) {
+					std::printf("OIT fragment arrays: resized to %u fragments (%.1f MB)\n", fragmentCapacity, fragmentCapacity * sizeof(OIT::ListSubNodeMS) / (1024.0 * 1024.0));
+					ResizeFragmentBuffer(fragmentCapacity);
+				}
+			}
+		}
+		pProfiler->RecordCPU(PROFILE_PASS_FRAME, std::chrono::duration<double, std::milli>(OIT::ProfilerClock::now() - frameBegin).count());
+
+		if (pTimestamps->TryRead(pDeviceContext, gpuPassDurations)) {
+			auto gpuFrameDuration = 0.0;
+			for (uint32_t passIdx = 0; passIdx < gpuPassDurations.size(); passIdx++) {
+				pProfiler->RecordGPU(passIdx, gpuPassDurations[passIdx]);
+				gpuFrameDuration += gpuPassDurations[passIdx];
+			}
+			pProfiler->RecordGPU(PROFILE_PASS_FRAME, gpuFrameDuration);
+		}
+	}
+
+	pProfiler->WriteCSV(PROFILE_OUTPUT + ".csv");
+	pProfiler->WriteJSON(PROFILE_OUTPUT + ".json");
+	for (uint32_t passIdx = 0; passIdx < pProfiler->GetPassCount(); passIdx++) {
+		auto const cpu = pProfiler->GetCPUSummary(passIdx);
+		auto const gpu = pProfiler->GetGPUSummary(passIdx);
+		std::printf("%-12s CPU p50/p95/p99 %.3f/%.3f/%.3f ms, GPU p50/p95/p99 %.3f/%.3f/%.3f ms\n", pProfiler->GetPassName(passIdx).c_str(),
+			cpu.P50, cpu.P95, cpu.P99, gpu.P50, gpu.P95, gpu.P99);
 	}
 
 	SDL_Quit();
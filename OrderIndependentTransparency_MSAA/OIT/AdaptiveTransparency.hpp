@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	constexpr uint32_t MAX_AT_NODE_COUNT = 16;
+
+	// Mirror of AdaptiveNode in AdaptiveTransparency.hlsl: one step of the visibility function of an MSAA sample.
+	// Transmittance is the visibility right behind Depth. The color is premultiplied and already attenuated by the
+	// visibility in front of the node, so the composite is a plain sum without any sort.
+	struct AdaptiveNode {
+		float Depth;
+		float Transmittance;
+		float R;
+		float G;
+		float B;
+	};
+
+	static_assert(sizeof(AdaptiveNode) == 20, "AdaptiveNode must match the HLSL layout");
+
+	// Unused node slot, every field +INF. The depth sorts behind every fragment, so the filled nodes always form a
+	// prefix. PSInsert clears its buffer to the same bits with ClearUnorderedAccessViewUint(0x7F800000).
+	constexpr float EMPTY_AT_DEPTH = std::numeric_limits<float>::infinity();
+	constexpr AdaptiveNode EMPTY_AT_NODE = { EMPTY_AT_DEPTH, EMPTY_AT_DEPTH, EMPTY_AT_DEPTH, EMPTY_AT_DEPTH, EMPTY_AT_DEPTH };
+
+	inline auto GetAdaptiveNodeCount(AdaptiveNode const* pNodes, uint32_t nodeCount) -> uint32_t {
+		uint32_t count = 0;
+		while (count < nodeCount && pNodes[count].Depth != EMPTY_AT_DEPTH)
+			count++;
+		return count;
+	}
+
+	// Mirror of InsertNode in AdaptiveTransparency.hlsl, after Salvi et al., "Adaptive Transparency". Nodes are kept
+	// front to back. The fragment attenuates every node behind it; once nodeCount + 1 nodes exist the one whose
+	// removal changes the area under the visibility curve least is folded into its predecessor. Folding moves the
+	// step to the nearer depth and keeps the summed color, so the total transmittance is never lost.
+	inline auto InsertAdaptiveNode(AdaptiveNode* pNodes, uint32_t nodeCount, float depth, Color4 const& color) -> void {
+		AdaptiveNode nodes[MAX_AT_NODE_COUNT + 1];
+		auto const count = GetAdaptiveNodeCount(pNodes, nodeCount);
+		auto const alpha = Saturate(color.A);
+
+		uint32_t insertIdx = 0;
+		while (insertIdx < count && pNodes[insertIdx].Depth <= depth) {
+			nodes[insertIdx] = pNodes[insertIdx];
+			insertIdx++;
+		}
+
+		auto const visibility = insertIdx > 0 ? nodes[insertIdx - 1].Transmittance : 1.0f;
+		nodes[insertIdx] = { depth, visibility * (1.0f - alpha), Saturate(color.R) * alpha * visibility, Saturate(color.G) * alpha * visibility, Saturate(color.B) * alpha * visibility };
+		for (auto nodeIdx = insertIdx; nodeIdx < count; nodeIdx++) {
+			auto const& node = pNodes[nodeIdx];
+			nodes[nodeIdx + 1] = { node.Depth, node.Transmittance * (1.0f - alpha), node.R * (1.0f - alpha), node.G * (1.0f - alpha), node.B * (1.0f - alpha) };
+		}
+
+		auto newCount = count + 1;
+		if (newCount > nodeCount) {
+			uint32_t removeIdx = 1;
+			auto minArea = std::numeric_limits<float>::infinity();
+			for (uint32_t nodeIdx = 1; nodeIdx < newCount; nodeIdx++) {
+				auto const area = (nodes[nodeIdx - 1].Transmittance - nodes[nodeIdx].Transmittance) * (nodes[nodeIdx].Depth - nodes[nodeIdx - 1].Depth);
+				if (area < minArea) {
+					minArea = area;
+					removeIdx = nodeIdx;
+				}
+			}
+
+			auto& target = nodes[removeIdx - 1];
+			target.Transmittance = nodes[removeIdx].Transmittance;
+			target.R += nodes[removeIdx].R;
+			target.G += nodes[removeIdx].G;
+			target.B += nodes[removeIdx].B;
+			for (auto nodeIdx = removeIdx; nodeIdx + 1 < newCount; nodeIdx++)
+				nodes[nodeIdx] = nodes[nodeIdx + 1];
+			newCount--;
+		}
+
+		for (uint32_t nodeIdx = 0; nodeIdx < newCount; nodeIdx++)
+			pNodes[nodeIdx] = nodes[nodeIdx];
+	}
+
+	// CSComposite for one sample: the sum of the node colors over the background seen through the last node. The
+	// alpha channel follows CompositeWeighted.
+	inline auto CompositeAdaptive(AdaptiveNode const* pNodes, uint32_t count, Color4 const& background) -> Color4 {
+		Color4 color = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (uint32_t nodeIdx = 0; nodeIdx < count; nodeIdx++)
+			color = color + Color4{ pNodes[nodeIdx].R, pNodes[nodeIdx].G, pNodes[nodeIdx].B, 0.0f };
+
+		auto const transmittance = count > 0 ? pNodes[count - 1].Transmittance : 1.0f;
+		return { color.R + background.R * transmittance, color.G + background.G * transmittance, color.B + background.B * transmittance, Lerp(1.0f, background.A, transmittance) };
+	}
+
+}
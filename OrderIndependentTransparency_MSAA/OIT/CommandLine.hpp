@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace OIT {
+
+	// Minimal "--name value" / "--flag" parser shared by the headless tools. Every getter records the name it looked
+	// up, so CheckUnused can reject misspelled options once all of them have been read.
+	class CommandLine {
+	public:
+		CommandLine(int argc, char** argv) {
+			for (int index = 1; index < argc; index++)
+				m_Arguments.emplace_back(argv[index]);
+		}
+
+		auto HasFlag(std::string const& name) const -> bool {
+			m_Consumed.insert(name);
+			for (auto const& argument : m_Arguments)
+				if (argument == "--" + name)
+					return true;
+			return false;
+		}
+
+		auto GetString(std::string const& name, std::string const& defaultValue) const -> std::string {
+			m_Consumed.insert(name);
+			for (size_t index = 0; index + 1 < m_Arguments.size(); index++)
+				if (m_Arguments[index] == "--" + name)
+					return m_Arguments[index + 1];
+			return defaultValue;
+		}
+
+		auto GetUint(std::string const& name, uint32_t defaultValue) const -> uint32_t {
+			auto const value = GetString(name, std::string());
+			if (value.empty())
+				return defaultValue;
+			try {
+				return static_cast<uint32_t>(std::stoul(value));
+			}
+			catch (std::exception const&) {
+				throw std::invalid_argument("Invalid value for --" + name + ": " + value);
+			}
+		}
+
+		auto GetFloat(std::string const& name, float defaultValue) const -> float {
+			auto const value = GetString(name, std::string());
+			if (value.empty())
+				return defaultValue;
+			try {
+				return std::stof(value);
+			}
+			catch (std::exception const&) {
+				throw std::invalid_argument("Invalid value for --" + name + ": " + value);
+			}
+		}
+
+		auto GetStringList(std::string const& name, std::vector<std::string> const& defaultValue) const -> std::vector<std::string> {
+			auto const value = GetString(name, std::string());
+			if (value.empty())
+				return defaultValue;
+
+			std::vector<std::string> result;
+			size_t begin = 0;
+			while (begin <= value.size()) {
+				auto end = value.find(',', begin);
+				if (end == std::string::npos)
+					end = value.size();
+				result.push_back(value.substr(begin, end - begin));
+				begin = end + 1;
+			}
+			return result;
+		}
+
+		auto GetUintList(std::string const& name, std::vector<uint32_t> const& defaultValue) const -> std::vector<uint32_t> {
+			std::vector<uint32_t> result;
+			for (auto const& element : GetStringList(name, std::vector<std::string>())) {
+				try {
+					result.push_back(static_cast<uint32_t>(std::stoul(element)));
+				}
+				catch (std::exception const&) {
+					throw std::invalid_argument("Invalid value for --" + name + ": " + element);
+				}
+			}
+			return result.empty() ? defaultValue : result;
+		}
+
+		auto GetFloatList(std::string const& name, std::vector<float> const& defaultValue) const -> std::vector<float> {
+			std::vector<float> result;
+			for (auto const& element : GetStringList(name, std::vector<std::string>())) {
+				try {
+					result.push_back(std::stof(element));
+				}
+				catch (std::exception const&) {
+					throw std::invalid_argument("Invalid value for --" + name + ": " + element);
+				}
+			}
+			return result.empty() ? defaultValue : result;
+		}
+
+		// Throws on the first "--name" no getter has asked for.
+		auto CheckUnused() const -> void {
+			for (auto const& argument : m_Arguments)
+				if (argument.size() > 2 && argument.compare(0, 2, "--") == 0 && m_Consumed.count(argument.substr(2)) == 0)
+					throw std::invalid_argument("Unknown option " + argument + ", see --help");
+		}
+
+	private:
+		std::vector<std::string>      m_Arguments;
+		mutable std::set<std::string> m_Consumed;
+	};
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace OIT {
+
+	constexpr uint32_t INVALID_NODE_INDEX = 0xFFFFFFFF;
+	constexpr uint32_t MAX_MSAA_SAMPLES   = 8;
+	constexpr uint32_t MAX_FRAGMENT_COUNT = 64;
+	constexpr uint32_t RESOLVE_GROUP_SIZE = 8;
+
+	// Mirrors of the structures declared in Shaders/Common.hlsli.
+	struct ListNode {
+		uint32_t  Next;
+		uint32_t  Color;
+		uint32_t  Depth;
+		uint32_t  Coverage;
+	};
+
+	struct ListSubNode {
+		float     Depth;
+		uint32_t  Color;
+	};
+
+	struct ListSubNodeMS {
+		float     Depth;
+		uint32_t  Color;
+		uint32_t  Coverage;
+	};
+
+	static_assert(sizeof(ListNode) == 16, "ListNode must match the HLSL layout");
+	static_assert(sizeof(ListSubNode) == 8, "ListSubNode must match the HLSL layout");
+
+	struct Color4 {
+		float R;
+		float G;
+		float B;
+		float A;
+	};
+
+	// R8G8B8A8_UNORM texels, R in the lowest byte.
+	struct Image {
+		uint32_t              Width  = 0;
+		uint32_t              Height = 0;
+		std::vector<uint32_t> Texels;
+	};
+
+	inline auto AsUint(float value) -> uint32_t {
+		uint32_t result;
+		std::memcpy(&result, &value, sizeof(result));
+		return result;
+	}
+
+	inline auto AsFloat(uint32_t value) -> float {
+		float result;
+		std::memcpy(&result, &value, sizeof(result));
+		return result;
+	}
+
+	inline auto Saturate(float value) -> float {
+		return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+	}
+
+	inline auto Lerp(float x, float y, float s) -> float {
+		return x + s * (y - x);
+	}
+
+	inline auto Lerp(Color4 const& x, Color4 const& y, float s) -> Color4 {
+		return { Lerp(x.R, y.R, s), Lerp(x.G, y.G, s), Lerp(x.B, y.B, s), Lerp(x.A, y.A, s) };
+	}
+
+	inline auto operator+(Color4 const& x, Color4 const& y) -> Color4 {
+		return { x.R + y.R, x.G + y.G, x.B + y.B, x.A + y.A };
+	}
+
+	inline auto operator*(Color4 const& x, float s) -> Color4 {
+		return { x.R * s, x.G * s, x.B * s, x.A * s };
+	}
+
+	inline auto operator/(Color4 const& x, float s) -> Color4 {
+		return { x.R / s, x.G / s, x.B / s, x.A / s };
+	}
+
+	// Same bit layout as the HLSL version. Channels are saturated first, because attributes extrapolated to the pixel
+	// center of a partially covered pixel can leave [0, 1] and a negative float to uint conversion is undefined in C++.
+	inline auto PackColor(Color4 const& color) -> uint32_t {
+		return (static_cast<uint32_t>(Saturate(color.R) * 255) << 24) | (static_cast<uint32_t>(Saturate(color.G) * 255) << 16) | (static_cast<uint32_t>(Saturate(color.B) * 255) << 8) | static_cast<uint32_t>(Saturate(color.A) * 255);
+	}
+
+	inline auto UnpackColor(uint32_t color) -> Color4 {
+		Color4 result;
+		result.R = Saturate(static_cast<float>((color >> 24) & 0x000000FF) / 255.0f);
+		result.G = Saturate(static_cast<float>((color >> 16) & 0x000000FF) / 255.0f);
+		result.B = Saturate(static_cast<float>((color >> 8)  & 0x000000FF) / 255.0f);
+		result.A = Saturate(static_cast<float>((color >> 0)  & 0x000000FF) / 255.0f);
+		return result;
+	}
+
+	// One step of the back to front blend of CSMain, shared by every resolve that ends in sorted layers.
+	inline auto BlendListSubNode(Color4 const& dstPixelColor, ListSubNode const& node) -> Color4 {
+		auto const srcPixelColor = UnpackColor(node.Color);
+		return Lerp(dstPixelColor, srcPixelColor, srcPixelColor.A);
+	}
+
+	inline auto FloatToUnorm8(float value) -> uint32_t {
+		return static_cast<uint32_t>(Saturate(value) * 255.0f + 0.5f);
+	}
+
+	inline auto StoreTexel(Color4 const& color) -> uint32_t {
+		return FloatToUnorm8(color.R) | (FloatToUnorm8(color.G) << 8) | (FloatToUnorm8(color.B) << 16) | (FloatToUnorm8(color.A) << 24);
+	}
+
+	inline auto LoadTexel(uint32_t texel) -> Color4 {
+		Color4 result;
+		result.R = static_cast<float>((texel >> 0)  & 0x000000FF) / 255.0f;
+		result.G = static_cast<float>((texel >> 8)  & 0x000000FF) / 255.0f;
+		result.B = static_cast<float>((texel >> 16) & 0x000000FF) / 255.0f;
+		result.A = static_cast<float>((texel >> 24) & 0x000000FF) / 255.0f;
+		return result;
+	}
+
+}
@@ -0,0 +1,87 @@
+#include "DepthComplexity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace OIT {
+
+	auto GetCoveredPixelCount(DepthComplexity const& complexity) -> uint64_t {
+		uint64_t count = 0;
+		for (size_t binIdx = 1; binIdx < complexity.Histogram.size(); binIdx++)
+			count += complexity.Histogram[binIdx];
+		return count;
+	}
+
+	auto GetNodeCountPercentile(DepthComplexity const& complexity, double percentile) -> uint32_t {
+		auto const coveredPixels = GetCoveredPixelCount(complexity);
+		if (coveredPixels == 0)
+			return 0;
+
+		auto const rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * coveredPixels));
+		uint64_t pixels = 0;
+		for (size_t binIdx = 1; binIdx < complexity.Histogram.size(); binIdx++) {
+			pixels += complexity.Histogram[binIdx];
+			if (pixels >= std::max<uint64_t>(rank, 1))
+				return static_cast<uint32_t>(binIdx);
+		}
+		return complexity.MaxNodes;
+	}
+
+	auto CreateHeatMap(DepthComplexity const& complexity) -> Image {
+		// Blue, cyan, green, yellow, red at even steps.
+		Color4 const ramp[] = {
+			{ 0.0f, 0.0f, 1.0f, 1.0f },
+			{ 0.0f, 1.0f, 1.0f, 1.0f },
+			{ 0.0f, 1.0f, 0.0f, 1.0f },
+			{ 1.0f, 1.0f, 0.0f, 1.0f },
+			{ 1.0f, 0.0f, 0.0f, 1.0f }
+		};
+		constexpr uint32_t RAMP_SEGMENTS = static_cast<uint32_t>(std::size(ramp)) - 1;
+
+		Image image;
+		image.Width = complexity.Width;
+		image.Height = complexity.Height;
+		image.Texels.resize(complexity.NodeCounts.size());
+
+		auto const scale = std::max(std::min(complexity.MaxNodes, complexity.FragmentCount), 2u);
+		for (size_t pixelIdx = 0; pixelIdx < complexity.NodeCounts.size(); pixelIdx++) {
+			auto const count = complexity.NodeCounts[pixelIdx];
+			Color4 color = { 0.0f, 0.0f, 0.0f, 1.0f };
+			if (count > complexity.FragmentCount)
+				color = { 1.0f, 1.0f, 1.0f, 1.0f };
+			else if (count != 0) {
+				auto const position = static_cast<float>(count - 1) / static_cast<float>(scale - 1) * RAMP_SEGMENTS;
+				auto const segmentIdx = std::min(static_cast<uint32_t>(position), RAMP_SEGMENTS - 1);
+				color = Lerp(ramp[segmentIdx], ramp[segmentIdx + 1], position - static_cast<float>(segmentIdx));
+			}
+			image.Texels[pixelIdx] = StoreTexel(color);
+		}
+		return image;
+	}
+
+	auto WriteDepthComplexityJSON(std::string const& fileName, DepthComplexity const& complexity, uint32_t frameIdx) -> void {
+		std::ofstream file(fileName);
+		if (!file)
+			throw std::runtime_error("Failed to open " + fileName);
+
+		auto const coveredPixels = GetCoveredPixelCount(complexity);
+		file << "{\n  \"frame\": " << frameIdx << ", \"width\": " << complexity.Width << ", \"height\": " << complexity.Height
+			<< ", \"fragment_count\": " << complexity.FragmentCount << ",\n";
+		file << "  \"covered_pixels\": " << coveredPixels << ", \"nodes\": " << complexity.Nodes << ", \"nodes_visited\": " << complexity.NodesVisited
+			<< ", \"truncated_pixels\": " << complexity.TruncatedPixels << ",\n";
+		file << "  \"mean_nodes\": " << (coveredPixels ? static_cast<double>(complexity.Nodes) / coveredPixels : 0.0) << ", \"max_nodes\": " << complexity.MaxNodes
+			<< ", \"p50_nodes\": " << GetNodeCountPercentile(complexity, 50.0) << ", \"p90_nodes\": " << GetNodeCountPercentile(complexity, 90.0)
+			<< ", \"p99_nodes\": " << GetNodeCountPercentile(complexity, 99.0) << ",\n";
+		file << "  \"histogram\": [";
+		for (size_t binIdx = 0; binIdx < complexity.Histogram.size(); binIdx++)
+			file << (binIdx ? ", " : "") << complexity.Histogram[binIdx];
+		file << "]\n}\n";
+
+		if (!file)
+			throw std::runtime_error("Failed to write " + fileName);
+	}
+
+}
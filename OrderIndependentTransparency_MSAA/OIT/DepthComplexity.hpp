@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	// Bins of the histogram of DepthComplexity.hlsl. The last bin also counts every longer list.
+	constexpr uint32_t DEPTH_COMPLEXITY_BIN_COUNT = 256;
+
+	// Depth complexity of the linked lists of one frame, as CSMain sees them. Nodes are counted from the head pointer
+	// of every pixel, so fragments dropped by a full node pool do not show up.
+	struct DepthComplexity {
+		uint32_t Width         = 0;
+		uint32_t Height        = 0;
+		// FRAGMENT_COUNT the visited nodes and the truncation refer to.
+		uint32_t FragmentCount = 0;
+		// Nodes chained by every pixel, row major. Empty when only the histogram was read back from the GPU.
+		std::vector<uint32_t> NodeCounts;
+		// Pixels per node count, Histogram[n] pixels chain n nodes.
+		std::vector<uint64_t> Histogram;
+		uint32_t MaxNodes      = 0;
+		uint64_t Nodes         = 0;
+		// Nodes CSMain loads in all of its walks, one per sample in the per-sample resolve.
+		uint64_t NodesVisited  = 0;
+		// Pixels where CSMain leaves out a node of at least one sample.
+		uint64_t TruncatedPixels = 0;
+	};
+
+	// Pixels holding a list, the histogram without its first bin.
+	auto GetCoveredPixelCount(DepthComplexity const& complexity) -> uint64_t;
+
+	// Smallest node count that percentile (0 to 100) of the pixels holding a list do not exceed.
+	auto GetNodeCountPercentile(DepthComplexity const& complexity, double percentile) -> uint32_t;
+
+	// Node counts from blue over green and yellow to red at FragmentCount, or at MaxNodes if that is lower. Pixels
+	// without a list are black, longer lists than FragmentCount white.
+	auto CreateHeatMap(DepthComplexity const& complexity) -> Image;
+
+	auto WriteDepthComplexityJSON(std::string const& fileName, DepthComplexity const& complexity, uint32_t frameIdx) -> void;
+
+}
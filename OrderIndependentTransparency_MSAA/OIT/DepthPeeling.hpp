@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	// Position of a fragment in the back to front order of CSMain. The list of a pixel holds its fragments newest
+	// first and the resolve sorts them stably, so of two fragments at the same depth the later primitive is blended
+	// first, as if it was farther.
+	struct PeelKey {
+		float    Depth;
+		uint32_t Primitive;
+	};
+
+	// Behind every fragment, the state before the first peel.
+	constexpr PeelKey PEEL_KEY_BACK = { std::numeric_limits<float>::infinity(), UINT32_MAX };
+	// In front of every fragment, an empty candidate.
+	constexpr PeelKey PEEL_KEY_NONE = { -std::numeric_limits<float>::infinity(), 0 };
+
+	inline auto IsInFront(PeelKey const& lhs, PeelKey const& rhs) -> bool {
+		return lhs.Depth < rhs.Depth || (lhs.Depth == rhs.Depth && lhs.Primitive < rhs.Primitive);
+	}
+
+	// Depth peeling state of one MSAA sample. Every pass rasterizes the transparent geometry again and keeps the
+	// farthest fragment in front of the layer peeled last, which is then blended over the color. There is no
+	// fragment cap: the passes go on until no sample finds another layer.
+	struct PeelSample {
+		PeelKey  Peeled         = PEEL_KEY_BACK;
+		PeelKey  Candidate      = PEEL_KEY_NONE;
+		uint32_t CandidateColor = 0;
+		Color4   Color          = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	inline auto PeelFragment(PeelSample& sample, PeelKey const& key, uint32_t color) -> void {
+		if (IsInFront(key, sample.Peeled) && IsInFront(sample.Candidate, key)) {
+			sample.Candidate = key;
+			sample.CandidateColor = color;
+		}
+	}
+
+	// Blends the candidate of the pass like CSMain blends the next node. Returns false once the sample is done.
+	inline auto BlendPeeledLayer(PeelSample& sample) -> bool {
+		if (sample.Candidate.Depth == PEEL_KEY_NONE.Depth)
+			return false;
+
+		sample.Color = BlendListSubNode(sample.Color, ListSubNode{ sample.Candidate.Depth, sample.CandidateColor });
+		sample.Peeled = sample.Candidate;
+		sample.Candidate = PEEL_KEY_NONE;
+		return true;
+	}
+
+}
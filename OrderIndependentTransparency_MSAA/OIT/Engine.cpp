@@ -0,0 +1,897 @@
+#include "Engine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace OIT {
+
+	// NodeAllocation::PerTile relies on every resolve tile being rasterized by a single thread.
+	static_assert(RASTER_TILE_SIZE % RESOLVE_GROUP_SIZE == 0, "Rasterizer tiles must consist of whole resolve tiles");
+
+	constexpr uintptr_t CACHE_LINE_SIZE = 64;
+
+	auto ToString(EnginePass pass) -> char const* {
+		switch (pass) {
+			case EnginePass::Clear:       return "Clear";
+			case EnginePass::Opaque:      return "Opaque";
+			case EnginePass::Transparent: return "Transparent";
+			case EnginePass::ResolveMSAA: return "ResolveMSAA";
+			case EnginePass::ResolveOIT:  return "ResolveOIT";
+			case EnginePass::Frame:       return "Frame";
+			default:                      return "Unknown";
+		}
+	}
+
+	static auto GetEnginePassNames() -> std::vector<std::string> {
+		std::vector<std::string> names;
+		for (uint32_t passIdx = 0; passIdx < static_cast<uint32_t>(EnginePass::Count); passIdx++)
+			names.push_back(ToString(static_cast<EnginePass>(passIdx)));
+		return names;
+	}
+
+	Engine::Engine(EngineDesc const& desc)
+		: m_Desc(desc)
+		, m_ThreadPool(desc.ThreadCount)
+		, m_Profiler(GetEnginePassNames(), desc.ProfileHistory) {
+
+		GetStandardSamplePositions(desc.MSAASamples);
+		if (desc.FragmentCount == 0 || desc.FragmentCount > MAX_FRAGMENT_COUNT)
+			throw std::invalid_argument("FragmentCount must be in [1, MAX_FRAGMENT_COUNT]");
+		if (desc.MLABLayerCount == 0 || desc.MLABLayerCount > MAX_MLAB_LAYER_COUNT)
+			throw std::invalid_argument("MLABLayerCount must be in [1, MAX_MLAB_LAYER_COUNT]");
+		if (desc.ATNodeCount == 0 || desc.ATNodeCount > MAX_AT_NODE_COUNT)
+			throw std::invalid_argument("ATNodeCount must be in [1, MAX_AT_NODE_COUNT]");
+		if (!(desc.ResolveTransmittanceEpsilon >= 0.0f && desc.ResolveTransmittanceEpsilon <= 1.0f))
+			throw std::invalid_argument("ResolveTransmittanceEpsilon must be in [0, 1]");
+
+		m_ResolveInstructionSet = SelectInstructionSet(desc.ResolveInstructionSet);
+		m_pResolveGroup = GetResolveGroupFunction(m_ResolveInstructionSet);
+		m_pResolveArrayGroup = GetResolveArrayGroupFunction(m_ResolveInstructionSet);
+
+		ResizeRenderTargets(desc.Width, desc.Height);
+	}
+
+	auto Engine::ResizeRenderTargets(uint32_t width, uint32_t height) -> void {
+		m_Desc.Width = width;
+		m_Desc.Height = height;
+
+		auto const pixelCount = width * height;
+		m_ColorBufferMSAA.assign(pixelCount * m_Desc.MSAASamples, 0);
+		m_DepthBufferMSAA.assign(pixelCount * m_Desc.MSAASamples, 1.0f);
+
+		m_BackBuffer.Width = width;
+		m_BackBuffer.Height = height;
+		m_BackBuffer.Texels.assign(pixelCount, 0);
+
+		m_HeadAddressing = HeadAddressing(m_Desc.HeadPointers, width, height);
+		m_NodePoolStatistics = {};
+		if (m_Desc.Method != TransparencyMethod::LinkedList) {
+			if (m_Desc.Method == TransparencyMethod::WeightedBlended)
+				m_WeightedBufferMSAA.assign(pixelCount * m_Desc.MSAASamples, WeightedSample{});
+			else if (m_Desc.Method == TransparencyMethod::MomentBased)
+				m_MomentBufferMSAA.assign(pixelCount * m_Desc.MSAASamples, MomentSample{});
+			else if (m_Desc.Method == TransparencyMethod::DepthPeeling)
+				m_PeelBufferMSAA.assign(pixelCount * m_Desc.MSAASamples, PeelSample{});
+			else if (m_Desc.Method == TransparencyMethod::PrefixSum) {
+				m_FragmentAddressing = HeadAddressing(HeadLayout::Linear, width, height);
+				m_FragmentCounts.assign(pixelCount, 0);
+				m_FragmentOffsets.assign(pixelCount + 1, 0);
+				m_FragmentArray.clear();
+			}
+			else if (m_Desc.Method == TransparencyMethod::AdaptiveTransparency)
+				m_AdaptiveBufferMSAA.assign(pixelCount * m_Desc.MSAASamples * m_Desc.ATNodeCount, EMPTY_AT_NODE);
+			else
+				m_LayerBufferMSAA.assign(pixelCount * m_Desc.MSAASamples * m_Desc.MLABLayerCount, EMPTY_LAYER);
+			m_pHeadPointers.reset();
+			m_pPoolSizer.reset();
+			m_NodeCapacity = 0;
+			m_LinkedList.Allocate(0);
+			return;
+		}
+
+		// Compact encodings narrow the next index, so the pool may hold fewer nodes than the layer count asks for.
+		m_NodeCapacity = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(pixelCount) * m_Desc.OITLayerCount, LIST_NODE_MAX_COUNT));
+		if (m_Desc.AdaptiveNodePool) {
+			auto poolDesc = m_Desc.NodePool;
+			auto const maxPoolBytes = uint64_t(LIST_NODE_MAX_COUNT) * LIST_NODE_SIZE;
+			poolDesc.MaxBytes = poolDesc.MaxBytes ? std::min(poolDesc.MaxBytes, maxPoolBytes) : maxPoolBytes;
+			m_pPoolSizer = std::make_unique<PoolSizer>(poolDesc, LIST_NODE_SIZE, m_NodeCapacity);
+			m_NodeCapacity = static_cast<uint32_t>(m_pPoolSizer->GetCapacity());
+		}
+		m_pHeadPointers = std::make_unique<std::atomic<uint32_t>[]>(m_HeadAddressing.GetSlotCount());
+		m_LinkedList.Allocate(m_NodeCapacity);
+		m_NodePoolStatistics.Capacity = m_NodeCapacity;
+
+		// Padding slots of partial tiles keep a count of zero.
+		if (m_Desc.CompactNodes) {
+			m_FragmentAddressing = HeadAddressing(HeadLayout::Tiled, width, height);
+			m_FragmentCounts.assign(m_FragmentAddressing.GetSlotCount(), 0);
+			m_FragmentOffsets.assign(m_FragmentAddressing.GetSlotCount() + 1, 0);
+			m_FragmentArray.clear();
+		}
+	}
+
+	auto Engine::RenderFrame(Scene const& scene) -> void {
+		auto const MeasurePass = [&](EnginePass passId, double& duration, auto&& pass) -> void {
+			auto const timeBegin = ProfilerClock::now();
+			pass();
+			duration = std::chrono::duration<double, std::milli>(ProfilerClock::now() - timeBegin).count();
+			m_Profiler.RecordCPU(static_cast<uint32_t>(passId), duration);
+		};
+
+		auto const frameBegin = ProfilerClock::now();
+		MeasurePass(EnginePass::Clear,       m_PassTimings.Clear,       [&] { ClearTargets(); });
+		MeasurePass(EnginePass::Opaque,      m_PassTimings.Opaque,      [&] { DrawOpaque(scene); });
+		MeasurePass(EnginePass::Transparent, m_PassTimings.Transparent, [&] { DrawTransparent(scene); });
+		MeasurePass(EnginePass::ResolveMSAA, m_PassTimings.ResolveMSAA, [&] { ResolveMSAA(); });
+		MeasurePass(EnginePass::ResolveOIT,  m_PassTimings.ResolveOIT,  [&] {
+			if (m_Desc.Method == TransparencyMethod::WeightedBlended)
+				CompositeWeightedBlended();
+			else if (m_Desc.Method == TransparencyMethod::MultiLayerAlphaBlending)
+				CompositeMultiLayer();
+			else if (m_Desc.Method == TransparencyMethod::AdaptiveTransparency)
+				CompositeAdaptive();
+			else if (m_Desc.Method == TransparencyMethod::MomentBased)
+				CompositeMoments();
+			else if (m_Desc.Method == TransparencyMethod::DepthPeeling)
+				CompositeDepthPeeling();
+			else
+				ResolveOIT();
+		});
+
+		if (m_pPoolSizer)
+			UpdateNodePool();
+		m_PassTimings.Frame = std::chrono::duration<double, std::milli>(ProfilerClock::now() - frameBegin).count();
+		m_Profiler.RecordCPU(static_cast<uint32_t>(EnginePass::Frame), m_PassTimings.Frame);
+	}
+
+	auto Engine::ClearTargets() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+		auto const layerCount = m_Desc.MLABLayerCount;
+		auto const nodeCount = m_Desc.ATNodeCount;
+		auto const isLinkedList = m_Desc.Method == TransparencyMethod::LinkedList;
+		auto const isWeightedBlended = m_Desc.Method == TransparencyMethod::WeightedBlended;
+		auto const isMultiLayer = m_Desc.Method == TransparencyMethod::MultiLayerAlphaBlending;
+		auto const isAdaptive = m_Desc.Method == TransparencyMethod::AdaptiveTransparency;
+		auto const isMomentBased = m_Desc.Method == TransparencyMethod::MomentBased;
+		auto const isPrefixSum = m_Desc.Method == TransparencyMethod::PrefixSum;
+
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const pixelIdx = y * width + x;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					m_ColorBufferMSAA[pixelIdx * samples + sampleIdx] = 0;
+					m_DepthBufferMSAA[pixelIdx * samples + sampleIdx] = 1.0f;
+					if (isWeightedBlended)
+						m_WeightedBufferMSAA[pixelIdx * samples + sampleIdx] = WeightedSample{};
+					if (isMomentBased)
+						m_MomentBufferMSAA[pixelIdx * samples + sampleIdx] = MomentSample{};
+					if (isMultiLayer)
+						std::fill_n(&m_LayerBufferMSAA[(pixelIdx * samples + sampleIdx) * layerCount], layerCount, EMPTY_LAYER);
+					if (isAdaptive)
+						std::fill_n(&m_AdaptiveBufferMSAA[(pixelIdx * samples + sampleIdx) * nodeCount], nodeCount, EMPTY_AT_NODE);
+				}
+				if (isLinkedList)
+					m_pHeadPointers[m_HeadAddressing.GetSlot(x, y)].store(INVALID_NODE_INDEX, std::memory_order_relaxed);
+				if (isPrefixSum)
+					m_FragmentCounts[pixelIdx] = 0;
+			}
+		});
+
+		if (isLinkedList)
+			m_ListBuilder.Reset(m_pHeadPointers.get(), m_HeadAddressing, &m_LinkedList, m_NodeCapacity, m_ThreadPool.GetThreadCount(), m_Desc.NodeChunkSize, m_Desc.Allocation);
+	}
+
+	auto Engine::DrawOpaque(Scene const& scene) -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		m_Rasterizer.Setup(scene.OpaqueTriangles, CullMode::Back, m_Desc.Width, m_Desc.Height, samples);
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+				auto const texel = StoreTexel(fragment.Color);
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					auto& depth = m_DepthBufferMSAA[pixelIdx * samples + sampleIdx];
+					if ((fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < depth) {
+						depth = fragment.SampleDepths[sampleIdx];
+						m_ColorBufferMSAA[pixelIdx * samples + sampleIdx] = texel;
+					}
+				}
+			});
+		});
+	}
+
+	auto Engine::DrawTransparent(Scene const& scene) -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		m_Rasterizer.Setup(scene.TransparentTriangles, CullMode::None, m_Desc.Width, m_Desc.Height, samples);
+		if (m_Desc.Method == TransparencyMethod::WeightedBlended)
+			return DrawTransparentWeightedBlended();
+		if (m_Desc.Method == TransparencyMethod::MultiLayerAlphaBlending)
+			return DrawTransparentMultiLayer();
+		if (m_Desc.Method == TransparencyMethod::AdaptiveTransparency)
+			return DrawTransparentAdaptive();
+		if (m_Desc.Method == TransparencyMethod::MomentBased)
+			return DrawTransparentMoments();
+		if (m_Desc.Method == TransparencyMethod::DepthPeeling)
+			return DrawTransparentPeeling();
+		if (m_Desc.Method == TransparencyMethod::PrefixSum)
+			return DrawTransparentPrefixSum();
+
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t threadIdx) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+
+				// [earlydepthstencil]: the shader runs only if a covered sample passes the depth test, while
+				// SV_Coverage still reports the rasterizer coverage.
+				auto isVisible = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					isVisible |= (fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx];
+
+				if (!isVisible)
+					return;
+
+				ListNode node;
+				node.Color = PackColor(fragment.Color);
+				node.Depth = AsUint(fragment.Depth);
+				node.Next = INVALID_NODE_INDEX;
+				node.Coverage = fragment.Coverage;
+				m_ListBuilder.Append(threadIdx, fragment.X, fragment.Y, node);
+			});
+		});
+
+		auto const statistics = m_ListBuilder.GetStatistics();
+		m_TransparentFragmentCount = statistics.Fragments;
+		m_NodePoolStatistics.CounterValue = statistics.Fragments;
+		m_NodePoolStatistics.StoredFragments = statistics.Fragments - statistics.DroppedFragments;
+		m_NodePoolStatistics.DroppedFragments = statistics.DroppedFragments;
+		m_NodePoolStatistics.PeakCounterValue = std::max(m_NodePoolStatistics.PeakCounterValue, statistics.Fragments);
+	}
+
+	auto Engine::DrawTransparentWeightedBlended() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		// Plain render target writes: every covered sample runs its own depth test and no fragment is stored.
+		m_ThreadFragmentCounts.assign(m_ThreadPool.GetThreadCount(), ThreadFragmentCount{});
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t threadIdx) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+				auto const weighted = GetWeightedFragment(fragment.Color, fragment.Depth);
+				auto isVisible = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					if ((fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx]) {
+						AccumulateWeighted(m_WeightedBufferMSAA[pixelIdx * samples + sampleIdx], weighted);
+						isVisible = true;
+					}
+				}
+				m_ThreadFragmentCounts[threadIdx].Fragments += isVisible;
+			});
+		});
+		SumFragmentCounts();
+	}
+
+	auto Engine::DrawTransparentMultiLayer() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+		auto const layerCount = m_Desc.MLABLayerCount;
+
+		// Same [earlydepthstencil] and SV_Coverage rules as the linked lists. Every pixel belongs to one rasterizer
+		// tile, so its layers are only ever touched by one thread, in submission order like the ROV of PSInsert.
+		m_ThreadFragmentCounts.assign(m_ThreadPool.GetThreadCount(), ThreadFragmentCount{});
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t threadIdx) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+
+				auto isVisible = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					isVisible |= (fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx];
+
+				if (!isVisible)
+					return;
+
+				ListSubNode layer;
+				layer.Depth = fragment.Depth;
+				layer.Color = PackColor(fragment.Color);
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					if (fragment.Coverage & (1u << sampleIdx))
+						InsertLayer(&m_LayerBufferMSAA[(pixelIdx * samples + sampleIdx) * layerCount], layerCount, layer);
+				m_ThreadFragmentCounts[threadIdx].Fragments++;
+			});
+		});
+		SumFragmentCounts();
+	}
+
+	auto Engine::DrawTransparentAdaptive() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+		auto const nodeCount = m_Desc.ATNodeCount;
+
+		// Same per-pixel ordering argument as DrawTransparentMultiLayer. The color goes through PackColor like the
+		// list nodes, so both methods see the same 8-bit fragments.
+		m_ThreadFragmentCounts.assign(m_ThreadPool.GetThreadCount(), ThreadFragmentCount{});
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t threadIdx) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+
+				auto isVisible = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					isVisible |= (fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx];
+
+				if (!isVisible)
+					return;
+
+				auto const color = UnpackColor(PackColor(fragment.Color));
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					if (fragment.Coverage & (1u << sampleIdx))
+						InsertAdaptiveNode(&m_AdaptiveBufferMSAA[(pixelIdx * samples + sampleIdx) * nodeCount], nodeCount, fragment.Depth, color);
+				m_ThreadFragmentCounts[threadIdx].Fragments++;
+			});
+		});
+		SumFragmentCounts();
+	}
+
+	auto Engine::DrawTransparentMoments() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		// Both passes are plain render target writes at sample frequency (SV_SampleIndex), so every covered sample
+		// runs its own depth test with its own depth. The second pass may only start once every moment is summed.
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					if ((fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx])
+						AccumulateMoments(m_MomentBufferMSAA[pixelIdx * samples + sampleIdx], fragment.SampleDepths[sampleIdx], fragment.Color.A);
+			});
+		});
+
+		m_ThreadFragmentCounts.assign(m_ThreadPool.GetThreadCount(), ThreadFragmentCount{});
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t threadIdx) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+				auto isVisible = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					if ((fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx]) {
+						auto& sample = m_MomentBufferMSAA[pixelIdx * samples + sampleIdx];
+						AccumulateMomentColor(sample, fragment.Color, ComputeMomentTransmittance(sample, fragment.SampleDepths[sampleIdx]));
+						isVisible = true;
+					}
+				}
+				m_ThreadFragmentCounts[threadIdx].Fragments += isVisible;
+			});
+		});
+		SumFragmentCounts();
+	}
+
+	auto Engine::DrawTransparentPeeling() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		// The layers need the resolved opaque color underneath, so the peeling itself waits for the ResolveOIT pass.
+		m_ThreadFragmentCounts.assign(m_ThreadPool.GetThreadCount(), ThreadFragmentCount{});
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t threadIdx) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+				auto isVisible = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					isVisible |= (fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx];
+				m_ThreadFragmentCounts[threadIdx].Fragments += isVisible;
+			});
+		});
+		SumFragmentCounts();
+	}
+
+	auto Engine::DrawTransparentPrefixSum() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		// Same [earlydepthstencil] and SV_Coverage rules as the lists, so both passes see the same fragments. Every
+		// pixel belongs to one rasterizer tile, so its count is only ever touched by one thread and needs no atomics.
+		auto const IsVisible = [&](Fragment const& fragment, uint32_t pixelIdx) -> bool {
+			auto isVisible = false;
+			for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+				isVisible |= (fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx];
+			return isVisible;
+		};
+
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+				m_FragmentCounts[pixelIdx] += IsVisible(fragment, pixelIdx);
+			});
+		});
+
+		auto const total = ExclusiveScan(m_ThreadPool, m_FragmentCounts.data(), m_FragmentOffsets.data(), static_cast<uint32_t>(m_FragmentCounts.size()));
+		m_FragmentArray.resize(total);
+
+		// The counts run back down to zero as the ranges fill from their end, which leaves every range newest first
+		// like a list and keeps the stable sort of the resolve bit for bit the same.
+		m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t) -> void {
+			m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+				auto const pixelIdx = fragment.Y * width + fragment.X;
+				if (!IsVisible(fragment, pixelIdx))
+					return;
+
+				auto& fragmentOut = m_FragmentArray[m_FragmentOffsets[pixelIdx] + --m_FragmentCounts[pixelIdx]];
+				fragmentOut.Depth = fragment.Depth;
+				fragmentOut.Color = PackColor(fragment.Color);
+				fragmentOut.Coverage = fragment.Coverage;
+			});
+		});
+
+		m_TransparentFragmentCount = total;
+		m_NodePoolStatistics.Capacity = total;
+		m_NodePoolStatistics.CounterValue = total;
+		m_NodePoolStatistics.StoredFragments = total;
+		m_NodePoolStatistics.PeakCounterValue = std::max<uint64_t>(m_NodePoolStatistics.PeakCounterValue, total);
+	}
+
+	auto Engine::SumFragmentCounts() -> void {
+		m_TransparentFragmentCount = 0;
+		for (auto const& thread : m_ThreadFragmentCounts)
+			m_TransparentFragmentCount += thread.Fragments;
+	}
+
+	auto Engine::ResolveMSAA() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const pixelIdx = y * width + x;
+				Color4 color = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					color = color + LoadTexel(m_ColorBufferMSAA[pixelIdx * samples + sampleIdx]);
+				m_BackBuffer.Texels[pixelIdx] = StoreTexel(color / static_cast<float>(samples));
+			}
+		});
+	}
+
+	auto Engine::CompactNodes() -> void {
+		auto const tileCountX = (m_Desc.Width + RESOLVE_GROUP_SIZE - 1) / RESOLVE_GROUP_SIZE;
+		auto const ForEachTilePixel = [&](uint32_t tileIdx, auto&& function) -> void {
+			auto const minX = (tileIdx % tileCountX) * RESOLVE_GROUP_SIZE;
+			auto const minY = (tileIdx / tileCountX) * RESOLVE_GROUP_SIZE;
+			for (auto y = minY; y < std::min(minY + RESOLVE_GROUP_SIZE, m_Desc.Height); y++)
+				for (auto x = minX; x < std::min(minX + RESOLVE_GROUP_SIZE, m_Desc.Width); x++)
+					function(m_pHeadPointers[m_HeadAddressing.GetSlot(x, y)].load(std::memory_order_relaxed), m_FragmentAddressing.GetSlot(x, y));
+		};
+
+		// Every node is copied, the per-sample resolve may look past the first FragmentCount of a list.
+		m_ThreadPool.ParallelFor(m_FragmentAddressing.GetTileCount(), [&](uint32_t tileIdx, uint32_t) -> void {
+			ForEachTilePixel(tileIdx, [&](uint32_t nodeHead, uint32_t slot) -> void {
+				uint32_t count = 0;
+				for (auto nodeIdx = nodeHead; nodeIdx != INVALID_NODE_INDEX; nodeIdx = m_LinkedList.LoadLink(nodeIdx).Next)
+					count++;
+				m_FragmentCounts[slot] = count;
+			});
+		});
+
+		auto const total = ExclusiveScan(m_ThreadPool, m_FragmentCounts.data(), m_FragmentOffsets.data(), static_cast<uint32_t>(m_FragmentCounts.size()));
+		m_FragmentArray.resize(total);
+
+		// List order, newest first, so the resolve sees the nodes in the order it would have walked them.
+		m_ThreadPool.ParallelFor(m_FragmentAddressing.GetTileCount(), [&](uint32_t tileIdx, uint32_t) -> void {
+			ForEachTilePixel(tileIdx, [&](uint32_t nodeHead, uint32_t slot) -> void {
+				auto fragmentIdx = m_FragmentOffsets[slot];
+				for (auto nodeIdx = nodeHead; nodeIdx != INVALID_NODE_INDEX;) {
+					auto const node = m_LinkedList.LoadPayload(nodeIdx, m_LinkedList.LoadLink(nodeIdx));
+					m_FragmentArray[fragmentIdx++] = ListSubNodeMS{ AsFloat(node.Depth), node.Color, node.Coverage };
+					nodeIdx = node.Next;
+				}
+			});
+		});
+	}
+
+	auto Engine::ResolveOIT() -> void {
+		auto const threadGroupsX = (m_Desc.Width + RESOLVE_GROUP_SIZE - 1) / RESOLVE_GROUP_SIZE;
+		auto const threadGroupsY = (m_Desc.Height + RESOLVE_GROUP_SIZE - 1) / RESOLVE_GROUP_SIZE;
+
+		ResolveContext context;
+		context.pHeadPointers = m_pHeadPointers.get();
+		context.Heads = m_HeadAddressing;
+		context.pLinkedList = &m_LinkedList;
+		context.pBackBuffer = m_BackBuffer.Texels.data();
+		context.Width = m_Desc.Width;
+		context.Height = m_Desc.Height;
+		context.MSAASamples = m_Desc.MSAASamples;
+		context.FragmentCount = m_Desc.FragmentCount;
+		context.Mode = m_Desc.Resolve;
+		context.UseSortingNetworks = m_Desc.ResolveSortingNetworks;
+		context.TransmittanceEpsilon = m_Desc.ResolveTransmittanceEpsilon;
+
+		auto pResolveGroup = m_pResolveGroup;
+		auto const isCompacted = m_Desc.Method == TransparencyMethod::LinkedList && m_Desc.CompactNodes;
+		if (isCompacted)
+			CompactNodes();
+		if (m_Desc.Method == TransparencyMethod::PrefixSum || isCompacted) {
+			context.FragmentSlots = m_FragmentAddressing;
+			context.pFragmentOffsets = m_FragmentOffsets.data();
+			context.pFragments = m_FragmentArray.data();
+			pResolveGroup = m_pResolveArrayGroup;
+		}
+
+		m_ThreadResolveStatistics.assign(m_ThreadPool.GetThreadCount(), ThreadResolveStatistics{});
+		m_ThreadPool.ParallelFor(threadGroupsX * threadGroupsY, [&](uint32_t groupIdx, uint32_t threadIdx) -> void {
+			pResolveGroup(context, (groupIdx % threadGroupsX) * RESOLVE_GROUP_SIZE, (groupIdx / threadGroupsX) * RESOLVE_GROUP_SIZE, m_ThreadResolveStatistics[threadIdx].Statistics);
+		});
+
+		m_ResolveStatistics = {};
+		for (auto const& thread : m_ThreadResolveStatistics) {
+			m_ResolveStatistics.ResolvedPixels += thread.Statistics.ResolvedPixels;
+			m_ResolveStatistics.NodesFetched += thread.Statistics.NodesFetched;
+		}
+	}
+
+	auto Engine::CompositeWeightedBlended() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		m_ThreadResolveStatistics.assign(m_ThreadPool.GetThreadCount(), ThreadResolveStatistics{});
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t threadIdx) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const pixelIdx = y * width + x;
+				auto const pSamples = &m_WeightedBufferMSAA[pixelIdx * samples];
+
+				// Untouched pixels keep the back buffer bit for bit, like the empty lists of CSMain.
+				auto isCovered = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					isCovered |= pSamples[sampleIdx].Revealage < 1.0f;
+				if (!isCovered)
+					continue;
+
+				auto const background = LoadTexel(m_BackBuffer.Texels[pixelIdx]);
+				Color4 color = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					color = color + CompositeWeighted(pSamples[sampleIdx], background);
+				m_BackBuffer.Texels[pixelIdx] = StoreTexel(color / static_cast<float>(samples));
+				m_ThreadResolveStatistics[threadIdx].Statistics.ResolvedPixels++;
+			}
+		});
+
+		m_ResolveStatistics = {};
+		for (auto const& thread : m_ThreadResolveStatistics)
+			m_ResolveStatistics.ResolvedPixels += thread.Statistics.ResolvedPixels;
+	}
+
+	auto Engine::CompositeMoments() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		m_ThreadResolveStatistics.assign(m_ThreadPool.GetThreadCount(), ThreadResolveStatistics{});
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t threadIdx) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const pixelIdx = y * width + x;
+				auto const pSamples = &m_MomentBufferMSAA[pixelIdx * samples];
+
+				auto isCovered = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					isCovered |= pSamples[sampleIdx].Moment0 > 0.0f;
+				if (!isCovered)
+					continue;
+
+				auto const background = LoadTexel(m_BackBuffer.Texels[pixelIdx]);
+				Color4 color = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					color = color + OIT::CompositeMoments(pSamples[sampleIdx], background);
+				m_BackBuffer.Texels[pixelIdx] = StoreTexel(color / static_cast<float>(samples));
+				m_ThreadResolveStatistics[threadIdx].Statistics.ResolvedPixels++;
+			}
+		});
+
+		m_ResolveStatistics = {};
+		for (auto const& thread : m_ThreadResolveStatistics)
+			m_ResolveStatistics.ResolvedPixels += thread.Statistics.ResolvedPixels;
+	}
+
+	auto Engine::CompositeDepthPeeling() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const backBuffer = LoadTexel(m_BackBuffer.Texels[y * width + x]);
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					auto& sample = m_PeelBufferMSAA[(y * width + x) * samples + sampleIdx];
+					sample = PeelSample{};
+					sample.Color = backBuffer;
+				}
+			}
+		});
+
+		// Same [earlydepthstencil] and SV_Coverage rules as the lists: a visible fragment is a layer of every covered
+		// sample. The rasterizer tiles keep each pixel on one thread within a pass.
+		m_ThreadResolveStatistics.assign(m_ThreadPool.GetThreadCount(), ThreadResolveStatistics{});
+		m_PeelPassCount = 0;
+		for (auto isPeeled = true; isPeeled; m_PeelPassCount++) {
+			m_ThreadPool.ParallelFor(m_Rasterizer.GetTileCount(), [&](uint32_t tileIdx, uint32_t) -> void {
+				m_Rasterizer.RasterizeTile(tileIdx, [&](Fragment const& fragment) -> void {
+					auto const pixelIdx = fragment.Y * width + fragment.X;
+					auto isVisible = false;
+					for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+						isVisible |= (fragment.Coverage & (1u << sampleIdx)) && fragment.SampleDepths[sampleIdx] < m_DepthBufferMSAA[pixelIdx * samples + sampleIdx];
+
+					if (!isVisible)
+						return;
+
+					PeelKey const key = { fragment.Depth, fragment.Primitive };
+					auto const color = PackColor(fragment.Color);
+					for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+						if (fragment.Coverage & (1u << sampleIdx))
+							PeelFragment(m_PeelBufferMSAA[pixelIdx * samples + sampleIdx], key, color);
+				});
+			});
+
+			std::atomic<bool> isAnyPeeled = false;
+			m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t threadIdx) -> void {
+				uint64_t layers = 0;
+				for (uint32_t sampleIdx = 0; sampleIdx < width * samples; sampleIdx++)
+					layers += BlendPeeledLayer(m_PeelBufferMSAA[y * width * samples + sampleIdx]);
+				m_ThreadResolveStatistics[threadIdx].Statistics.NodesFetched += layers;
+				if (layers != 0)
+					isAnyPeeled.store(true, std::memory_order_relaxed);
+			});
+			isPeeled = isAnyPeeled.load(std::memory_order_relaxed);
+		}
+
+		// Pixels without any layer keep the back buffer bit for bit, like the empty lists of CSMain.
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t threadIdx) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const pixelIdx = y * width + x;
+				auto const pSamples = &m_PeelBufferMSAA[pixelIdx * samples];
+
+				auto isCovered = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					isCovered |= pSamples[sampleIdx].Peeled.Depth != PEEL_KEY_BACK.Depth;
+				if (!isCovered)
+					continue;
+
+				Color4 resolveBuffer = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					resolveBuffer = resolveBuffer + pSamples[sampleIdx].Color;
+				m_BackBuffer.Texels[pixelIdx] = StoreTexel(resolveBuffer / static_cast<float>(samples));
+				m_ThreadResolveStatistics[threadIdx].Statistics.ResolvedPixels++;
+			}
+		});
+
+		m_ResolveStatistics = {};
+		for (auto const& thread : m_ThreadResolveStatistics) {
+			m_ResolveStatistics.ResolvedPixels += thread.Statistics.ResolvedPixels;
+			m_ResolveStatistics.NodesFetched += thread.Statistics.NodesFetched;
+		}
+	}
+
+	auto Engine::CompositeMultiLayer() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+		auto const layerCount = m_Desc.MLABLayerCount;
+
+		m_ThreadResolveStatistics.assign(m_ThreadPool.GetThreadCount(), ThreadResolveStatistics{});
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t threadIdx) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const pixelIdx = y * width + x;
+				auto const pLayers = &m_LayerBufferMSAA[pixelIdx * samples * layerCount];
+
+				uint32_t counts[MAX_MSAA_SAMPLES];
+				auto isCovered = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					counts[sampleIdx] = GetLayerCount(&pLayers[sampleIdx * layerCount], layerCount);
+					isCovered |= counts[sampleIdx] != 0;
+				}
+				if (!isCovered)
+					continue;
+
+				auto const backBuffer = LoadTexel(m_BackBuffer.Texels[pixelIdx]);
+				Color4 resolveBuffer = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					auto dstPixelColor = backBuffer;
+					for (uint32_t layerIdx = 0; layerIdx < counts[sampleIdx]; layerIdx++)
+						dstPixelColor = BlendListSubNode(dstPixelColor, pLayers[sampleIdx * layerCount + layerIdx]);
+					resolveBuffer = resolveBuffer + dstPixelColor;
+				}
+				m_BackBuffer.Texels[pixelIdx] = StoreTexel(resolveBuffer / static_cast<float>(samples));
+
+				auto& statistics = m_ThreadResolveStatistics[threadIdx].Statistics;
+				statistics.ResolvedPixels++;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					statistics.NodesFetched += counts[sampleIdx];
+			}
+		});
+
+		m_ResolveStatistics = {};
+		for (auto const& thread : m_ThreadResolveStatistics) {
+			m_ResolveStatistics.ResolvedPixels += thread.Statistics.ResolvedPixels;
+			m_ResolveStatistics.NodesFetched += thread.Statistics.NodesFetched;
+		}
+	}
+
+	auto Engine::CompositeAdaptive() -> void {
+		auto const width = m_Desc.Width;
+		auto const samples = m_Desc.MSAASamples;
+		auto const nodeCount = m_Desc.ATNodeCount;
+
+		m_ThreadResolveStatistics.assign(m_ThreadPool.GetThreadCount(), ThreadResolveStatistics{});
+		m_ThreadPool.ParallelFor(m_Desc.Height, [&](uint32_t y, uint32_t threadIdx) -> void {
+			for (uint32_t x = 0; x < width; x++) {
+				auto const pixelIdx = y * width + x;
+				auto const pNodes = &m_AdaptiveBufferMSAA[pixelIdx * samples * nodeCount];
+
+				uint32_t counts[MAX_MSAA_SAMPLES];
+				auto isCovered = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++) {
+					counts[sampleIdx] = GetAdaptiveNodeCount(&pNodes[sampleIdx * nodeCount], nodeCount);
+					isCovered |= counts[sampleIdx] != 0;
+				}
+				if (!isCovered)
+					continue;
+
+				auto const backBuffer = LoadTexel(m_BackBuffer.Texels[pixelIdx]);
+				Color4 resolveBuffer = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					resolveBuffer = resolveBuffer + OIT::CompositeAdaptive(&pNodes[sampleIdx * nodeCount], counts[sampleIdx], backBuffer);
+				m_BackBuffer.Texels[pixelIdx] = StoreTexel(resolveBuffer / static_cast<float>(samples));
+
+				auto& statistics = m_ThreadResolveStatistics[threadIdx].Statistics;
+				statistics.ResolvedPixels++;
+				for (uint32_t sampleIdx = 0; sampleIdx < samples; sampleIdx++)
+					statistics.NodesFetched += counts[sampleIdx];
+			}
+		});
+
+		m_ResolveStatistics = {};
+		for (auto const& thread : m_ThreadResolveStatistics) {
+			m_ResolveStatistics.ResolvedPixels += thread.Statistics.ResolvedPixels;
+			m_ResolveStatistics.NodesFetched += thread.Statistics.NodesFetched;
+		}
+	}
+
+	auto Engine::UpdateNodePool() -> void {
+		// The list buffer is dead after the resolve, so a new capacity can be applied before the next frame.
+		auto const capacity = static_cast<uint32_t>(m_pPoolSizer->Update(m_NodePoolStatistics.CounterValue));
+		if (capacity != m_NodeCapacity) {
+			m_NodeCapacity = capacity;
+			m_LinkedList.Allocate(m_NodeCapacity);
+			m_NodePoolStatistics.Capacity = m_NodeCapacity;
+			m_NodePoolStatistics.PeakCounterValue = m_NodePoolStatistics.CounterValue;
+			m_NodePoolStatistics.ResizeCount++;
+		}
+	}
+
+	auto Engine::GetMemoryUsage() const -> uint64_t {
+		return m_ColorBufferMSAA.size() * sizeof(uint32_t)
+			+ m_DepthBufferMSAA.size() * sizeof(float)
+			+ m_BackBuffer.Texels.size() * sizeof(uint32_t)
+			+ (m_pHeadPointers ? uint64_t(m_HeadAddressing.GetSlotCount()) * sizeof(uint32_t) : 0)
+			+ uint64_t(m_NodeCapacity) * LIST_NODE_SIZE
+			+ m_WeightedBufferMSAA.size() * WEIGHTED_SAMPLE_SIZE
+			+ m_MomentBufferMSAA.size() * MOMENT_SAMPLE_SIZE
+			+ m_PeelBufferMSAA.size() * sizeof(PeelSample)
+			+ (m_FragmentCounts.size() + m_FragmentOffsets.size()) * sizeof(uint32_t)
+			+ m_FragmentArray.size() * sizeof(ListSubNodeMS)
+			+ m_LayerBufferMSAA.size() * sizeof(ListSubNode)
+			+ m_AdaptiveBufferMSAA.size() * sizeof(AdaptiveNode);
+	}
+
+	auto RenderReference(EngineDesc const& desc, Scene const& scene) -> ReferenceFrame {
+		auto referenceDesc = desc;
+		referenceDesc.Method = TransparencyMethod::DepthPeeling;
+		referenceDesc.ProfileHistory = 1;
+
+		Engine reference(referenceDesc);
+		reference.RenderFrame(scene);
+
+		ReferenceFrame result;
+		result.BackBuffer = reference.GetBackBuffer();
+		result.FrameMs = reference.GetPassTimings().Frame;
+		result.PeelPassCount = reference.GetPeelPassCount();
+		return result;
+	}
+
+	auto Engine::MeasureNodeLocality() const -> NodeLocalityStatistics {
+		// Lines are counted from the start of each array, as if it was line aligned, so the result does not depend
+		// on where the allocator placed it. The array index in the top bits keeps the arrays apart.
+		auto const GetCacheLine = [](uintptr_t arrayIdx, void const* pBase, void const* pAddress) -> uintptr_t {
+			return (arrayIdx << 56) | ((reinterpret_cast<uintptr_t>(pAddress) - reinterpret_cast<uintptr_t>(pBase)) / CACHE_LINE_SIZE);
+		};
+		if (!m_pHeadPointers)
+			return {};
+
+		auto const pHeadBase = m_pHeadPointers.get();
+		auto const pLinkBase = m_LinkedList.GetLinkAddress(0);
+		auto const pPayloadBase = m_LinkedList.GetPayloadAddress(0);
+
+		NodeLocalityStatistics result;
+		std::vector<uintptr_t> cacheLines;
+		for (uint32_t minY = 0; minY < m_Desc.Height; minY += RESOLVE_GROUP_SIZE) {
+			for (uint32_t minX = 0; minX < m_Desc.Width; minX += RESOLVE_GROUP_SIZE) {
+				cacheLines.clear();
+				auto isAnyList = false;
+				for (auto y = minY; y < std::min(minY + RESOLVE_GROUP_SIZE, m_Desc.Height); y++) {
+					for (auto x = minX; x < std::min(minX + RESOLVE_GROUP_SIZE, m_Desc.Width); x++) {
+						auto const& head = m_pHeadPointers[m_HeadAddressing.GetSlot(x, y)];
+						cacheLines.push_back(GetCacheLine(0, pHeadBase, &head));
+
+						uint32_t count = 0;
+						auto nodeIdx = head.load(std::memory_order_relaxed);
+						isAnyList |= nodeIdx != INVALID_NODE_INDEX;
+						while (nodeIdx != INVALID_NODE_INDEX && count < m_Desc.FragmentCount) {
+							cacheLines.push_back(GetCacheLine(1, pLinkBase, m_LinkedList.GetLinkAddress(nodeIdx)));
+							cacheLines.push_back(GetCacheLine(NODE_LAYOUT_SOA ? 2 : 1, pPayloadBase, m_LinkedList.GetPayloadAddress(nodeIdx)));
+							nodeIdx = m_LinkedList.LoadLink(nodeIdx).Next;
+							count++;
+						}
+						result.NodesWalked += count;
+					}
+				}
+
+				if (!isAnyList)
+					continue;
+
+				std::sort(cacheLines.begin(), cacheLines.end());
+				result.CacheLines += static_cast<uint64_t>(std::unique(cacheLines.begin(), cacheLines.end()) - cacheLines.begin());
+				result.Tiles++;
+			}
+		}
+		return result;
+	}
+
+	auto Engine::MeasureDepthComplexity() const -> DepthComplexity {
+		DepthComplexity result;
+		if (!m_pHeadPointers)
+			return result;
+
+		result.Width = m_Desc.Width;
+		result.Height = m_Desc.Height;
+		result.FragmentCount = m_Desc.FragmentCount;
+		result.NodeCounts.resize(size_t(m_Desc.Width) * m_Desc.Height);
+		for (uint32_t y = 0; y < m_Desc.Height; y++) {
+			for (uint32_t x = 0; x < m_Desc.Width; x++) {
+				auto const nodeHead = m_pHeadPointers[m_HeadAddressing.GetSlot(x, y)].load(std::memory_order_relaxed);
+
+				uint32_t count = 0;
+				for (auto nodeIdx = nodeHead; nodeIdx != INVALID_NODE_INDEX; nodeIdx = m_LinkedList.LoadLink(nodeIdx).Next)
+					count++;
+				result.NodeCounts[y * m_Desc.Width + x] = count;
+				if (count >= result.Histogram.size())
+					result.Histogram.resize(count + 1, 0);
+				result.Histogram[count]++;
+				result.Nodes += count;
+				result.MaxNodes = std::max(result.MaxNodes, count);
+				if (count == 0)
+					continue;
+
+				// The single traversal and the front to back resolve stop after FragmentCount nodes of any sample, the
+				// per-sample walk after FragmentCount nodes covering its own sample.
+				if (m_Desc.Resolve != ResolveMode::PerSample) {
+					result.NodesVisited += std::min(count, m_Desc.FragmentCount);
+					result.TruncatedPixels += count > m_Desc.FragmentCount;
+					continue;
+				}
+
+				auto isTruncated = false;
+				for (uint32_t sampleIdx = 0; sampleIdx < m_Desc.MSAASamples; sampleIdx++) {
+					uint32_t sampleCount = 0;
+					auto nodeIdx = nodeHead;
+					while (nodeIdx != INVALID_NODE_INDEX && sampleCount < m_Desc.FragmentCount) {
+						auto const link = m_LinkedList.LoadLink(nodeIdx);
+						sampleCount += (link.Coverage >> sampleIdx) & 1;
+						nodeIdx = link.Next;
+						result.NodesVisited++;
+					}
+					for (; nodeIdx != INVALID_NODE_INDEX && !isTruncated; nodeIdx = m_LinkedList.LoadLink(nodeIdx).Next)
+						isTruncated = (m_LinkedList.LoadLink(nodeIdx).Coverage >> sampleIdx) & 1;
+				}
+				result.TruncatedPixels += isTruncated;
+			}
+		}
+		return result;
+	}
+
+}
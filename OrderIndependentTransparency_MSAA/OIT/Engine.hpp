@@ -0,0 +1,280 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "AdaptiveTransparency.hpp"
+#include "Common.hpp"
+#include "DepthComplexity.hpp"
+#include "DepthPeeling.hpp"
+#include "ListBuilder.hpp"
+#include "MomentBased.hpp"
+#include "MultiLayerAlphaBlending.hpp"
+#include "PoolSizer.hpp"
+#include "PrefixSum.hpp"
+#include "Profiler.hpp"
+#include "Rasterizer.hpp"
+#include "Resolve.hpp"
+#include "ThreadPool.hpp"
+#include "TransparencyMethod.hpp"
+#include "WeightedBlended.hpp"
+
+namespace OIT {
+
+	// Same parameters as the constants at the top of main().
+	struct EngineDesc {
+		uint32_t Width          = 1920;
+		uint32_t Height         = 1280;
+		uint32_t MSAASamples    = 4;
+		uint32_t FragmentCount  = 32;
+		uint32_t OITLayerCount  = 8;
+		uint32_t ThreadCount    = 0;
+		uint32_t NodeChunkSize  = 64;
+		// The node pool, the head pointers and every option below that configures them only exist for LinkedList.
+		TransparencyMethod Method = TransparencyMethod::LinkedList;
+		// Layers per MSAA sample of TransparencyMethod::MultiLayerAlphaBlending.
+		uint32_t MLABLayerCount = 4;
+		// Visibility nodes per MSAA sample of TransparencyMethod::AdaptiveTransparency.
+		uint32_t ATNodeCount    = 4;
+		InstructionSet ResolveInstructionSet  = InstructionSet::Auto;
+		ResolveMode    Resolve                = ResolveMode::PerSample;
+		bool           ResolveSortingNetworks = false;
+		// Quality threshold of ResolveMode::FrontToBack, in [0, 1]. The default stays below half an 8-bit step, 0
+		// composites every node.
+		float          ResolveTransmittanceEpsilon = 1.0f / 512.0f;
+		// Size the node pool from observed counters instead of Width * Height * OITLayerCount, which then only
+		// seeds the first frame.
+		bool           AdaptiveNodePool       = false;
+		PoolSizerDesc  NodePool;
+		HeadLayout     HeadPointers           = HeadLayout::Linear;
+		NodeAllocation Allocation             = NodeAllocation::PerThread;
+		// Copy the lists into per-pixel arrays in resolve tile order before the resolve (CSCountLists and
+		// CSCompactLists of FragmentArrays.hlsl), which then reads them linearly like TransparencyMethod::PrefixSum.
+		// Part of the ResolveOIT pass.
+		bool           CompactNodes           = false;
+		// Frames of pass durations the profiler keeps.
+		uint32_t       ProfileHistory         = 1024;
+	};
+
+	// Order of the passes in the engine's profiler. Frame covers all of RenderFrame.
+	enum class EnginePass : uint32_t {
+		Clear,
+		Opaque,
+		Transparent,
+		ResolveMSAA,
+		ResolveOIT,
+		Frame,
+		Count
+	};
+
+	auto ToString(EnginePass pass) -> char const*;
+
+	// Wall-clock duration of every pass of the last RenderFrame, in milliseconds.
+	struct PassTimings {
+		double Clear           = 0.0;
+		double Opaque          = 0.0;
+		double Transparent     = 0.0;
+		double ResolveMSAA     = 0.0;
+		double ResolveOIT      = 0.0;
+		double Frame           = 0.0;
+	};
+
+	// Node pool usage of the transparent pass. CounterValue is what the shader's hidden UAV counter would hold: one
+	// increment per fragment, including the ones dropped because the pool was full. The peak covers every frame
+	// since the last resize, starting with the frame that triggered it, and is what the pool has to be sized for to
+	// never drop.
+	struct NodePoolStatistics {
+		uint64_t Capacity         = 0;
+		uint64_t CounterValue     = 0;
+		uint64_t StoredFragments  = 0;
+		uint64_t DroppedFragments = 0;
+		uint64_t PeakCounterValue = 0;
+		uint64_t ResizeCount      = 0;
+	};
+
+	// Memory footprint of the OIT resolve: distinct cache lines of head pointers and nodes that one CSMain thread
+	// group touches while walking its lists once. Counted from addresses, so it does not depend on the instruction
+	// set, the cache hierarchy or timing noise.
+	struct NodeLocalityStatistics {
+		uint64_t Tiles       = 0;
+		uint64_t NodesWalked = 0;
+		uint64_t CacheLines  = 0;
+	};
+
+	// Headless CPU implementation of the frame recorded in main(): opaque pass into the MSAA targets, transparent
+	// pass building the per-pixel linked lists (PSMain of TransparentGeometry.hlsl), MSAA resolve into the back
+	// buffer and the per-sample sort and blend (CSMain of ResolveGeometry.hlsl). Passes run tile-parallel.
+	//
+	// With TransparencyMethod::WeightedBlended the transparent pass accumulates into per-sample weighted sums
+	// instead (PSAccumulate of WeightedBlended.hlsl) and the ResolveOIT pass composites them (CSComposite). With
+	// TransparencyMethod::MultiLayerAlphaBlending it keeps MLABLayerCount sorted layers per sample (PSInsert of
+	// MultiLayerAlphaBlending.hlsl) and blends them like CSMain (CSComposite). With
+	// TransparencyMethod::AdaptiveTransparency it compresses the visibility function of every sample into ATNodeCount
+	// nodes (PSInsert of AdaptiveTransparency.hlsl) and sums them over the background (CSComposite). With
+	// TransparencyMethod::MomentBased the transparent pass rasterizes the geometry twice, accumulating power moments
+	// (PSGenerate of MomentBased.hlsl) and then the colors attenuated by the transmittance reconstructed from them
+	// (PSResolve), and the ResolveOIT pass normalizes the sum (CSComposite). TransparencyMethod::DepthPeeling has no
+	// GPU counterpart: its transparent pass only counts fragments and the ResolveOIT pass peels and blends one layer
+	// per rasterization of the transparent geometry until every sample is done. With TransparencyMethod::PrefixSum the
+	// transparent pass counts the fragments of every pixel (PSCount of FragmentArrays.hlsl), scans the counts into
+	// offsets (CSScanGroups, CSScanGroupSums, CSAddGroupOffsets) and rasterizes again to fill the ranges (PSFill), and
+	// the ResolveOIT pass sorts and blends them like CSMain (CSResolve). EngineDesc::CompactNodes builds the same arrays
+	// from the lists at the start of the ResolveOIT pass instead.
+	class Engine {
+	public:
+		explicit Engine(EngineDesc const& desc);
+
+		auto ResizeRenderTargets(uint32_t width, uint32_t height) -> void;
+
+		auto RenderFrame(Scene const& scene) -> void;
+
+		auto GetDesc() const -> EngineDesc const& { return m_Desc; }
+
+		auto GetBackBuffer() const -> Image const& { return m_BackBuffer; }
+
+		auto GetNodeCapacity() const -> uint32_t { return m_NodeCapacity; }
+
+		// Bytes held by the render targets, the head pointers, the node pool and the per-sample layers or visibility
+		// nodes. The weighted blended and moment targets are counted in their GPU formats.
+		auto GetMemoryUsage() const -> uint64_t;
+
+		// Transparent fragments that passed the early depth test in the last frame, whatever the method.
+		auto GetTransparentFragmentCount() const -> uint64_t { return m_TransparentFragmentCount; }
+
+		auto GetNodeCount() const -> uint32_t { return m_ListBuilder.GetClaimedNodeCount(); }
+
+		auto GetListBuilderStatistics() const -> ListBuilderStatistics { return m_ListBuilder.GetStatistics(); }
+
+		auto GetNodePoolStatistics() const -> NodePoolStatistics const& { return m_NodePoolStatistics; }
+
+		auto GetPassTimings() const -> PassTimings const& { return m_PassTimings; }
+
+		// CPU durations of the last EngineDesc::ProfileHistory frames, indexed by EnginePass.
+		auto GetProfiler() const -> PassProfiler const& { return m_Profiler; }
+
+		auto ResetProfiler() -> void { m_Profiler.Reset(); }
+
+		auto GetThreadCount() const -> uint32_t { return m_ThreadPool.GetThreadCount(); }
+
+		auto GetResolveInstructionSet() const -> InstructionSet { return m_ResolveInstructionSet; }
+
+		auto GetResolveStatistics() const -> ResolveStatistics const& { return m_ResolveStatistics; }
+
+		// Rasterizations of the transparent geometry in the ResolveOIT pass of the last DepthPeeling frame, one more
+		// than the deepest sample has layers.
+		auto GetPeelPassCount() const -> uint32_t { return m_PeelPassCount; }
+
+		// Walks the lists of the last frame tile by tile. Only counts tiles holding at least one list.
+		auto MeasureNodeLocality() const -> NodeLocalityStatistics;
+
+		// Walks the lists of the last frame pixel by pixel, like CSMain with the FragmentCount and resolve mode of the
+		// engine. Empty for methods without lists.
+		auto MeasureDepthComplexity() const -> DepthComplexity;
+
+	private:
+		// Per-thread accumulator of the resolve pass, padded so neighbouring workers do not share a cache line.
+		struct alignas(64) ThreadResolveStatistics {
+			ResolveStatistics Statistics;
+		};
+
+		struct alignas(64) ThreadFragmentCount {
+			uint64_t Fragments = 0;
+		};
+
+	private:
+		auto ClearTargets() -> void;
+
+		auto DrawOpaque(Scene const& scene) -> void;
+
+		auto DrawTransparent(Scene const& scene) -> void;
+
+		auto DrawTransparentWeightedBlended() -> void;
+
+		auto DrawTransparentMultiLayer() -> void;
+
+		auto DrawTransparentAdaptive() -> void;
+
+		auto DrawTransparentMoments() -> void;
+
+		auto DrawTransparentPeeling() -> void;
+
+		auto DrawTransparentPrefixSum() -> void;
+
+		auto SumFragmentCounts() -> void;
+
+		auto ResolveMSAA() -> void;
+
+		auto CompactNodes() -> void;
+
+		auto ResolveOIT() -> void;
+
+		auto CompositeWeightedBlended() -> void;
+
+		auto CompositeMultiLayer() -> void;
+
+		auto CompositeAdaptive() -> void;
+
+		auto CompositeMoments() -> void;
+
+		auto CompositeDepthPeeling() -> void;
+
+		auto UpdateNodePool() -> void;
+
+	private:
+		EngineDesc m_Desc;
+		ThreadPool m_ThreadPool;
+		Rasterizer m_Rasterizer;
+		ListBuilder m_ListBuilder;
+		PassTimings m_PassTimings;
+		PassProfiler m_Profiler;
+		NodePoolStatistics m_NodePoolStatistics;
+		InstructionSet       m_ResolveInstructionSet = InstructionSet::Scalar;
+		ResolveGroupFunction m_pResolveGroup = nullptr;
+		ResolveGroupFunction m_pResolveArrayGroup = nullptr;
+		ResolveStatistics    m_ResolveStatistics;
+
+		std::vector<ThreadResolveStatistics> m_ThreadResolveStatistics;
+		std::vector<ThreadFragmentCount>     m_ThreadFragmentCounts;
+		uint64_t                             m_TransparentFragmentCount = 0;
+
+		std::vector<uint32_t> m_ColorBufferMSAA;
+		std::vector<float>    m_DepthBufferMSAA;
+		Image                 m_BackBuffer;
+
+		std::vector<WeightedSample> m_WeightedBufferMSAA;
+		std::vector<ListSubNode>    m_LayerBufferMSAA;
+		std::vector<AdaptiveNode>   m_AdaptiveBufferMSAA;
+		std::vector<MomentSample>   m_MomentBufferMSAA;
+		std::vector<PeelSample>     m_PeelBufferMSAA;
+		uint32_t                    m_PeelPassCount = 0;
+
+		// Fragments per pixel of the count pass, the exclusive prefix sum over them with the total at the end, and
+		// the fragments themselves, resized to that total every frame. Row by row for PrefixSum, tile by tile for the
+		// node compaction.
+		HeadAddressing             m_FragmentAddressing;
+		std::vector<uint32_t>      m_FragmentCounts;
+		std::vector<uint32_t>      m_FragmentOffsets;
+		std::vector<ListSubNodeMS> m_FragmentArray;
+
+		HeadAddressing                           m_HeadAddressing;
+		std::unique_ptr<std::atomic<uint32_t>[]> m_pHeadPointers;
+		ListNodeBuffer                           m_LinkedList;
+		uint32_t                                 m_NodeCapacity = 0;
+		std::unique_ptr<PoolSizer>               m_pPoolSizer;
+	};
+
+	struct ReferenceFrame {
+		Image    BackBuffer;
+		// Duration of the reference frame and its number of peel passes.
+		double   FrameMs       = 0.0;
+		uint32_t PeelPassCount = 0;
+	};
+
+	// Depth peeling of scene at the size and sample count of desc: every fragment of every sample, blended in the
+	// order of the list resolve, which it matches bit for bit whenever FragmentCount truncated nothing. The
+	// reference of CompareImages.
+	auto RenderReference(EngineDesc const& desc, Scene const& scene) -> ReferenceFrame;
+
+}
@@ -0,0 +1,33 @@
+#include "HeadAddressing.hpp"
+
+#include <stdexcept>
+
+namespace OIT {
+
+	static_assert((RESOLVE_GROUP_SIZE & (RESOLVE_GROUP_SIZE - 1)) == 0, "The Z-order of a tile needs a power of two size");
+
+	HeadAddressing::HeadAddressing(HeadLayout layout, uint32_t width, uint32_t height)
+		: m_Layout(layout)
+		, m_Width(width)
+		, m_TileCountX((width + RESOLVE_GROUP_SIZE - 1) / RESOLVE_GROUP_SIZE)
+		, m_TileCountY((height + RESOLVE_GROUP_SIZE - 1) / RESOLVE_GROUP_SIZE) {
+
+		m_SlotCount = layout == HeadLayout::Linear ? width * height : GetTileCount() * RESOLVE_GROUP_SIZE * RESOLVE_GROUP_SIZE;
+	}
+
+	auto ToString(HeadLayout layout) -> char const* {
+		switch (layout) {
+			case HeadLayout::Linear: return "linear";
+			case HeadLayout::Tiled:  return "tiled";
+			default:                 return "unknown";
+		}
+	}
+
+	auto ParseHeadLayout(std::string const& name) -> HeadLayout {
+		for (auto const candidate : { HeadLayout::Linear, HeadLayout::Tiled })
+			if (name == ToString(candidate))
+				return candidate;
+		throw std::invalid_argument("Unknown head layout: " + name);
+	}
+
+}
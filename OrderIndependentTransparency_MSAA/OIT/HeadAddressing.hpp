@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	enum class HeadLayout {
+		// HeadPointersUAV as created by main(): one R32_UINT texel per pixel, row by row.
+		Linear,
+		// Every RESOLVE_GROUP_SIZE x RESOLVE_GROUP_SIZE tile is stored contiguously with its pixels in Z-order, so
+		// the heads of one resolve group share four cache lines instead of spanning eight rows.
+		Tiled
+	};
+
+	// Interleaves the low 16 bits of x and y, x in the even bits.
+	constexpr auto MortonEncode(uint32_t x, uint32_t y) -> uint32_t {
+		auto const Spread = [](uint32_t value) -> uint32_t {
+			value &= 0x0000FFFF;
+			value = (value | (value << 8)) & 0x00FF00FF;
+			value = (value | (value << 4)) & 0x0F0F0F0F;
+			value = (value | (value << 2)) & 0x33333333;
+			value = (value | (value << 1)) & 0x55555555;
+			return value;
+		};
+		return Spread(x) | (Spread(y) << 1);
+	}
+
+	// Z-order position of every pixel of a resolve tile, row by row.
+	struct TileMortonTable {
+		uint8_t Offsets[RESOLVE_GROUP_SIZE * RESOLVE_GROUP_SIZE] = {};
+
+		constexpr TileMortonTable() {
+			for (uint32_t y = 0; y < RESOLVE_GROUP_SIZE; y++)
+				for (uint32_t x = 0; x < RESOLVE_GROUP_SIZE; x++)
+					Offsets[y * RESOLVE_GROUP_SIZE + x] = static_cast<uint8_t>(MortonEncode(x, y));
+		}
+	};
+
+	inline constexpr TileMortonTable TILE_MORTON_TABLE;
+
+	// Maps pixels to head pointer slots and to the resolve tile they belong to.
+	class HeadAddressing {
+	public:
+		HeadAddressing() = default;
+
+		HeadAddressing(HeadLayout layout, uint32_t width, uint32_t height);
+
+		auto GetLayout() const -> HeadLayout { return m_Layout; }
+
+		// Slots to allocate, which the tiled layout pads to whole tiles.
+		auto GetSlotCount() const -> uint32_t { return m_SlotCount; }
+
+		auto GetTileCount() const -> uint32_t { return m_TileCountX * m_TileCountY; }
+
+		auto GetTileIndex(uint32_t x, uint32_t y) const -> uint32_t {
+			return (y / RESOLVE_GROUP_SIZE) * m_TileCountX + x / RESOLVE_GROUP_SIZE;
+		}
+
+		auto GetSlot(uint32_t x, uint32_t y) const -> uint32_t {
+			if (m_Layout == HeadLayout::Linear)
+				return y * m_Width + x;
+			return GetTileIndex(x, y) * RESOLVE_GROUP_SIZE * RESOLVE_GROUP_SIZE + TILE_MORTON_TABLE.Offsets[(y % RESOLVE_GROUP_SIZE) * RESOLVE_GROUP_SIZE + x % RESOLVE_GROUP_SIZE];
+		}
+
+	private:
+		HeadLayout m_Layout = HeadLayout::Linear;
+		uint32_t   m_Width = 0;
+		uint32_t   m_TileCountX = 0;
+		uint32_t   m_TileCountY = 0;
+		uint32_t   m_SlotCount = 0;
+	};
+
+	auto ToString(HeadLayout layout) -> char const*;
+
+	auto ParseHeadLayout(std::string const& name) -> HeadLayout;
+
+}
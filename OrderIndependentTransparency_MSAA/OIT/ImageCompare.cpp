@@ -0,0 +1,38 @@
+#include "ImageCompare.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace OIT {
+
+	auto CompareImages(Image const& image, Image const& reference) -> ImageError {
+		if (image.Width != reference.Width || image.Height != reference.Height)
+			throw std::invalid_argument("Images to compare must have the same size");
+
+		ImageError result;
+		uint64_t sumDelta = 0;
+		uint64_t sumSquaredDelta = 0;
+		for (size_t texelIdx = 0; texelIdx < image.Texels.size(); texelIdx++) {
+			auto isDifferent = false;
+			for (uint32_t channelIdx = 0; channelIdx < 3; channelIdx++) {
+				auto const a = static_cast<int32_t>((image.Texels[texelIdx] >> (8 * channelIdx)) & 0xFF);
+				auto const b = static_cast<int32_t>((reference.Texels[texelIdx] >> (8 * channelIdx)) & 0xFF);
+				auto const delta = static_cast<uint32_t>(std::abs(a - b));
+				result.MaxDelta = std::max(result.MaxDelta, delta);
+				sumDelta += delta;
+				sumSquaredDelta += delta * delta;
+				isDifferent |= delta != 0;
+			}
+			result.DifferingPixels += isDifferent;
+		}
+
+		auto const channelCount = static_cast<double>(std::max<size_t>(image.Texels.size() * 3, 1));
+		result.MeanDelta = sumDelta / channelCount;
+		result.RMSE = std::sqrt(sumSquaredDelta / channelCount);
+		result.PSNR = result.RMSE > 0.0 ? 20.0 * std::log10(255.0 / result.RMSE) : std::numeric_limits<double>::infinity();
+		return result;
+	}
+
+}
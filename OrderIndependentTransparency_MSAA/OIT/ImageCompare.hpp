@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	// Per-channel difference of the RGB channels of two images, in 8-bit steps. Alpha is ignored like in the PPM.
+	struct ImageError {
+		uint32_t MaxDelta        = 0;
+		double   MeanDelta       = 0.0;
+		double   RMSE            = 0.0;
+		// Infinite for identical images.
+		double   PSNR            = 0.0;
+		uint64_t DifferingPixels = 0;
+	};
+
+	// Both images must have the same size.
+	auto CompareImages(Image const& image, Image const& reference) -> ImageError;
+
+}
@@ -0,0 +1,31 @@
+#include "ImageFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace OIT {
+
+	auto WriteImagePPM(std::string const& fileName, Image const& image) -> void {
+		std::ofstream file(fileName, std::ios::binary);
+		if (!file)
+			throw std::runtime_error("Failed to open " + fileName);
+
+		file << "P6\n" << image.Width << " " << image.Height << "\n255\n";
+
+		std::vector<char> row(image.Width * 3);
+		for (uint32_t y = 0; y < image.Height; y++) {
+			for (uint32_t x = 0; x < image.Width; x++) {
+				auto const texel = image.Texels[y * image.Width + x];
+				row[3 * x + 0] = static_cast<char>((texel >> 0) & 0xFF);
+				row[3 * x + 1] = static_cast<char>((texel >> 8) & 0xFF);
+				row[3 * x + 2] = static_cast<char>((texel >> 16) & 0xFF);
+			}
+			file.write(row.data(), row.size());
+		}
+
+		if (!file)
+			throw std::runtime_error("Failed to write " + fileName);
+	}
+
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	// Binary PPM (P6), alpha is dropped.
+	auto WriteImagePPM(std::string const& fileName, Image const& image) -> void;
+
+}
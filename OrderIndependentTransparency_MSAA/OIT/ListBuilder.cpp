@@ -0,0 +1,65 @@
+#include "ListBuilder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace OIT {
+
+	auto ListBuilder::Reset(std::atomic<uint32_t>* pHeadPointers, HeadAddressing const& headAddressing, ListNodeBuffer* pLinkedList, uint32_t nodeCapacity, uint32_t threadCount, uint32_t chunkSize, NodeAllocation allocation) -> void {
+		m_pHeadPointers = pHeadPointers;
+		m_HeadAddressing = headAddressing;
+		m_pLinkedList = pLinkedList;
+		m_NodeCapacity = nodeCapacity;
+		m_ChunkSize = std::max(1u, chunkSize);
+		m_Allocation = allocation;
+		m_Arenas.assign(threadCount, ThreadArena{});
+		m_TileChunks.assign(allocation == NodeAllocation::PerTile ? headAddressing.GetTileCount() : 0, NodeChunk{});
+		m_NodeCounter.store(0, std::memory_order_relaxed);
+	}
+
+	auto ListBuilder::GetStatistics() const -> ListBuilderStatistics {
+		ListBuilderStatistics result;
+		for (auto const& arena : m_Arenas) {
+			result.Fragments        += arena.Statistics.Fragments;
+			result.DroppedFragments += arena.Statistics.DroppedFragments;
+			result.ChunkClaims      += arena.Statistics.ChunkClaims;
+			result.CounterRetries   += arena.Statistics.CounterRetries;
+		}
+		return result;
+	}
+
+	auto ListBuilder::ClaimChunk(NodeChunk& chunk, ListBuilderStatistics& statistics) -> bool {
+		// Compare-exchange instead of fetch_add so that a claim never moves the counter past the capacity and
+		// failed attempts can be counted as contention.
+		auto first = m_NodeCounter.load(std::memory_order_relaxed);
+		while (true) {
+			if (first >= m_NodeCapacity)
+				return false;
+
+			auto const last = first + std::min(m_ChunkSize, m_NodeCapacity - first);
+			if (m_NodeCounter.compare_exchange_weak(first, last, std::memory_order_relaxed)) {
+				chunk.NextNode = first;
+				chunk.EndNode = last;
+				statistics.ChunkClaims++;
+				return true;
+			}
+			statistics.CounterRetries++;
+		}
+	}
+
+	auto ToString(NodeAllocation allocation) -> char const* {
+		switch (allocation) {
+			case NodeAllocation::PerThread: return "thread";
+			case NodeAllocation::PerTile:   return "tile";
+			default:                        return "unknown";
+		}
+	}
+
+	auto ParseNodeAllocation(std::string const& name) -> NodeAllocation {
+		for (auto const candidate : { NodeAllocation::PerThread, NodeAllocation::PerTile })
+			if (name == ToString(candidate))
+				return candidate;
+		throw std::invalid_argument("Unknown node allocation: " + name);
+	}
+
+}
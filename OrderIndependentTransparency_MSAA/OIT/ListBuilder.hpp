@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Common.hpp"
+#include "HeadAddressing.hpp"
+#include "NodeEncoding.hpp"
+
+namespace OIT {
+
+	enum class NodeAllocation {
+		// Every thread hands out nodes from its own chunk, in rasterization order.
+		PerThread,
+		// Every resolve tile has its own chunk, so the lists of one CSMain thread group are packed into a few
+		// chunks. Costs up to ChunkSize - 1 unused slots per touched tile.
+		PerTile
+	};
+
+	struct ListBuilderStatistics {
+		uint64_t Fragments        = 0;
+		uint64_t DroppedFragments = 0;
+		uint64_t ChunkClaims      = 0;
+		uint64_t CounterRetries   = 0;
+	};
+
+	// CPU counterpart of PSMain in TransparentGeometry.hlsl. Heads are linked with an atomic exchange like
+	// InterlockedExchange on HeadPointersUAV, but instead of one IncrementCounter per fragment every thread claims
+	// ChunkSize node slots at a time from the shared counter and hands them out from its private arena. A chunk
+	// size of 1 reproduces the per-fragment global counter of the shader.
+	//
+	// Once the pool is exhausted a fragment is dropped before it touches the head pointer, so the lists stay
+	// well-formed and only lose their newest fragments, matching the bound check in PSMain.
+	//
+	// PerTile allocation expects every resolve tile to be appended to by one thread at a time, which holds as
+	// long as the rasterizer tiles are made of whole resolve tiles.
+	class ListBuilder {
+	public:
+		auto Reset(std::atomic<uint32_t>* pHeadPointers, HeadAddressing const& headAddressing, ListNodeBuffer* pLinkedList, uint32_t nodeCapacity, uint32_t threadCount, uint32_t chunkSize, NodeAllocation allocation) -> void;
+
+		auto Append(uint32_t threadIdx, uint32_t x, uint32_t y, ListNode node) -> void {
+			auto& arena = m_Arenas[threadIdx];
+			auto& chunk = m_Allocation == NodeAllocation::PerTile ? m_TileChunks[m_HeadAddressing.GetTileIndex(x, y)] : arena.Chunk;
+			arena.Statistics.Fragments++;
+			if (chunk.NextNode == chunk.EndNode && !ClaimChunk(chunk, arena.Statistics)) {
+				arena.Statistics.DroppedFragments++;
+				return;
+			}
+
+			auto const nodeIdx = chunk.NextNode++;
+			node.Next = m_pHeadPointers[m_HeadAddressing.GetSlot(x, y)].exchange(nodeIdx, std::memory_order_relaxed);
+			m_pLinkedList->Store(nodeIdx, node);
+		}
+
+		// Slots taken from the shared counter, including the unused tails of partially filled chunks.
+		auto GetClaimedNodeCount() const -> uint32_t { return m_NodeCounter.load(std::memory_order_relaxed); }
+
+		auto GetStatistics() const -> ListBuilderStatistics;
+
+	private:
+		struct NodeChunk {
+			uint32_t NextNode = 0;
+			uint32_t EndNode  = 0;
+		};
+
+		struct alignas(64) ThreadArena {
+			NodeChunk             Chunk;
+			ListBuilderStatistics Statistics;
+		};
+
+		auto ClaimChunk(NodeChunk& chunk, ListBuilderStatistics& statistics) -> bool;
+
+	private:
+		std::atomic<uint32_t>*   m_pHeadPointers = nullptr;
+		HeadAddressing           m_HeadAddressing;
+		ListNodeBuffer*          m_pLinkedList = nullptr;
+		uint32_t                 m_NodeCapacity = 0;
+		uint32_t                 m_ChunkSize = 1;
+		NodeAllocation           m_Allocation = NodeAllocation::PerThread;
+		std::vector<ThreadArena> m_Arenas;
+		std::vector<NodeChunk>   m_TileChunks;
+		alignas(64) std::atomic<uint32_t> m_NodeCounter{ 0 };
+	};
+
+	auto ToString(NodeAllocation allocation) -> char const*;
+
+	auto ParseNodeAllocation(std::string const& name) -> NodeAllocation;
+
+}
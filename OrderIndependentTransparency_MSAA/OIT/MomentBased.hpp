@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	// Bytes per sample of the GPU targets: R32_FLOAT zeroth moment, R32G32B32A32_FLOAT power moments and the
+	// R16G16B16A16_FLOAT accumulation of the second pass.
+	constexpr uint32_t MOMENT_SAMPLE_SIZE = 4 + 16 + 8;
+
+	// Bias of Muenstermann et al., "Moment-Based Order-Independent Transparency", for four power moments in 32-bit
+	// floats, towards the moments of a uniform distribution on [-1, 1]. It keeps the Hankel matrix positive definite.
+	constexpr float MOMENT_BIAS           = 5.0e-7f;
+	// Weight of the fragment's own depth in the reconstructed absorbance, between the lower (0) and upper (1) bound.
+	constexpr float MOMENT_OVERESTIMATION = 0.25f;
+
+	// Mirror of the render targets of MomentBased.hlsl for one MSAA sample. The cleared state is no coverage at all.
+	struct MomentSample {
+		// Total absorbance -ln(T) of the sample.
+		float  Moment0      = 0.0f;
+		// Absorbance weighted with z, z^2, z^3 and z^4 of the depth mapped to [-1, 1].
+		float  Moments[4]   = { 0.0f, 0.0f, 0.0f, 0.0f };
+		// Premultiplied color and alpha, each fragment attenuated by the transmittance reconstructed in front of it.
+		Color4 Accumulation = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	inline auto GetMomentDepth(float depth) -> float {
+		return 2.0f * depth - 1.0f;
+	}
+
+	// Absorbance of one fragment. The alpha is clamped so that an opaque fragment does not produce an infinity.
+	inline auto GetMomentAbsorbance(float alpha) -> float {
+		return -std::log(1.0f - std::min(Saturate(alpha), 0.999f));
+	}
+
+	// Blend state of PSGenerate: ONE/ONE on both moment targets. Both passes shade per sample, so depth is the depth
+	// of the sample.
+	inline auto AccumulateMoments(MomentSample& sample, float depth, float alpha) -> void {
+		auto const absorbance = GetMomentAbsorbance(alpha);
+		auto const z = GetMomentDepth(depth);
+		auto const z2 = z * z;
+		sample.Moment0 += absorbance;
+		sample.Moments[0] += absorbance * z;
+		sample.Moments[1] += absorbance * z2;
+		sample.Moments[2] += absorbance * z2 * z;
+		sample.Moments[3] += absorbance * z2 * z2;
+	}
+
+	// Transmittance in front of depth, reconstructed from the four power moments with the Hamburger bound of
+	// Muenstermann et al. (algorithm 2 of "Moment Shadow Mapping", Peters and Klein). Mirror of
+	// ComputeTransmittance in MomentBased.hlsl.
+	inline auto ComputeMomentTransmittance(MomentSample const& sample, float depth) -> float {
+		// Below the absorbance of a single fragment with alpha 1/1000 nothing was drawn in front.
+		if (sample.Moment0 < 1.0e-3f)
+			return 1.0f;
+
+		float const biasVector[4] = { 0.0f, 0.375f, 0.0f, 0.375f };
+		float b[4];
+		for (uint32_t momentIdx = 0; momentIdx < 4; momentIdx++)
+			b[momentIdx] = Lerp(sample.Moments[momentIdx] / sample.Moment0, biasVector[momentIdx], MOMENT_BIAS);
+
+		// Cholesky factorization of the Hankel matrix, only the non-trivial entries.
+		auto const z0 = GetMomentDepth(depth);
+		auto const l21d11 = b[2] - b[0] * b[1];
+		auto const d11 = b[1] - b[0] * b[0];
+		auto const invD11 = 1.0f / d11;
+		auto const l21 = l21d11 * invD11;
+		auto const squaredDepthVariance = b[3] - b[1] * b[1];
+		auto const d22 = squaredDepthVariance - l21d11 * l21;
+
+		// Solve B c = (1, z0, z0^2) by forward substitution, scaling and backward substitution.
+		float c[3] = { 1.0f, z0, z0 * z0 };
+		c[1] -= b[0];
+		c[2] -= b[1] + l21 * c[1];
+		c[1] *= invD11;
+		c[2] /= d22;
+		c[1] -= l21 * c[2];
+		c[0] -= c[1] * b[0] + c[2] * b[1];
+
+		// Roots of c0 + c1 z + c2 z^2 are the other two support points of the distribution. The query depth of a
+		// fragment is often a support point itself, which makes c2 vanish. The cancellation-free form then keeps z1
+		// finite and sends z2 to infinity, and the divided differences below drop its weight as they should.
+		auto const r = std::sqrt(std::max(c[1] * c[1] - 4.0f * c[0] * c[2], 0.0f));
+		auto const t = -0.5f * (c[1] + std::copysign(r, c[1]));
+		auto const z1 = c[0] / t;
+		auto const z2 = t / c[2];
+
+		// Interpolate the weights of the three support points and sum them up.
+		auto const f0 = MOMENT_OVERESTIMATION;
+		auto const f1 = z1 < z0 ? 1.0f : 0.0f;
+		auto const f2 = z2 < z0 ? 1.0f : 0.0f;
+		auto const f01 = (f1 - f0) / (z1 - z0);
+		auto const f12 = (f2 - f1) / (z2 - z1);
+		auto const f012 = (f12 - f01) / (z2 - z0);
+
+		float polynomial[3];
+		polynomial[0] = f012;
+		polynomial[1] = polynomial[0];
+		polynomial[0] = f01 - polynomial[0] * z1;
+		polynomial[2] = polynomial[1];
+		polynomial[1] = polynomial[0] - polynomial[1] * z0;
+		polynomial[0] = f0 - polynomial[0] * z0;
+
+		// A distribution that collapsed onto the query depth leaves nothing but the fragment itself.
+		auto absorbance = polynomial[0] + polynomial[1] * b[0] + polynomial[2] * b[1];
+		if (!std::isfinite(absorbance))
+			absorbance = f0;
+		return Saturate(std::exp(-sample.Moment0 * absorbance));
+	}
+
+	// Blend state of PSResolve: ONE/ONE on the accumulation.
+	inline auto AccumulateMomentColor(MomentSample& sample, Color4 const& color, float transmittance) -> void {
+		auto const alpha = Saturate(color.A);
+		auto const weight = alpha * transmittance;
+		sample.Accumulation = sample.Accumulation + Color4{ Saturate(color.R) * weight, Saturate(color.G) * weight, Saturate(color.B) * weight, weight };
+	}
+
+	// CSComposite for one sample. The accumulated colors are renormalized to the exact total transmittance of the
+	// zeroth moment, so the opacity is always right and only the ordering is approximated.
+	inline auto CompositeMoments(MomentSample const& sample, Color4 const& background) -> Color4 {
+		auto const transmittance = std::exp(-sample.Moment0);
+		if (sample.Accumulation.A < 1.0e-5f)
+			return background;
+
+		auto const scale = (1.0f - transmittance) / sample.Accumulation.A;
+		return {
+			sample.Accumulation.R * scale + background.R * transmittance,
+			sample.Accumulation.G * scale + background.G * transmittance,
+			sample.Accumulation.B * scale + background.B * transmittance,
+			Lerp(1.0f, background.A, transmittance)
+		};
+	}
+
+}
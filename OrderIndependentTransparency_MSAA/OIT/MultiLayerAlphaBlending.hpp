@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	constexpr uint32_t MAX_MLAB_LAYER_COUNT = 16;
+
+	// Unused layer slot. The depth sorts behind every fragment, so the filled layers always form a prefix. PSInsert
+	// clears its buffer to the same bits with ClearUnorderedAccessViewUint(0xFF800000).
+	constexpr ListSubNode EMPTY_LAYER = { -std::numeric_limits<float>::infinity(), 0xFF800000 };
+
+	inline auto GetLayerCount(ListSubNode const* pLayers, uint32_t layerCount) -> uint32_t {
+		uint32_t count = 0;
+		while (count < layerCount && pLayers[count].Depth != EMPTY_LAYER.Depth)
+			count++;
+		return count;
+	}
+
+	// Single layer that blends like farLayer followed by nearLayer. It takes the depth of nearLayer, so it stays
+	// behind every layer nearLayer was behind.
+	inline auto MergeLayers(ListSubNode const& farLayer, ListSubNode const& nearLayer) -> ListSubNode {
+		auto const farColor = UnpackColor(farLayer.Color);
+		auto const nearColor = UnpackColor(nearLayer.Color);
+		auto const farWeight = farColor.A * (1.0f - nearColor.A);
+		auto const alpha = farWeight + nearColor.A;
+
+		Color4 color = { 0.0f, 0.0f, 0.0f, 0.0f };
+		if (alpha > 0.0f) {
+			color.R = (farColor.R * farWeight + nearColor.R * nearColor.A) / alpha;
+			color.G = (farColor.G * farWeight + nearColor.G * nearColor.A) / alpha;
+			color.B = (farColor.B * farWeight + nearColor.B * nearColor.A) / alpha;
+			color.A = alpha;
+		}
+		return { nearLayer.Depth, PackColor(color) };
+	}
+
+	// Mirror of PSInsert in MultiLayerAlphaBlending.hlsl. Layers are kept back to front, the order CSMain sorts its
+	// nodes into, so the composite blends them with the same loop. A fragment goes in front of layers of equal
+	// depth, which reproduces the tie order of the list resolve. Once all slots are taken the two farthest of the
+	// layerCount + 1 layers are merged into the tail, so the nearest layerCount - 1 fragments stay exact.
+	inline auto InsertLayer(ListSubNode* pLayers, uint32_t layerCount, ListSubNode const& fragment) -> void {
+		if (pLayers[layerCount - 1].Depth == EMPTY_LAYER.Depth) {
+			auto layerIdx = layerCount - 1;
+			while (layerIdx > 0 && pLayers[layerIdx - 1].Depth <= fragment.Depth) {
+				pLayers[layerIdx] = pLayers[layerIdx - 1];
+				layerIdx--;
+			}
+			pLayers[layerIdx] = fragment;
+			return;
+		}
+
+		if (fragment.Depth >= pLayers[0].Depth) {
+			pLayers[0] = MergeLayers(fragment, pLayers[0]);
+			return;
+		}
+
+		if (layerCount == 1 || fragment.Depth >= pLayers[1].Depth) {
+			pLayers[0] = MergeLayers(pLayers[0], fragment);
+			return;
+		}
+
+		pLayers[0] = MergeLayers(pLayers[0], pLayers[1]);
+		uint32_t layerIdx = 1;
+		while (layerIdx + 1 < layerCount && pLayers[layerIdx + 1].Depth > fragment.Depth) {
+			pLayers[layerIdx] = pLayers[layerIdx + 1];
+			layerIdx++;
+		}
+		pLayers[layerIdx] = fragment;
+	}
+
+}
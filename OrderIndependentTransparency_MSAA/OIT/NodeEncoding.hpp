@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Common.hpp"
+
+// Node storage encoding shared with the shaders, 16, 12 or 8 bytes per node. Set at build time, Main.cpp passes
+// the same value to the shaders as NODE_ENCODING.
+#ifndef OIT_NODE_ENCODING
+#define OIT_NODE_ENCODING 16
+#endif
+
+// 1: keep the link and payload halves of every node in separate arrays (NODE_LAYOUT_SOA in the shaders).
+#ifndef OIT_NODE_LAYOUT_SOA
+#define OIT_NODE_LAYOUT_SOA 0
+#endif
+
+namespace OIT {
+
+	// Compiles x64/*/Shaders/NodeEncoding.hlsli as C++, so both sides pack nodes through one definition.
+	namespace HLSL {
+
+		using uint = uint32_t;
+
+		inline auto asuint(float value) -> uint { return AsUint(value); }
+
+		inline auto asfloat(uint value) -> float { return AsFloat(value); }
+
+		inline auto saturate(float value) -> float { return Saturate(value); }
+
+#define NODE_ENCODING OIT_NODE_ENCODING
+#define NODE_LAYOUT_SOA OIT_NODE_LAYOUT_SOA
+#define NODE_ENCODING_INLINE inline
+#include "../../x64/Release/Shaders/NodeEncoding.hlsli"
+#undef NODE_ENCODING_INLINE
+#undef NODE_LAYOUT_SOA
+#undef NODE_ENCODING
+
+	}
+
+	using HLSL::ListNodeCompact12;
+	using HLSL::ListNodeCompact8;
+	using HLSL::StoredListNode;
+	using HLSL::StoredListNodeLink;
+	using HLSL::StoredListNodePayload;
+	using HLSL::PackListNode;
+	using HLSL::UnpackListNode;
+
+	constexpr uint32_t NODE_ENCODING = OIT_NODE_ENCODING;
+	constexpr bool     NODE_LAYOUT_SOA = OIT_NODE_LAYOUT_SOA != 0;
+	constexpr uint32_t LIST_NODE_MAX_COUNT = HLSL::LIST_NODE_MAX_COUNT;
+	constexpr size_t   LIST_NODE_SIZE = NODE_LAYOUT_SOA ? sizeof(StoredListNodeLink) + sizeof(StoredListNodePayload) : sizeof(StoredListNode);
+
+	static_assert(sizeof(ListNodeCompact12) == 12, "ListNodeCompact12 must match the HLSL layout");
+	static_assert(sizeof(ListNodeCompact8) == 8, "ListNodeCompact8 must match the HLSL layout");
+	static_assert(sizeof(StoredListNode) == NODE_ENCODING, "NODE_ENCODING is the node size in bytes");
+	static_assert(sizeof(StoredListNodeLink) + sizeof(StoredListNodePayload) == NODE_ENCODING, "The SoA halves must add up to a node");
+
+	// Node pool in the layout picked by OIT_NODE_LAYOUT_SOA. A list walk calls LoadLink for every node and
+	// LoadPayload only for the nodes it keeps; with the AoS layout LoadLink already returns the whole node.
+	class ListNodeBuffer {
+	public:
+		auto Allocate(uint32_t capacity) -> void {
+			if constexpr (NODE_LAYOUT_SOA) {
+				m_pLinks.reset(new StoredListNodeLink[capacity]);
+				m_pPayloads.reset(new StoredListNodePayload[capacity]);
+			} else {
+				m_pNodes.reset(new StoredListNode[capacity]);
+			}
+		}
+
+		auto Store(uint32_t nodeIdx, ListNode const& node) -> void {
+			if constexpr (NODE_LAYOUT_SOA) {
+				m_pLinks[nodeIdx] = HLSL::PackListNodeLink(node);
+				m_pPayloads[nodeIdx] = HLSL::PackListNodePayload(node);
+			} else {
+				m_pNodes[nodeIdx] = PackListNode(node);
+			}
+		}
+
+		auto LoadLink(uint32_t nodeIdx) const -> ListNode {
+			if constexpr (NODE_LAYOUT_SOA)
+				return HLSL::UnpackListNodeLink(m_pLinks[nodeIdx]);
+			else
+				return UnpackListNode(m_pNodes[nodeIdx]);
+		}
+
+		auto LoadPayload(uint32_t nodeIdx, ListNode const& node) const -> ListNode {
+			if constexpr (NODE_LAYOUT_SOA)
+				return HLSL::UnpackListNodePayload(node, m_pPayloads[nodeIdx]);
+			else
+				return node;
+		}
+
+		// Where LoadLink and LoadPayload read a node from, for locality measurements.
+		auto GetLinkAddress(uint32_t nodeIdx) const -> void const* {
+			if constexpr (NODE_LAYOUT_SOA)
+				return &m_pLinks[nodeIdx];
+			else
+				return &m_pNodes[nodeIdx];
+		}
+
+		auto GetPayloadAddress(uint32_t nodeIdx) const -> void const* {
+			if constexpr (NODE_LAYOUT_SOA)
+				return &m_pPayloads[nodeIdx];
+			else
+				return &m_pNodes[nodeIdx];
+		}
+
+	private:
+		std::unique_ptr<StoredListNode[]>        m_pNodes;
+		std::unique_ptr<StoredListNodeLink[]>    m_pLinks;
+		std::unique_ptr<StoredListNodePayload[]> m_pPayloads;
+	};
+
+}
@@ -0,0 +1,74 @@
+#include "PerfCounters.hpp"
+
+#if defined(__linux__)
+#include <cstring>
+#include <initializer_list>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace OIT {
+
+#if defined(__linux__)
+	namespace {
+
+		auto OpenCounter(uint32_t type, uint64_t config) -> int {
+			perf_event_attr attributes;
+			std::memset(&attributes, 0, sizeof(attributes));
+			attributes.size = sizeof(attributes);
+			attributes.type = type;
+			attributes.config = config;
+			attributes.disabled = 1;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+			return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+		}
+
+		auto ReadCounter(int descriptor) -> uint64_t {
+			uint64_t value = 0;
+			return read(descriptor, &value, sizeof(value)) == sizeof(value) ? value : 0;
+		}
+
+	}
+
+	CacheMissCounters::CacheMissCounters() {
+		m_L1DDescriptor = OpenCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+		m_LLCDescriptor = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	}
+
+	CacheMissCounters::~CacheMissCounters() {
+		if (m_L1DDescriptor >= 0)
+			close(m_L1DDescriptor);
+		if (m_LLCDescriptor >= 0)
+			close(m_LLCDescriptor);
+	}
+
+	auto CacheMissCounters::Start() -> void {
+		if (!IsAvailable())
+			return;
+		for (auto const descriptor : { m_L1DDescriptor, m_LLCDescriptor }) {
+			ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+			ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	auto CacheMissCounters::Stop() -> CacheMissCounts {
+		if (!IsAvailable())
+			return {};
+		for (auto const descriptor : { m_L1DDescriptor, m_LLCDescriptor })
+			ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+		return { ReadCounter(m_L1DDescriptor), ReadCounter(m_LLCDescriptor) };
+	}
+#else
+	CacheMissCounters::CacheMissCounters() = default;
+
+	CacheMissCounters::~CacheMissCounters() = default;
+
+	auto CacheMissCounters::Start() -> void {}
+
+	auto CacheMissCounters::Stop() -> CacheMissCounts { return {}; }
+#endif
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+namespace OIT {
+
+	struct CacheMissCounts {
+		uint64_t L1DReadMisses = 0;
+		uint64_t LLCMisses     = 0;
+	};
+
+	// Hardware cache miss counters of the calling thread, read through perf_event_open. Only implemented on Linux
+	// and only available where the kernel exposes the PMU, which most virtual machines do not.
+	class CacheMissCounters {
+	public:
+		CacheMissCounters();
+
+		~CacheMissCounters();
+
+		CacheMissCounters(CacheMissCounters const&) = delete;
+
+		auto operator=(CacheMissCounters const&) -> CacheMissCounters& = delete;
+
+		auto IsAvailable() const -> bool { return m_L1DDescriptor >= 0 && m_LLCDescriptor >= 0; }
+
+		auto Start() -> void;
+
+		// Misses since the last Start, zero when the counters are unavailable.
+		auto Stop() -> CacheMissCounts;
+
+	private:
+		int m_L1DDescriptor = -1;
+		int m_LLCDescriptor = -1;
+	};
+
+}
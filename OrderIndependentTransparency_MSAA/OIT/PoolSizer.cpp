@@ -0,0 +1,52 @@
+#include "PoolSizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace OIT {
+
+	PoolSizer::PoolSizer(PoolSizerDesc const& desc, uint64_t nodeSize, uint64_t initialCapacity)
+		: m_Desc(desc)
+		, m_History(std::max(1u, desc.HistoryLength), 0) {
+
+		if (nodeSize == 0 || desc.Headroom < 1.0f || desc.ShrinkThreshold <= 0.0f || desc.ShrinkThreshold > 1.0f)
+			throw std::invalid_argument("Invalid PoolSizerDesc");
+
+		m_Desc.Granularity = std::max<uint64_t>(1, desc.Granularity);
+		// The node index is 32 bits wide and INVALID_NODE_INDEX is reserved.
+		m_MaxCapacity = std::numeric_limits<uint32_t>::max() - 1;
+		if (desc.MaxBytes != 0)
+			m_MaxCapacity = std::min(m_MaxCapacity, desc.MaxBytes / nodeSize);
+		m_Capacity = std::min(std::max(initialCapacity, m_Desc.MinCapacity), m_MaxCapacity);
+	}
+
+	auto PoolSizer::Update(uint64_t counterValue) -> uint64_t {
+		m_History[m_HistoryIdx] = counterValue;
+		m_HistoryIdx = (m_HistoryIdx + 1) % static_cast<uint32_t>(m_History.size());
+		m_HistorySize = std::min(m_HistorySize + 1, static_cast<uint32_t>(m_History.size()));
+
+		auto const peakCounterValue = GetPeakCounterValue();
+		auto const targetCapacity = ComputeTargetCapacity(peakCounterValue);
+
+		auto const isGrowing = peakCounterValue > m_Capacity && targetCapacity > m_Capacity;
+		auto const isShrinking = m_HistorySize == m_History.size() && targetCapacity < m_Capacity * static_cast<double>(m_Desc.ShrinkThreshold);
+		if (isGrowing || isShrinking) {
+			m_Capacity = targetCapacity;
+			m_ResizeCount++;
+		}
+		return m_Capacity;
+	}
+
+	auto PoolSizer::GetPeakCounterValue() const -> uint64_t {
+		return m_HistorySize ? *std::max_element(m_History.begin(), m_History.begin() + m_HistorySize) : 0;
+	}
+
+	auto PoolSizer::ComputeTargetCapacity(uint64_t peakCounterValue) const -> uint64_t {
+		auto const withHeadroom = static_cast<uint64_t>(std::ceil(static_cast<double>(peakCounterValue) * m_Desc.Headroom));
+		auto const rounded = (withHeadroom + m_Desc.Granularity - 1) / m_Desc.Granularity * m_Desc.Granularity;
+		return std::min(std::max(rounded, m_Desc.MinCapacity), m_MaxCapacity);
+	}
+
+}
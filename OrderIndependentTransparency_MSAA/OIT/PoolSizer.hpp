@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace OIT {
+
+	struct PoolSizerDesc {
+		// Frames of node counter history the decision looks at.
+		uint32_t HistoryLength   = 120;
+		// Capacity chosen on every resize, relative to the peak counter of the history window.
+		float    Headroom        = 1.25f;
+		// The pool only shrinks once the chosen capacity would fall below this fraction of the current one.
+		float    ShrinkThreshold = 0.5f;
+		// Capacities are rounded up to a multiple of this many nodes.
+		uint64_t Granularity     = 64 * 1024;
+		uint64_t MinCapacity     = 64 * 1024;
+		// Memory ceiling of the node buffer in bytes, 0 for none. Fragments past it are dropped.
+		uint64_t MaxBytes        = 0;
+	};
+
+	// Picks the node pool capacity from the counter values of recent frames. A frame that needs more nodes than
+	// the pool holds grows it right away; the pool shrinks only after a full history window stayed well below the
+	// current capacity. The band between the two keeps a steady scene from reallocating.
+	class PoolSizer {
+	public:
+		PoolSizer(PoolSizerDesc const& desc, uint64_t nodeSize, uint64_t initialCapacity);
+
+		// Feeds the node counter of a finished frame and returns the capacity the pool should have from now on.
+		auto Update(uint64_t counterValue) -> uint64_t;
+
+		auto GetCapacity() const -> uint64_t { return m_Capacity; }
+
+		auto GetMaxCapacity() const -> uint64_t { return m_MaxCapacity; }
+
+		auto GetPeakCounterValue() const -> uint64_t;
+
+		auto GetResizeCount() const -> uint64_t { return m_ResizeCount; }
+
+	private:
+		auto ComputeTargetCapacity(uint64_t peakCounterValue) const -> uint64_t;
+
+	private:
+		PoolSizerDesc         m_Desc;
+		uint64_t              m_MaxCapacity = 0;
+		uint64_t              m_Capacity = 0;
+		uint64_t              m_ResizeCount = 0;
+		std::vector<uint64_t> m_History;
+		uint32_t              m_HistoryIdx = 0;
+		uint32_t              m_HistorySize = 0;
+	};
+
+}
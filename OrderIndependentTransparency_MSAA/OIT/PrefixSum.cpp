@@ -0,0 +1,43 @@
+#include "PrefixSum.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace OIT {
+
+	// Blocks per worker, so a slow worker does not hold up the others for long.
+	constexpr uint32_t SCAN_BLOCKS_PER_THREAD = 4;
+	// Below this a block is not worth a task.
+	constexpr uint32_t SCAN_MIN_BLOCK_SIZE = 4096;
+
+	auto ExclusiveScan(ThreadPool& threadPool, uint32_t const* pInput, uint32_t* pOutput, uint32_t count) -> uint32_t {
+		auto const blockCount = std::max(1u, std::min(threadPool.GetThreadCount() * SCAN_BLOCKS_PER_THREAD, count / SCAN_MIN_BLOCK_SIZE));
+		auto const blockSize = (count + blockCount - 1) / blockCount;
+
+		std::vector<uint32_t> blockOffsets(blockCount + 1, 0);
+		threadPool.ParallelFor(blockCount, [&](uint32_t blockIdx, uint32_t) -> void {
+			auto const end = std::min(count, (blockIdx + 1) * blockSize);
+			uint32_t sum = 0;
+			for (auto elementIdx = blockIdx * blockSize; elementIdx < end; elementIdx++)
+				sum += pInput[elementIdx];
+			blockOffsets[blockIdx + 1] = sum;
+		});
+
+		for (uint32_t blockIdx = 0; blockIdx < blockCount; blockIdx++)
+			blockOffsets[blockIdx + 1] += blockOffsets[blockIdx];
+
+		threadPool.ParallelFor(blockCount, [&](uint32_t blockIdx, uint32_t) -> void {
+			auto const end = std::min(count, (blockIdx + 1) * blockSize);
+			auto sum = blockOffsets[blockIdx];
+			for (auto elementIdx = blockIdx * blockSize; elementIdx < end; elementIdx++) {
+				auto const value = pInput[elementIdx];
+				pOutput[elementIdx] = sum;
+				sum += value;
+			}
+		});
+
+		pOutput[count] = blockOffsets[blockCount];
+		return blockOffsets[blockCount];
+	}
+
+}
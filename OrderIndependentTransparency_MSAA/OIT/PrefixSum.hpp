@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ThreadPool.hpp"
+
+namespace OIT {
+
+	// Exclusive prefix sum of pInput[0, count) into pOutput[0, count], so pOutput[count] holds the total, which is
+	// also returned. The input is split into a few blocks per worker: every block sums its range, the block sums are
+	// scanned on the calling thread and every block then scans its range from its own offset. The same three steps
+	// as CSScanGroups, CSScanGroupSums and CSAddGroupOffsets of FragmentArrays.hlsl. pInput and pOutput may alias.
+	auto ExclusiveScan(ThreadPool& threadPool, uint32_t const* pInput, uint32_t* pOutput, uint32_t count) -> uint32_t;
+
+}
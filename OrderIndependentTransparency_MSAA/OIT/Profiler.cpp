@@ -0,0 +1,110 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+namespace OIT {
+
+	auto SampleRing::Push(double value) -> void {
+		if (m_Samples.empty())
+			return;
+		m_Samples[m_WriteIdx] = value;
+		m_WriteIdx = (m_WriteIdx + 1) % static_cast<uint32_t>(m_Samples.size());
+		m_Count = std::min(m_Count + 1, static_cast<uint32_t>(m_Samples.size()));
+	}
+
+	auto SampleRing::GetSamples() const -> std::vector<double> {
+		std::vector<double> samples;
+		samples.reserve(m_Count);
+		auto const capacity = static_cast<uint32_t>(m_Samples.size());
+		for (uint32_t sampleIdx = 0; sampleIdx < m_Count; sampleIdx++)
+			samples.push_back(m_Samples[(m_WriteIdx + capacity - m_Count + sampleIdx) % capacity]);
+		return samples;
+	}
+
+	auto Summarize(std::vector<double> samples) -> SampleSummary {
+		SampleSummary summary;
+		if (samples.empty())
+			return summary;
+
+		std::sort(samples.begin(), samples.end());
+		auto const Percentile = [&](double percent) -> double {
+			auto const rank = static_cast<size_t>(std::ceil(percent / 100.0 * samples.size()));
+			return samples[std::max<size_t>(rank, 1) - 1];
+		};
+
+		summary.Count = static_cast<uint32_t>(samples.size());
+		summary.Mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+		summary.Min = samples.front();
+		summary.P50 = Percentile(50.0);
+		summary.P95 = Percentile(95.0);
+		summary.P99 = Percentile(99.0);
+		summary.Max = samples.back();
+		return summary;
+	}
+
+	PassProfiler::PassProfiler(std::vector<std::string> const& passNames, uint32_t historyLength) {
+		if (historyLength == 0)
+			throw std::invalid_argument("Profiler history length must not be 0");
+		for (auto const& name : passNames)
+			m_Passes.push_back({ name, SampleRing(historyLength), SampleRing(historyLength) });
+	}
+
+	auto PassProfiler::Reset() -> void {
+		for (auto& pass : m_Passes) {
+			pass.CPU.Clear();
+			pass.GPU.Clear();
+		}
+	}
+
+	auto PassProfiler::WriteCSV(std::string const& fileName) const -> void {
+		std::ofstream file(fileName);
+		if (!file)
+			throw std::runtime_error("Failed to open " + fileName);
+
+		file << "pass,source,count,mean_ms,min_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+		for (auto const& pass : m_Passes) {
+			for (auto const& [source, pRing] : { std::make_pair("cpu", &pass.CPU), std::make_pair("gpu", &pass.GPU) }) {
+				auto const summary = Summarize(pRing->GetSamples());
+				if (summary.Count == 0)
+					continue;
+				file << pass.Name << "," << source << "," << summary.Count << "," << summary.Mean << "," << summary.Min << ","
+					<< summary.P50 << "," << summary.P95 << "," << summary.P99 << "," << summary.Max << "\n";
+			}
+		}
+
+		if (!file)
+			throw std::runtime_error("Failed to write " + fileName);
+	}
+
+	auto PassProfiler::WriteJSON(std::string const& fileName) const -> void {
+		std::ofstream file(fileName);
+		if (!file)
+			throw std::runtime_error("Failed to open " + fileName);
+
+		file << "{\n  \"passes\": [";
+		for (size_t passIdx = 0; passIdx < m_Passes.size(); passIdx++) {
+			auto const& pass = m_Passes[passIdx];
+			file << (passIdx ? "," : "") << "\n    {\n      \"name\": \"" << pass.Name << "\"";
+			for (auto const& [source, pRing] : { std::make_pair("cpu", &pass.CPU), std::make_pair("gpu", &pass.GPU) }) {
+				auto const samples = pRing->GetSamples();
+				auto const summary = Summarize(samples);
+				file << ",\n      \"" << source << "\": { \"count\": " << summary.Count << ", \"mean_ms\": " << summary.Mean << ", \"min_ms\": " << summary.Min
+					<< ", \"p50_ms\": " << summary.P50 << ", \"p95_ms\": " << summary.P95 << ", \"p99_ms\": " << summary.P99 << ", \"max_ms\": " << summary.Max
+					<< ", \"samples_ms\": [";
+				for (size_t sampleIdx = 0; sampleIdx < samples.size(); sampleIdx++)
+					file << (sampleIdx ? ", " : "") << samples[sampleIdx];
+				file << "] }";
+			}
+			file << "\n    }";
+		}
+		file << "\n  ]\n}\n";
+
+		if (!file)
+			throw std::runtime_error("Failed to write " + fileName);
+	}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace OIT {
+
+	// Highest resolution clock that never goes backwards.
+	using ProfilerClock = std::conditional_t<std::chrono::high_resolution_clock::is_steady, std::chrono::high_resolution_clock, std::chrono::steady_clock>;
+
+	// Fixed-capacity history of one series. Once full, every new sample overwrites the oldest.
+	class SampleRing {
+	public:
+		explicit SampleRing(uint32_t capacity = 0) : m_Samples(capacity) {}
+
+		auto Push(double value) -> void;
+
+		auto Clear() -> void { m_Count = 0; m_WriteIdx = 0; }
+
+		auto GetCount() const -> uint32_t { return m_Count; }
+
+		// Oldest sample first.
+		auto GetSamples() const -> std::vector<double>;
+
+	private:
+		std::vector<double> m_Samples;
+		uint32_t            m_WriteIdx = 0;
+		uint32_t            m_Count = 0;
+	};
+
+	// Percentiles use the nearest-rank method, so they are always one of the samples.
+	struct SampleSummary {
+		uint32_t Count = 0;
+		double   Mean  = 0.0;
+		double   Min   = 0.0;
+		double   P50   = 0.0;
+		double   P95   = 0.0;
+		double   P99   = 0.0;
+		double   Max   = 0.0;
+	};
+
+	auto Summarize(std::vector<double> samples) -> SampleSummary;
+
+	// Per-pass CPU and GPU durations in milliseconds over the last historyLength frames. The two sources are
+	// recorded separately because GPU durations arrive a few frames late and not for every frame.
+	class PassProfiler {
+	public:
+		PassProfiler(std::vector<std::string> const& passNames, uint32_t historyLength);
+
+		auto RecordCPU(uint32_t passIdx, double milliseconds) -> void { m_Passes[passIdx].CPU.Push(milliseconds); }
+
+		auto RecordGPU(uint32_t passIdx, double milliseconds) -> void { m_Passes[passIdx].GPU.Push(milliseconds); }
+
+		auto Reset() -> void;
+
+		auto GetPassCount() const -> uint32_t { return static_cast<uint32_t>(m_Passes.size()); }
+
+		auto GetPassName(uint32_t passIdx) const -> std::string const& { return m_Passes[passIdx].Name; }
+
+		auto GetCPUSummary(uint32_t passIdx) const -> SampleSummary { return Summarize(m_Passes[passIdx].CPU.GetSamples()); }
+
+		auto GetGPUSummary(uint32_t passIdx) const -> SampleSummary { return Summarize(m_Passes[passIdx].GPU.GetSamples()); }
+
+		// One row per pass and source with the summary statistics. Sources without samples are left out.
+		auto WriteCSV(std::string const& fileName) const -> void;
+
+		// Summary statistics plus the raw samples of every pass.
+		auto WriteJSON(std::string const& fileName) const -> void;
+
+	private:
+		struct Pass {
+			std::string Name;
+			SampleRing  CPU;
+			SampleRing  GPU;
+		};
+
+	private:
+		std::vector<Pass> m_Passes;
+	};
+
+}
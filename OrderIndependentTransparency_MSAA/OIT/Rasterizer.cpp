@@ -0,0 +1,132 @@
+#include "Rasterizer.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace OIT {
+
+	auto CreateDefaultScene() -> Scene {
+		Scene scene;
+		{
+			float const vertexPositions[3][2] = { { -0.5f, -0.5f }, { +0.5f, -0.5f }, { +0.0f, +0.5f } };
+			Color4 const vertexColors[3] = { { 1.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } };
+			float const instancePositionOffsets[5][2] = { { 0.0f, 0.0f }, { 0.5f, 0.5f }, { -0.5f, -0.5f }, { -0.5f, 0.5f }, { 0.5f, -0.5f } };
+
+			for (auto const& offset : instancePositionOffsets) {
+				Triangle triangle;
+				for (uint32_t vertexID = 0; vertexID < 3; vertexID++)
+					triangle.Vertices[vertexID] = { vertexPositions[vertexID][0] + offset[0], vertexPositions[vertexID][1] + offset[1], 0.8f, vertexColors[vertexID] };
+				scene.OpaqueTriangles.push_back(triangle);
+			}
+		}
+
+		{
+			float const positions[3][2] = { { +0.0f, +0.5f }, { +0.5f, -0.5f }, { -0.5f, -0.5f } };
+			Color4 const colors[3] = { { 1.0f, 0.0f, 0.0f, 0.5f }, { 0.0f, 1.0f, 0.0f, 0.5f }, { 0.0f, 0.0f, 1.0f, 0.5f } };
+			float const instancePositionOffsets[5][3] = { { 0.0f, 0.0f, 0.3f }, { 0.5f, 0.0f, 0.4f }, { -0.5f, 0.0f, 0.5f }, { 0.0f, 0.5f, 0.6f }, { 0.0f, -0.5f, 0.7f } };
+
+			for (auto const& offset : instancePositionOffsets) {
+				Triangle triangle;
+				for (uint32_t vertexID = 0; vertexID < 3; vertexID++)
+					triangle.Vertices[vertexID] = { positions[vertexID][0] + offset[0], positions[vertexID][1] + offset[1], offset[2], colors[vertexID] };
+				scene.TransparentTriangles.push_back(triangle);
+			}
+		}
+		return scene;
+	}
+
+	auto GetStandardSamplePositions(uint32_t sampleCount) -> std::array<std::array<int32_t, 2>, MAX_MSAA_SAMPLES> {
+		switch (sampleCount) {
+			case 1:
+				return { { { 0, 0 } } };
+			case 2:
+				return { { { 4, 4 }, { -4, -4 } } };
+			case 4:
+				return { { { -2, -6 }, { 6, -2 }, { -6, 2 }, { 2, 6 } } };
+			case 8:
+				return { { { 1, -3 }, { -1, 3 }, { 5, 1 }, { -3, -5 }, { -5, 5 }, { -7, -1 }, { 3, 7 }, { 7, -7 } } };
+			default:
+				throw std::invalid_argument("Unsupported MSAA sample count");
+		}
+	}
+
+	auto Rasterizer::Setup(std::vector<Triangle> const& triangles, CullMode cullMode, uint32_t width, uint32_t height, uint32_t sampleCount) -> void {
+		m_Width = width;
+		m_Height = height;
+		m_SampleCount = sampleCount;
+		m_TileCountX = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+		m_TileCountY = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+
+		auto const samplePositions = GetStandardSamplePositions(sampleCount);
+		for (uint32_t sampleIdx = 0; sampleIdx < MAX_MSAA_SAMPLES; sampleIdx++) {
+			m_SampleOffsetX[sampleIdx] = samplePositions[sampleIdx][0] * (SUBPIXEL_SCALE / 16);
+			m_SampleOffsetY[sampleIdx] = samplePositions[sampleIdx][1] * (SUBPIXEL_SCALE / 16);
+		}
+
+		m_Triangles.clear();
+		m_Bins.resize(GetTileCount());
+		for (auto& bin : m_Bins)
+			bin.clear();
+
+		for (auto const& triangle : triangles) {
+			int64_t x[3] = {};
+			int64_t y[3] = {};
+			for (uint32_t vertexID = 0; vertexID < 3; vertexID++) {
+				auto const& vertex = triangle.Vertices[vertexID];
+				x[vertexID] = std::llround((vertex.X + 1.0) * 0.5 * width * SUBPIXEL_SCALE);
+				y[vertexID] = std::llround((1.0 - vertex.Y) * 0.5 * height * SUBPIXEL_SCALE);
+			}
+
+			// Edge function of a -> b evaluated at c, y pointing down. Negative area is counter-clockwise on the
+			// render target, which is the front face with FrontCounterClockwise = true.
+			auto const area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+			if (area == 0 || (cullMode == CullMode::Back && area > 0))
+				continue;
+
+			uint32_t order[3] = { 0, 1, 2 };
+			if (area < 0)
+				std::swap(order[1], order[2]);
+
+			RasterTriangle raster = {};
+			for (uint32_t vertexID = 0; vertexID < 3; vertexID++) {
+				raster.Z[vertexID] = triangle.Vertices[order[vertexID]].Z;
+				raster.Colors[vertexID] = triangle.Vertices[order[vertexID]].Color;
+			}
+
+			// Edge i is opposite to vertex i, so its value at a point is the unnormalized barycentric of vertex i.
+			for (uint32_t edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+				auto const a = order[(edgeIdx + 1) % 3];
+				auto const b = order[(edgeIdx + 2) % 3];
+				auto const dx = x[b] - x[a];
+				auto const dy = y[b] - y[a];
+				raster.EdgeA[edgeIdx] = -dy;
+				raster.EdgeB[edgeIdx] = dx;
+				raster.EdgeC[edgeIdx] = dy * x[a] - dx * y[a];
+
+				auto const isTopLeft = (dy == 0 && dx > 0) || dy < 0;
+				raster.EdgeBias[edgeIdx] = isTopLeft ? 0 : -1;
+			}
+			raster.InvArea = 1.0f / static_cast<float>(std::abs(area));
+
+			auto const minX = std::min({ x[0], x[1], x[2] });
+			auto const minY = std::min({ y[0], y[1], y[2] });
+			auto const maxX = std::max({ x[0], x[1], x[2] });
+			auto const maxY = std::max({ y[0], y[1], y[2] });
+			raster.MinX = static_cast<int32_t>(std::max<int64_t>(minX / SUBPIXEL_SCALE, 0));
+			raster.MinY = static_cast<int32_t>(std::max<int64_t>(minY / SUBPIXEL_SCALE, 0));
+			raster.MaxX = static_cast<int32_t>(std::min<int64_t>(maxX / SUBPIXEL_SCALE, static_cast<int64_t>(width) - 1));
+			raster.MaxY = static_cast<int32_t>(std::min<int64_t>(maxY / SUBPIXEL_SCALE, static_cast<int64_t>(height) - 1));
+			if (raster.MinX > raster.MaxX || raster.MinY > raster.MaxY)
+				continue;
+
+			auto const triangleIdx = static_cast<uint32_t>(m_Triangles.size());
+			m_Triangles.push_back(raster);
+
+			for (auto tileY = raster.MinY / RASTER_TILE_SIZE; tileY <= raster.MaxY / RASTER_TILE_SIZE; tileY++)
+				for (auto tileX = raster.MinX / RASTER_TILE_SIZE; tileX <= raster.MaxX / RASTER_TILE_SIZE; tileX++)
+					m_Bins[tileY * m_TileCountX + tileX].push_back(triangleIdx);
+		}
+	}
+
+}
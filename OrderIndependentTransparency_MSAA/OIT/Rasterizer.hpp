@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	constexpr uint32_t RASTER_TILE_SIZE = 32;
+	constexpr int64_t  SUBPIXEL_BITS    = 8;
+	constexpr int64_t  SUBPIXEL_SCALE   = int64_t(1) << SUBPIXEL_BITS;
+
+	// Normalized device coordinates with an implicit w of 1, like the SV_Position written by the VSMain entry points.
+	struct Vertex {
+		float  X;
+		float  Y;
+		float  Z;
+		Color4 Color;
+	};
+
+	struct Triangle {
+		Vertex Vertices[3];
+	};
+
+	struct Scene {
+		std::vector<Triangle> OpaqueTriangles;
+		std::vector<Triangle> TransparentTriangles;
+	};
+
+	enum class CullMode {
+		None,
+		Back
+	};
+
+	// Per-pixel rasterizer output. Depth and Color are evaluated at the pixel center (SV_Position.z and TEXCOORD
+	// of the pixel shader), SampleDepths at the standard MSAA sample locations. Primitive grows with the submission
+	// order of the triangle, like SV_PrimitiveID.
+	struct Fragment {
+		uint32_t X;
+		uint32_t Y;
+		uint32_t Primitive;
+		float    Depth;
+		Color4   Color;
+		uint32_t Coverage;
+		float    SampleDepths[MAX_MSAA_SAMPLES];
+	};
+
+	struct RasterTriangle {
+		int64_t  EdgeA[3];
+		int64_t  EdgeB[3];
+		int64_t  EdgeC[3];
+		int64_t  EdgeBias[3];
+		float    InvArea;
+		float    Z[3];
+		Color4   Colors[3];
+		int32_t  MinX;
+		int32_t  MinY;
+		int32_t  MaxX;
+		int32_t  MaxY;
+	};
+
+	// Triangles made of the DrawInstanced(3, 5, 0, 0) calls issued by main() with the instance tables of
+	// OpaqueGeometry.hlsl and TransparentGeometry.hlsl.
+	auto CreateDefaultScene() -> Scene;
+
+	// D3D11 standard sample pattern offsets from the pixel center in 1/16 pixel units.
+	auto GetStandardSamplePositions(uint32_t sampleCount) -> std::array<std::array<int32_t, 2>, MAX_MSAA_SAMPLES>;
+
+	class Rasterizer {
+	public:
+		auto Setup(std::vector<Triangle> const& triangles, CullMode cullMode, uint32_t width, uint32_t height, uint32_t sampleCount) -> void;
+
+		auto GetTileCount() const -> uint32_t { return m_TileCountX * m_TileCountY; }
+
+		auto GetTileCountX() const -> uint32_t { return m_TileCountX; }
+
+		auto GetTileCountY() const -> uint32_t { return m_TileCountY; }
+
+		// Invokes visitor(Fragment const&) for every pixel of the tile touched by a binned triangle, in submission order.
+		template<typename Visitor>
+		auto RasterizeTile(uint32_t tileIdx, Visitor&& visitor) const -> void;
+
+	private:
+		std::vector<RasterTriangle>        m_Triangles;
+		std::vector<std::vector<uint32_t>> m_Bins;
+		std::array<int64_t, MAX_MSAA_SAMPLES> m_SampleOffsetX = {};
+		std::array<int64_t, MAX_MSAA_SAMPLES> m_SampleOffsetY = {};
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_SampleCount = 1;
+		uint32_t m_TileCountX = 0;
+		uint32_t m_TileCountY = 0;
+	};
+
+	template<typename Visitor>
+	auto Rasterizer::RasterizeTile(uint32_t tileIdx, Visitor&& visitor) const -> void {
+		auto const tileMinX = static_cast<int32_t>((tileIdx % m_TileCountX) * RASTER_TILE_SIZE);
+		auto const tileMinY = static_cast<int32_t>((tileIdx / m_TileCountX) * RASTER_TILE_SIZE);
+		auto const tileMaxX = std::min(tileMinX + static_cast<int32_t>(RASTER_TILE_SIZE), static_cast<int32_t>(m_Width)) - 1;
+		auto const tileMaxY = std::min(tileMinY + static_cast<int32_t>(RASTER_TILE_SIZE), static_cast<int32_t>(m_Height)) - 1;
+
+		Fragment fragment = {};
+		for (auto const triangleIdx : m_Bins[tileIdx]) {
+			auto const& triangle = m_Triangles[triangleIdx];
+			auto const minX = std::max(triangle.MinX, tileMinX);
+			auto const minY = std::max(triangle.MinY, tileMinY);
+			auto const maxX = std::min(triangle.MaxX, tileMaxX);
+			auto const maxY = std::min(triangle.MaxY, tileMaxY);
+
+			for (int32_t y = minY; y <= maxY; y++) {
+				for (int32_t x = minX; x <= maxX; x++) {
+					auto const centerX = x * SUBPIXEL_SCALE + SUBPIXEL_SCALE / 2;
+					auto const centerY = y * SUBPIXEL_SCALE + SUBPIXEL_SCALE / 2;
+
+					uint32_t coverage = 0;
+					for (uint32_t sampleIdx = 0; sampleIdx < m_SampleCount; sampleIdx++) {
+						auto const px = centerX + m_SampleOffsetX[sampleIdx];
+						auto const py = centerY + m_SampleOffsetY[sampleIdx];
+						auto const w0 = triangle.EdgeA[0] * px + triangle.EdgeB[0] * py + triangle.EdgeC[0];
+						auto const w1 = triangle.EdgeA[1] * px + triangle.EdgeB[1] * py + triangle.EdgeC[1];
+						auto const w2 = triangle.EdgeA[2] * px + triangle.EdgeB[2] * py + triangle.EdgeC[2];
+						if (((w0 + triangle.EdgeBias[0]) | (w1 + triangle.EdgeBias[1]) | (w2 + triangle.EdgeBias[2])) < 0)
+							continue;
+
+						auto const depth = (static_cast<float>(w0) * triangle.Z[0] + static_cast<float>(w1) * triangle.Z[1] + static_cast<float>(w2) * triangle.Z[2]) * triangle.InvArea;
+						if (depth < 0.0f || depth > 1.0f)
+							continue;
+
+						fragment.SampleDepths[sampleIdx] = depth;
+						coverage |= 1u << sampleIdx;
+					}
+
+					if (coverage == 0)
+						continue;
+
+					auto const b0 = static_cast<float>(triangle.EdgeA[0] * centerX + triangle.EdgeB[0] * centerY + triangle.EdgeC[0]) * triangle.InvArea;
+					auto const b1 = static_cast<float>(triangle.EdgeA[1] * centerX + triangle.EdgeB[1] * centerY + triangle.EdgeC[1]) * triangle.InvArea;
+					auto const b2 = static_cast<float>(triangle.EdgeA[2] * centerX + triangle.EdgeB[2] * centerY + triangle.EdgeC[2]) * triangle.InvArea;
+
+					fragment.X = static_cast<uint32_t>(x);
+					fragment.Y = static_cast<uint32_t>(y);
+					fragment.Primitive = triangleIdx;
+					fragment.Coverage = coverage;
+					fragment.Depth = Saturate(b0 * triangle.Z[0] + b1 * triangle.Z[1] + b2 * triangle.Z[2]);
+					fragment.Color.R = b0 * triangle.Colors[0].R + b1 * triangle.Colors[1].R + b2 * triangle.Colors[2].R;
+					fragment.Color.G = b0 * triangle.Colors[0].G + b1 * triangle.Colors[1].G + b2 * triangle.Colors[2].G;
+					fragment.Color.B = b0 * triangle.Colors[0].B + b1 * triangle.Colors[1].B + b2 * triangle.Colors[2].B;
+					fragment.Color.A = b0 * triangle.Colors[0].A + b1 * triangle.Colors[1].A + b2 * triangle.Colors[2].A;
+					visitor(static_cast<Fragment const&>(fragment));
+				}
+			}
+		}
+	}
+
+}
@@ -0,0 +1,375 @@
+#include "Resolve.hpp"
+#include "SortingNetwork.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#if defined(OIT_ENABLE_X86_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace OIT {
+
+	namespace {
+
+		// Back-to-front order of CSMain. Short lists go through a sorting network that breaks depth ties by the
+		// original position, which makes its result identical to the stable insertion sort.
+		template<typename NodeType>
+		auto SortNodes(NodeType* nodes, uint32_t count, bool useSortingNetworks) -> void {
+			uint8_t order[SORTING_NETWORK_MAX_COUNT];
+			std::iota(order, order + SORTING_NETWORK_MAX_COUNT, uint8_t(0));
+			auto const CompareExchange = [&](uint32_t a, uint32_t b) -> void {
+				auto const nodeA = nodes[a];
+				auto const nodeB = nodes[b];
+				auto const orderA = order[a];
+				auto const orderB = order[b];
+				auto const isSwap = nodeA.Depth < nodeB.Depth || (nodeA.Depth == nodeB.Depth && orderB < orderA);
+				nodes[a] = isSwap ? nodeB : nodeA;
+				nodes[b] = isSwap ? nodeA : nodeB;
+				order[a] = isSwap ? orderB : orderA;
+				order[b] = isSwap ? orderA : orderB;
+			};
+			if (useSortingNetworks && DispatchSortingNetwork(count, CompareExchange))
+				return;
+
+			for (uint32_t i = 1; i < count; i++) {
+				auto const t = nodes[i];
+				auto j = i;
+				while (j > 0 && (nodes[j - 1].Depth < t.Depth)) {
+					nodes[j] = nodes[j - 1];
+					j--;
+				}
+				nodes[j] = t;
+			}
+		}
+
+		// ResolveMode::FrontToBack over nodes sorted back to front, returns the sum of the samples. Walking them from
+		// the end keeps the order of equal depths mirrored, so ties land on top of each other as in the back to front
+		// blend. Stops once no sample lets more than TransmittanceEpsilon of the nodes behind through.
+		auto CompositeFrontToBack(ResolveContext const& context, ListSubNodeMS const* nodes, uint32_t count, Color4 const& backBuffer) -> Color4 {
+			Color4 accumulated[MAX_MSAA_SAMPLES];
+			float transmittance[MAX_MSAA_SAMPLES];
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+				accumulated[sampleIdx] = Color4{ 0.0f, 0.0f, 0.0f, 0.0f };
+				transmittance[sampleIdx] = 1.0f;
+			}
+
+			for (auto index = count; index-- > 0;) {
+				auto const& node = nodes[index];
+				auto const srcPixelColor = UnpackColor(node.Color);
+				auto maxTransmittance = 0.0f;
+				for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+					if (node.Coverage & (1u << sampleIdx)) {
+						accumulated[sampleIdx] = accumulated[sampleIdx] + srcPixelColor * (transmittance[sampleIdx] * srcPixelColor.A);
+						transmittance[sampleIdx] *= 1.0f - srcPixelColor.A;
+					}
+					maxTransmittance = std::max(maxTransmittance, transmittance[sampleIdx]);
+				}
+				if (maxTransmittance < context.TransmittanceEpsilon)
+					break;
+			}
+
+			auto resolveBuffer = Color4{ 0.0f, 0.0f, 0.0f, 0.0f };
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++)
+				resolveBuffer = resolveBuffer + accumulated[sampleIdx] + backBuffer * transmittance[sampleIdx];
+			return resolveBuffer;
+		}
+
+		auto ResolvePixelPerSample(ResolveContext const& context, uint32_t x, uint32_t y, ResolveStatistics& statistics) -> void {
+			auto const pixelIdx = y * context.Width + x;
+
+			auto const backBuffer = LoadTexel(context.pBackBuffer[pixelIdx]);
+			auto resolveBuffer = Color4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+			auto const nodeHead = context.pHeadPointers[context.Heads.GetSlot(x, y)].load(std::memory_order_relaxed);
+			if (nodeHead == INVALID_NODE_INDEX)
+				return;
+
+			statistics.ResolvedPixels++;
+
+			ListSubNode nodes[MAX_FRAGMENT_COUNT];
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+
+				uint32_t count = 0;
+				uint32_t nodeIdx = nodeHead;
+
+				while (nodeIdx != INVALID_NODE_INDEX && count < context.FragmentCount) {
+					auto const link = context.pLinkedList->LoadLink(nodeIdx);
+					statistics.NodesFetched++;
+					if (link.Coverage & (1u << sampleIdx)) {
+						auto const node = context.pLinkedList->LoadPayload(nodeIdx, link);
+						nodes[count].Depth = AsFloat(node.Depth);
+						nodes[count].Color = node.Color;
+						count++;
+					}
+					nodeIdx = link.Next;
+				}
+
+				SortNodes(nodes, count, context.UseSortingNetworks);
+
+				auto dstPixelColor = backBuffer;
+				for (uint32_t index = 0; index < count; index++)
+					dstPixelColor = BlendListSubNode(dstPixelColor, nodes[index]);
+				resolveBuffer = resolveBuffer + dstPixelColor;
+			}
+			context.pBackBuffer[pixelIdx] = StoreTexel(resolveBuffer / static_cast<float>(context.MSAASamples));
+		}
+
+		auto ResolvePixelSingleTraversal(ResolveContext const& context, uint32_t x, uint32_t y, ResolveStatistics& statistics) -> void {
+			auto const pixelIdx = y * context.Width + x;
+
+			auto const backBuffer = LoadTexel(context.pBackBuffer[pixelIdx]);
+			auto resolveBuffer = Color4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+			auto const nodeHead = context.pHeadPointers[context.Heads.GetSlot(x, y)].load(std::memory_order_relaxed);
+			if (nodeHead == INVALID_NODE_INDEX)
+				return;
+
+			statistics.ResolvedPixels++;
+
+			ListSubNodeMS nodes[MAX_FRAGMENT_COUNT];
+			uint32_t count = 0;
+			uint32_t nodeIdx = nodeHead;
+
+			while (nodeIdx != INVALID_NODE_INDEX && count < context.FragmentCount) {
+				auto const node = context.pLinkedList->LoadPayload(nodeIdx, context.pLinkedList->LoadLink(nodeIdx));
+				nodes[count].Depth = AsFloat(node.Depth);
+				nodes[count].Color = node.Color;
+				nodes[count].Coverage = node.Coverage;
+				count++;
+				nodeIdx = node.Next;
+			}
+			statistics.NodesFetched += count;
+
+			SortNodes(nodes, count, context.UseSortingNetworks);
+			if (context.Mode == ResolveMode::FrontToBack) {
+				context.pBackBuffer[pixelIdx] = StoreTexel(CompositeFrontToBack(context, nodes, count, backBuffer) / static_cast<float>(context.MSAASamples));
+				return;
+			}
+
+			Color4 dstPixelColors[MAX_MSAA_SAMPLES];
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++)
+				dstPixelColors[sampleIdx] = backBuffer;
+
+			for (uint32_t index = 0; index < count; index++) {
+				auto const srcPixelColor = UnpackColor(nodes[index].Color);
+				for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++)
+					if (nodes[index].Coverage & (1u << sampleIdx))
+						dstPixelColors[sampleIdx] = Lerp(dstPixelColors[sampleIdx], srcPixelColor, srcPixelColor.A);
+			}
+
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++)
+				resolveBuffer = resolveBuffer + dstPixelColors[sampleIdx];
+			context.pBackBuffer[pixelIdx] = StoreTexel(resolveBuffer / static_cast<float>(context.MSAASamples));
+		}
+
+		auto ResolveArrayPixelPerSample(ResolveContext const& context, uint32_t x, uint32_t y, ResolveStatistics& statistics) -> void {
+			auto const pixelIdx = y * context.Width + x;
+			auto const slot = context.FragmentSlots.GetSlot(x, y);
+			auto const begin = context.pFragmentOffsets[slot];
+			auto const end = context.pFragmentOffsets[slot + 1];
+			if (begin == end)
+				return;
+
+			statistics.ResolvedPixels++;
+
+			auto const backBuffer = LoadTexel(context.pBackBuffer[pixelIdx]);
+			auto resolveBuffer = Color4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+			ListSubNode nodes[MAX_FRAGMENT_COUNT];
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+				uint32_t count = 0;
+				for (auto fragmentIdx = begin; fragmentIdx < end && count < context.FragmentCount; fragmentIdx++) {
+					auto const& fragment = context.pFragments[fragmentIdx];
+					statistics.NodesFetched++;
+					if (fragment.Coverage & (1u << sampleIdx)) {
+						nodes[count].Depth = fragment.Depth;
+						nodes[count].Color = fragment.Color;
+						count++;
+					}
+				}
+
+				SortNodes(nodes, count, context.UseSortingNetworks);
+
+				auto dstPixelColor = backBuffer;
+				for (uint32_t index = 0; index < count; index++)
+					dstPixelColor = BlendListSubNode(dstPixelColor, nodes[index]);
+				resolveBuffer = resolveBuffer + dstPixelColor;
+			}
+			context.pBackBuffer[pixelIdx] = StoreTexel(resolveBuffer / static_cast<float>(context.MSAASamples));
+		}
+
+		auto ResolveArrayPixelSingleTraversal(ResolveContext const& context, uint32_t x, uint32_t y, ResolveStatistics& statistics) -> void {
+			auto const pixelIdx = y * context.Width + x;
+			auto const slot = context.FragmentSlots.GetSlot(x, y);
+			auto const begin = context.pFragmentOffsets[slot];
+			auto const count = std::min(context.pFragmentOffsets[slot + 1] - begin, context.FragmentCount);
+			if (count == 0)
+				return;
+
+			statistics.ResolvedPixels++;
+			statistics.NodesFetched += count;
+
+			auto const backBuffer = LoadTexel(context.pBackBuffer[pixelIdx]);
+			auto resolveBuffer = Color4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+			ListSubNodeMS nodes[MAX_FRAGMENT_COUNT];
+			std::copy_n(&context.pFragments[begin], count, nodes);
+			SortNodes(nodes, count, context.UseSortingNetworks);
+			if (context.Mode == ResolveMode::FrontToBack) {
+				context.pBackBuffer[pixelIdx] = StoreTexel(CompositeFrontToBack(context, nodes, count, backBuffer) / static_cast<float>(context.MSAASamples));
+				return;
+			}
+
+			Color4 dstPixelColors[MAX_MSAA_SAMPLES];
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++)
+				dstPixelColors[sampleIdx] = backBuffer;
+
+			for (uint32_t index = 0; index < count; index++) {
+				auto const srcPixelColor = UnpackColor(nodes[index].Color);
+				for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++)
+					if (nodes[index].Coverage & (1u << sampleIdx))
+						dstPixelColors[sampleIdx] = Lerp(dstPixelColors[sampleIdx], srcPixelColor, srcPixelColor.A);
+			}
+
+			for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++)
+				resolveBuffer = resolveBuffer + dstPixelColors[sampleIdx];
+			context.pBackBuffer[pixelIdx] = StoreTexel(resolveBuffer / static_cast<float>(context.MSAASamples));
+		}
+
+#if defined(OIT_ENABLE_X86_SIMD)
+		auto IsCpuFeaturePresent(InstructionSet instructionSet) -> bool {
+#if defined(_MSC_VER)
+			int info[4] = {};
+			__cpuid(info, 1);
+			auto const hasSSE42 = (info[2] & (1 << 20)) != 0;
+			auto const hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+			auto const xcr0 = hasOSXSAVE ? _xgetbv(0) : 0;
+			__cpuidex(info, 7, 0);
+			auto const hasAVX2 = hasOSXSAVE && (info[1] & (1 << 5)) != 0 && (xcr0 & 0x06) == 0x06;
+			auto const hasAVX512 = hasOSXSAVE && (info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6;
+			switch (instructionSet) {
+				case InstructionSet::SSE42:  return hasSSE42;
+				case InstructionSet::AVX2:   return hasAVX2;
+				case InstructionSet::AVX512: return hasAVX512;
+				default:                     return true;
+			}
+#else
+			__builtin_cpu_init();
+			switch (instructionSet) {
+				case InstructionSet::SSE42:  return __builtin_cpu_supports("sse4.2");
+				case InstructionSet::AVX2:   return __builtin_cpu_supports("avx2");
+				case InstructionSet::AVX512: return __builtin_cpu_supports("avx512f");
+				default:                     return true;
+			}
+#endif
+		}
+#endif
+
+	}
+
+	auto ResolveGroupScalar(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		auto const maxX = std::min(minX + RESOLVE_GROUP_SIZE, context.Width);
+		auto const maxY = std::min(minY + RESOLVE_GROUP_SIZE, context.Height);
+		auto const pResolvePixel = context.Mode == ResolveMode::PerSample ? &ResolvePixelPerSample : &ResolvePixelSingleTraversal;
+		for (auto y = minY; y < maxY; y++)
+			for (auto x = minX; x < maxX; x++)
+				pResolvePixel(context, x, y, statistics);
+	}
+
+	auto ResolveArrayGroup(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		auto const maxX = std::min(minX + RESOLVE_GROUP_SIZE, context.Width);
+		auto const maxY = std::min(minY + RESOLVE_GROUP_SIZE, context.Height);
+		auto const pResolvePixel = context.Mode == ResolveMode::PerSample ? &ResolveArrayPixelPerSample : &ResolveArrayPixelSingleTraversal;
+		for (auto y = minY; y < maxY; y++)
+			for (auto x = minX; x < maxX; x++)
+				pResolvePixel(context, x, y, statistics);
+	}
+
+	auto IsInstructionSetSupported(InstructionSet instructionSet) -> bool {
+		switch (instructionSet) {
+			case InstructionSet::Auto:
+			case InstructionSet::Scalar:
+				return true;
+#if defined(OIT_ENABLE_X86_SIMD)
+			case InstructionSet::SSE42:
+			case InstructionSet::AVX2:
+			case InstructionSet::AVX512:
+				return IsCpuFeaturePresent(instructionSet);
+#endif
+			default:
+				return false;
+		}
+	}
+
+	auto SelectInstructionSet(InstructionSet requested) -> InstructionSet {
+		if (requested == InstructionSet::Auto) {
+			for (auto const candidate : { InstructionSet::AVX512, InstructionSet::AVX2, InstructionSet::SSE42 })
+				if (IsInstructionSetSupported(candidate))
+					return candidate;
+			return InstructionSet::Scalar;
+		}
+
+		if (!IsInstructionSetSupported(requested))
+			throw std::runtime_error(std::string("Instruction set is not supported: ") + ToString(requested));
+		return requested;
+	}
+
+	auto GetResolveGroupFunction(InstructionSet instructionSet) -> ResolveGroupFunction {
+		switch (SelectInstructionSet(instructionSet)) {
+#if defined(OIT_ENABLE_X86_SIMD)
+			case InstructionSet::SSE42:  return &ResolveGroupSSE42;
+			case InstructionSet::AVX2:   return &ResolveGroupAVX2;
+			case InstructionSet::AVX512: return &ResolveGroupAVX512;
+#endif
+			default:                     return &ResolveGroupScalar;
+		}
+	}
+
+	auto GetResolveArrayGroupFunction(InstructionSet instructionSet) -> ResolveGroupFunction {
+		switch (SelectInstructionSet(instructionSet)) {
+#if defined(OIT_ENABLE_X86_SIMD)
+			case InstructionSet::SSE42:  return &ResolveArrayGroupSSE42;
+			case InstructionSet::AVX2:   return &ResolveArrayGroupAVX2;
+			case InstructionSet::AVX512: return &ResolveArrayGroupAVX512;
+#endif
+			default:                     return &ResolveArrayGroup;
+		}
+	}
+
+	auto ToString(InstructionSet instructionSet) -> char const* {
+		switch (instructionSet) {
+			case InstructionSet::Auto:   return "auto";
+			case InstructionSet::Scalar: return "scalar";
+			case InstructionSet::SSE42:  return "sse4.2";
+			case InstructionSet::AVX2:   return "avx2";
+			case InstructionSet::AVX512: return "avx512";
+			default:                     return "unknown";
+		}
+	}
+
+	auto ParseInstructionSet(std::string const& name) -> InstructionSet {
+		for (auto const candidate : { InstructionSet::Auto, InstructionSet::Scalar, InstructionSet::SSE42, InstructionSet::AVX2, InstructionSet::AVX512 })
+			if (name == ToString(candidate))
+				return candidate;
+		throw std::invalid_argument("Unknown instruction set: " + name);
+	}
+
+	auto ToString(ResolveMode mode) -> char const* {
+		switch (mode) {
+			case ResolveMode::PerSample:       return "per-sample";
+			case ResolveMode::SingleTraversal: return "single";
+			case ResolveMode::FrontToBack:     return "front-to-back";
+			default:                           return "unknown";
+		}
+	}
+
+	auto ParseResolveMode(std::string const& name) -> ResolveMode {
+		for (auto const candidate : { ResolveMode::PerSample, ResolveMode::SingleTraversal, ResolveMode::FrontToBack })
+			if (name == ToString(candidate))
+				return candidate;
+		throw std::invalid_argument("Unknown resolve mode: " + name);
+	}
+
+}
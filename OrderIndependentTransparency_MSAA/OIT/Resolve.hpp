@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "Common.hpp"
+#include "HeadAddressing.hpp"
+#include "NodeEncoding.hpp"
+
+namespace OIT {
+
+	enum class InstructionSet {
+		Auto,
+		Scalar,
+		SSE42,
+		AVX2,
+		AVX512
+	};
+
+	enum class ResolveMode {
+		// CSMain as written: walk and sort the list once per MSAA sample.
+		PerSample,
+		// Walk and sort the list once, then blend every sample in one ordered pass that tests the Coverage mask.
+		// Identical to PerSample as long as a list holds at most FragmentCount nodes; longer lists are truncated
+		// to their first FragmentCount nodes instead of the first FragmentCount nodes covering each sample.
+		SingleTraversal,
+		// Walks and sorts the list like SingleTraversal, then composites front to back and stops once the transmittance
+		// of every sample has dropped below ResolveContext::TransmittanceEpsilon. Matches SingleTraversal up to the
+		// hidden remainder and rounding.
+		FrontToBack
+	};
+
+	struct ResolveStatistics {
+		uint64_t ResolvedPixels = 0;
+		uint64_t NodesFetched   = 0;
+	};
+
+	// Inputs of one CSMain dispatch.
+	struct ResolveContext {
+		std::atomic<uint32_t> const* pHeadPointers        = nullptr;
+		HeadAddressing               Heads;
+		ListNodeBuffer const*        pLinkedList          = nullptr;
+		// Contiguous layout of TransparencyMethod::PrefixSum and the node compaction instead of the lists: the
+		// fragments of the pixel in slot s are pFragments[pFragmentOffsets[s], pFragmentOffsets[s + 1]), newest first
+		// like a list.
+		HeadAddressing               FragmentSlots;
+		uint32_t const*              pFragmentOffsets     = nullptr;
+		ListSubNodeMS const*         pFragments           = nullptr;
+		uint32_t*                    pBackBuffer          = nullptr;
+		uint32_t                     Width                = 0;
+		uint32_t                     Height               = 0;
+		uint32_t                     MSAASamples          = 0;
+		uint32_t                     FragmentCount        = 0;
+		ResolveMode                  Mode                 = ResolveMode::PerSample;
+		bool                         UseSortingNetworks   = false;
+		// Transmittance below which ResolveMode::FrontToBack ignores the nodes further back.
+		float                        TransmittanceEpsilon = 0.0f;
+	};
+
+	// Resolves the RESOLVE_GROUP_SIZE x RESOLVE_GROUP_SIZE thread group whose top-left pixel is (minX, minY).
+	using ResolveGroupFunction = void (*)(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics);
+
+	auto ResolveGroupScalar(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	// CSResolve of FragmentArrays.hlsl: the same sort and blend over the contiguous layout, a linear read per pixel.
+	auto ResolveArrayGroup(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	// Vector kernels, 4/8/16 pixels per lane group. They are only compiled on x86 targets.
+	auto ResolveGroupSSE42(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	auto ResolveGroupAVX2(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	auto ResolveGroupAVX512(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	auto ResolveArrayGroupSSE42(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	auto ResolveArrayGroupAVX2(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	auto ResolveArrayGroupAVX512(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void;
+
+	auto IsInstructionSetSupported(InstructionSet instructionSet) -> bool;
+
+	// Resolves Auto to the widest supported instruction set and rejects unsupported explicit requests.
+	auto SelectInstructionSet(InstructionSet requested) -> InstructionSet;
+
+	auto GetResolveGroupFunction(InstructionSet instructionSet) -> ResolveGroupFunction;
+
+	// Same for the contiguous fragment arrays of TransparencyMethod::PrefixSum and the node compaction.
+	auto GetResolveArrayGroupFunction(InstructionSet instructionSet) -> ResolveGroupFunction;
+
+	auto ToString(InstructionSet instructionSet) -> char const*;
+
+	auto ParseInstructionSet(std::string const& name) -> InstructionSet;
+
+	auto ToString(ResolveMode mode) -> char const*;
+
+	auto ParseResolveMode(std::string const& name) -> ResolveMode;
+
+}
@@ -0,0 +1,58 @@
+#include <immintrin.h>
+
+#include "ResolveSIMD.inl"
+
+namespace OIT {
+
+	namespace {
+
+		struct VectorAVX2 {
+			static constexpr uint32_t LANE_COUNT = 8;
+
+			using Float = __m256;
+			using Int   = __m256i;
+			using Mask  = __m256;
+
+			static auto SetF(float value) -> Float { return _mm256_set1_ps(value); }
+			static auto SetI(uint32_t value) -> Int { return _mm256_set1_epi32(static_cast<int32_t>(value)); }
+			static auto LoadF(float const* pData) -> Float { return _mm256_load_ps(pData); }
+			static auto LoadI(uint32_t const* pData) -> Int { return _mm256_load_si256(reinterpret_cast<__m256i const*>(pData)); }
+			static auto StoreF(float* pData, Float value) -> void { _mm256_store_ps(pData, value); }
+			static auto StoreI(uint32_t* pData, Int value) -> void { _mm256_store_si256(reinterpret_cast<__m256i*>(pData), value); }
+
+			static auto Add(Float a, Float b) -> Float { return _mm256_add_ps(a, b); }
+			static auto Sub(Float a, Float b) -> Float { return _mm256_sub_ps(a, b); }
+			static auto Mul(Float a, Float b) -> Float { return _mm256_mul_ps(a, b); }
+			static auto Div(Float a, Float b) -> Float { return _mm256_div_ps(a, b); }
+			static auto Min(Float a, Float b) -> Float { return _mm256_min_ps(a, b); }
+			static auto Max(Float a, Float b) -> Float { return _mm256_max_ps(a, b); }
+
+			static auto AndI(Int a, Int b) -> Int { return _mm256_and_si256(a, b); }
+			static auto OrI(Int a, Int b) -> Int { return _mm256_or_si256(a, b); }
+			static auto ShiftLeftI(Int a, int shift) -> Int { return _mm256_slli_epi32(a, shift); }
+			static auto ShiftRightI(Int a, int shift) -> Int { return _mm256_srli_epi32(a, shift); }
+			static auto ToFloat(Int a) -> Float { return _mm256_cvtepi32_ps(a); }
+			static auto Truncate(Float a) -> Int { return _mm256_cvttps_epi32(a); }
+
+			static auto Less(Float a, Float b) -> Mask { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static auto Equal(Float a, Float b) -> Mask { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+			static auto LessI(Int a, Int b) -> Mask { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)); }
+			static auto AndMask(Mask a, Mask b) -> Mask { return _mm256_and_ps(a, b); }
+			static auto OrMask(Mask a, Mask b) -> Mask { return _mm256_or_ps(a, b); }
+			static auto AndNotMask(Mask a, Mask b) -> Mask { return _mm256_andnot_ps(b, a); }
+			static auto Any(Mask mask) -> bool { return _mm256_movemask_ps(mask) != 0; }
+			static auto Select(Mask mask, Float a, Float b) -> Float { return _mm256_blendv_ps(a, b, mask); }
+			static auto SelectI(Mask mask, Int a, Int b) -> Int { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), mask)); }
+		};
+
+	}
+
+	auto ResolveGroupAVX2(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		ResolveGroupSIMD<VectorAVX2>(context, minX, minY, statistics);
+	}
+
+	auto ResolveArrayGroupAVX2(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		ResolveGroupSIMD<VectorAVX2, true>(context, minX, minY, statistics);
+	}
+
+}
@@ -0,0 +1,58 @@
+#include <immintrin.h>
+
+#include "ResolveSIMD.inl"
+
+namespace OIT {
+
+	namespace {
+
+		struct VectorAVX512 {
+			static constexpr uint32_t LANE_COUNT = 16;
+
+			using Float = __m512;
+			using Int   = __m512i;
+			using Mask  = __mmask16;
+
+			static auto SetF(float value) -> Float { return _mm512_set1_ps(value); }
+			static auto SetI(uint32_t value) -> Int { return _mm512_set1_epi32(static_cast<int32_t>(value)); }
+			static auto LoadF(float const* pData) -> Float { return _mm512_load_ps(pData); }
+			static auto LoadI(uint32_t const* pData) -> Int { return _mm512_load_si512(pData); }
+			static auto StoreF(float* pData, Float value) -> void { _mm512_store_ps(pData, value); }
+			static auto StoreI(uint32_t* pData, Int value) -> void { _mm512_store_si512(pData, value); }
+
+			static auto Add(Float a, Float b) -> Float { return _mm512_add_ps(a, b); }
+			static auto Sub(Float a, Float b) -> Float { return _mm512_sub_ps(a, b); }
+			static auto Mul(Float a, Float b) -> Float { return _mm512_mul_ps(a, b); }
+			static auto Div(Float a, Float b) -> Float { return _mm512_div_ps(a, b); }
+			static auto Min(Float a, Float b) -> Float { return _mm512_min_ps(a, b); }
+			static auto Max(Float a, Float b) -> Float { return _mm512_max_ps(a, b); }
+
+			static auto AndI(Int a, Int b) -> Int { return _mm512_and_si512(a, b); }
+			static auto OrI(Int a, Int b) -> Int { return _mm512_or_si512(a, b); }
+			static auto ShiftLeftI(Int a, int shift) -> Int { return _mm512_slli_epi32(a, static_cast<unsigned>(shift)); }
+			static auto ShiftRightI(Int a, int shift) -> Int { return _mm512_srli_epi32(a, static_cast<unsigned>(shift)); }
+			static auto ToFloat(Int a) -> Float { return _mm512_cvtepi32_ps(a); }
+			static auto Truncate(Float a) -> Int { return _mm512_cvttps_epi32(a); }
+
+			static auto Less(Float a, Float b) -> Mask { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+			static auto Equal(Float a, Float b) -> Mask { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+			static auto LessI(Int a, Int b) -> Mask { return _mm512_cmplt_epi32_mask(a, b); }
+			static auto AndMask(Mask a, Mask b) -> Mask { return static_cast<Mask>(a & b); }
+			static auto OrMask(Mask a, Mask b) -> Mask { return static_cast<Mask>(a | b); }
+			static auto AndNotMask(Mask a, Mask b) -> Mask { return static_cast<Mask>(a & ~b); }
+			static auto Any(Mask mask) -> bool { return mask != 0; }
+			static auto Select(Mask mask, Float a, Float b) -> Float { return _mm512_mask_blend_ps(mask, a, b); }
+			static auto SelectI(Mask mask, Int a, Int b) -> Int { return _mm512_mask_blend_epi32(mask, a, b); }
+		};
+
+	}
+
+	auto ResolveGroupAVX512(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		ResolveGroupSIMD<VectorAVX512>(context, minX, minY, statistics);
+	}
+
+	auto ResolveArrayGroupAVX512(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		ResolveGroupSIMD<VectorAVX512, true>(context, minX, minY, statistics);
+	}
+
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+// Vectorized CSMain shared by ResolveSSE42.cpp, ResolveAVX2.cpp and ResolveAVX512.cpp. Every translation unit
+// provides a traits type V wrapping the intrinsics of its instruction set and is compiled with the matching target
+// flags, so nothing in here may be included from code that runs before the runtime ISA check.
+//
+// One lane resolves one pixel. The list walk, or the read of the pixel's range in the contiguous fragment arrays,
+// stays scalar, the fragments are gathered into structure-of-arrays scratch and the sort, color unpacking and blend
+// then run on whole lane groups. The arithmetic mirrors ResolvePixelPerSample, ResolvePixelSingleTraversal, their
+// array counterparts and CompositeFrontToBack in Resolve.cpp operation by operation, so the output is bit-identical
+// to the scalar path in every mode.
+
+#include <cstdint>
+#include <limits>
+
+#include "Resolve.hpp"
+#include "SortingNetwork.hpp"
+
+namespace OIT {
+
+	template<typename V, bool IS_ARRAY, ResolveMode MODE>
+	auto ResolveGroupSIMDImpl(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		constexpr bool IS_SINGLE_TRAVERSAL = MODE != ResolveMode::PerSample;
+		constexpr uint32_t LANE_COUNT = V::LANE_COUNT;
+		constexpr uint32_t BATCH_COUNT = (RESOLVE_GROUP_SIZE * RESOLVE_GROUP_SIZE) / LANE_COUNT;
+
+		alignas(64) float    depths[MAX_FRAGMENT_COUNT][LANE_COUNT];
+		alignas(64) uint32_t colors[MAX_FRAGMENT_COUNT][LANE_COUNT];
+		alignas(64) uint32_t coverages[IS_SINGLE_TRAVERSAL ? MAX_FRAGMENT_COUNT : 1][LANE_COUNT];
+		alignas(64) int32_t  counts[LANE_COUNT];
+		alignas(64) uint32_t texels[LANE_COUNT];
+		// List heads, or the fragment range [heads, ends) of the arrays.
+		uint32_t heads[LANE_COUNT];
+		uint32_t ends[LANE_COUNT];
+		uint32_t pixelIndices[LANE_COUNT];
+		bool     isResolved[LANE_COUNT];
+
+		auto const UnpackChannel = [](typename V::Int value, int shift) -> typename V::Float {
+			auto const channel = V::ToFloat(V::AndI(V::ShiftRightI(value, shift), V::SetI(0xFF)));
+			return V::Min(V::Max(V::Div(channel, V::SetF(255.0f)), V::SetF(0.0f)), V::SetF(1.0f));
+		};
+
+		auto const LoadChannel = [](typename V::Int value, int shift) -> typename V::Float {
+			return V::Div(V::ToFloat(V::AndI(V::ShiftRightI(value, shift), V::SetI(0xFF))), V::SetF(255.0f));
+		};
+
+		auto const StoreChannel = [](typename V::Float value, int shift) -> typename V::Int {
+			auto const saturated = V::Min(V::Max(value, V::SetF(0.0f)), V::SetF(1.0f));
+			return V::ShiftLeftI(V::Truncate(V::Add(V::Mul(saturated, V::SetF(255.0f)), V::SetF(0.5f))), shift);
+		};
+
+		auto const BlendChannel = [](typename V::Float dst, typename V::Float src, typename V::Float alpha, typename V::Mask mask) -> typename V::Float {
+			return V::Select(mask, dst, V::Add(dst, V::Mul(alpha, V::Sub(src, dst))));
+		};
+
+		// Walks every lane's list or fragment range and returns the longest gathered count. PerSample keeps only the
+		// nodes covering sampleMask, SingleTraversal keeps every node together with its coverage.
+		auto const GatherFragments = [&](uint32_t sampleMask) -> int32_t {
+			int32_t maxCount = 0;
+			for (uint32_t laneIdx = 0; laneIdx < LANE_COUNT; laneIdx++) {
+				int32_t count = 0;
+				if constexpr (IS_ARRAY) {
+					for (auto fragmentIdx = heads[laneIdx]; fragmentIdx < ends[laneIdx] && static_cast<uint32_t>(count) < context.FragmentCount; fragmentIdx++) {
+						auto const& fragment = context.pFragments[fragmentIdx];
+						statistics.NodesFetched++;
+						if (IS_SINGLE_TRAVERSAL || (fragment.Coverage & sampleMask)) {
+							depths[count][laneIdx] = fragment.Depth;
+							colors[count][laneIdx] = fragment.Color;
+							if constexpr (IS_SINGLE_TRAVERSAL)
+								coverages[count][laneIdx] = fragment.Coverage;
+							count++;
+						}
+					}
+				}
+				else {
+					auto nodeIdx = heads[laneIdx];
+					while (nodeIdx != INVALID_NODE_INDEX && static_cast<uint32_t>(count) < context.FragmentCount) {
+						auto const link = context.pLinkedList->LoadLink(nodeIdx);
+						statistics.NodesFetched++;
+						if (IS_SINGLE_TRAVERSAL || (link.Coverage & sampleMask)) {
+							auto const node = context.pLinkedList->LoadPayload(nodeIdx, link);
+							depths[count][laneIdx] = AsFloat(node.Depth);
+							colors[count][laneIdx] = node.Color;
+							if constexpr (IS_SINGLE_TRAVERSAL)
+								coverages[count][laneIdx] = node.Coverage;
+							count++;
+						}
+						nodeIdx = link.Next;
+					}
+				}
+				counts[laneIdx] = count;
+				maxCount = count > maxCount ? count : maxCount;
+			}
+
+			// Padding sorts after every real fragment and is masked out of the blend.
+			for (uint32_t laneIdx = 0; laneIdx < LANE_COUNT; laneIdx++) {
+				for (auto index = counts[laneIdx]; index < maxCount; index++) {
+					depths[index][laneIdx] = -std::numeric_limits<float>::infinity();
+					colors[index][laneIdx] = 0;
+					if constexpr (IS_SINGLE_TRAVERSAL)
+						coverages[index][laneIdx] = 0;
+				}
+			}
+			return maxCount;
+		};
+
+		// Sorting network over whole lane groups, with depth ties broken by the original position like SortNodes in
+		// Resolve.cpp. Padding is -inf and never crosses a real fragment.
+		auto const SortFragmentsNetwork = [&](int32_t maxCount) -> bool {
+			typename V::Int order[SORTING_NETWORK_MAX_COUNT];
+			for (uint32_t index = 0; index < SORTING_NETWORK_MAX_COUNT; index++)
+				order[index] = V::SetI(index);
+
+			return DispatchSortingNetwork(static_cast<uint32_t>(maxCount), [&](uint32_t a, uint32_t b) -> void {
+				auto const depthA = V::LoadF(depths[a]);
+				auto const depthB = V::LoadF(depths[b]);
+				auto const isSwap = V::OrMask(V::Less(depthA, depthB), V::AndMask(V::Equal(depthA, depthB), V::LessI(order[b], order[a])));
+
+				auto const colorA = V::LoadI(colors[a]);
+				auto const colorB = V::LoadI(colors[b]);
+				V::StoreF(depths[a], V::Select(isSwap, depthA, depthB));
+				V::StoreF(depths[b], V::Select(isSwap, depthB, depthA));
+				V::StoreI(colors[a], V::SelectI(isSwap, colorA, colorB));
+				V::StoreI(colors[b], V::SelectI(isSwap, colorB, colorA));
+				if constexpr (IS_SINGLE_TRAVERSAL) {
+					auto const coverageA = V::LoadI(coverages[a]);
+					auto const coverageB = V::LoadI(coverages[b]);
+					V::StoreI(coverages[a], V::SelectI(isSwap, coverageA, coverageB));
+					V::StoreI(coverages[b], V::SelectI(isSwap, coverageB, coverageA));
+				}
+
+				auto const orderA = order[a];
+				auto const orderB = order[b];
+				order[a] = V::SelectI(isSwap, orderA, orderB);
+				order[b] = V::SelectI(isSwap, orderB, orderA);
+			});
+		};
+
+		// Insertion sort expressed as adjacent swaps: stable like the scalar loop, and once no lane swaps the
+		// sorted prefix guarantees that no lane would swap further down either.
+		auto const SortFragments = [&](int32_t maxCount) -> void {
+			if (context.UseSortingNetworks && SortFragmentsNetwork(maxCount))
+				return;
+
+			for (int32_t i = 1; i < maxCount; i++) {
+				for (auto j = i; j > 0; j--) {
+					auto const depthPrev = V::LoadF(depths[j - 1]);
+					auto const depthCurr = V::LoadF(depths[j]);
+					auto const isLess = V::Less(depthPrev, depthCurr);
+					if (!V::Any(isLess))
+						break;
+
+					auto const colorPrev = V::LoadI(colors[j - 1]);
+					auto const colorCurr = V::LoadI(colors[j]);
+					V::StoreF(depths[j - 1], V::Select(isLess, depthPrev, depthCurr));
+					V::StoreF(depths[j], V::Select(isLess, depthCurr, depthPrev));
+					V::StoreI(colors[j - 1], V::SelectI(isLess, colorPrev, colorCurr));
+					V::StoreI(colors[j], V::SelectI(isLess, colorCurr, colorPrev));
+					if constexpr (IS_SINGLE_TRAVERSAL) {
+						auto const coveragePrev = V::LoadI(coverages[j - 1]);
+						auto const coverageCurr = V::LoadI(coverages[j]);
+						V::StoreI(coverages[j - 1], V::SelectI(isLess, coveragePrev, coverageCurr));
+						V::StoreI(coverages[j], V::SelectI(isLess, coverageCurr, coveragePrev));
+					}
+				}
+			}
+		};
+
+		for (uint32_t batchIdx = 0; batchIdx < BATCH_COUNT; batchIdx++) {
+			auto isAnyActive = false;
+			for (uint32_t laneIdx = 0; laneIdx < LANE_COUNT; laneIdx++) {
+				auto const localIdx = batchIdx * LANE_COUNT + laneIdx;
+				auto const x = minX + localIdx % RESOLVE_GROUP_SIZE;
+				auto const y = minY + localIdx / RESOLVE_GROUP_SIZE;
+				if (x < context.Width && y < context.Height) {
+					pixelIndices[laneIdx] = y * context.Width + x;
+					if constexpr (IS_ARRAY) {
+						auto const slot = context.FragmentSlots.GetSlot(x, y);
+						heads[laneIdx] = context.pFragmentOffsets[slot];
+						ends[laneIdx] = context.pFragmentOffsets[slot + 1];
+					}
+					else
+						heads[laneIdx] = context.pHeadPointers[context.Heads.GetSlot(x, y)].load(std::memory_order_relaxed);
+					texels[laneIdx] = context.pBackBuffer[pixelIndices[laneIdx]];
+				}
+				else {
+					pixelIndices[laneIdx] = 0;
+					heads[laneIdx] = IS_ARRAY ? 0 : INVALID_NODE_INDEX;
+					ends[laneIdx] = 0;
+					texels[laneIdx] = 0;
+				}
+				isResolved[laneIdx] = IS_ARRAY ? heads[laneIdx] != ends[laneIdx] : heads[laneIdx] != INVALID_NODE_INDEX;
+				if (isResolved[laneIdx]) {
+					statistics.ResolvedPixels++;
+					isAnyActive = true;
+				}
+			}
+
+			if (!isAnyActive)
+				continue;
+
+			auto const backBufferTexels = V::LoadI(texels);
+			auto const backBufferR = LoadChannel(backBufferTexels, 0);
+			auto const backBufferG = LoadChannel(backBufferTexels, 8);
+			auto const backBufferB = LoadChannel(backBufferTexels, 16);
+			auto const backBufferA = LoadChannel(backBufferTexels, 24);
+
+			auto resolveR = V::SetF(0.0f);
+			auto resolveG = V::SetF(0.0f);
+			auto resolveB = V::SetF(0.0f);
+			auto resolveA = V::SetF(0.0f);
+
+			if constexpr (IS_SINGLE_TRAVERSAL) {
+				auto const maxCount = GatherFragments(~0u);
+				SortFragments(maxCount);
+
+				if constexpr (MODE == ResolveMode::FrontToBack) {
+					typename V::Float accumulatedR[MAX_MSAA_SAMPLES];
+					typename V::Float accumulatedG[MAX_MSAA_SAMPLES];
+					typename V::Float accumulatedB[MAX_MSAA_SAMPLES];
+					typename V::Float accumulatedA[MAX_MSAA_SAMPLES];
+					typename V::Float transmittance[MAX_MSAA_SAMPLES];
+					for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+						accumulatedR[sampleIdx] = V::SetF(0.0f);
+						accumulatedG[sampleIdx] = V::SetF(0.0f);
+						accumulatedB[sampleIdx] = V::SetF(0.0f);
+						accumulatedA[sampleIdx] = V::SetF(0.0f);
+						transmittance[sampleIdx] = V::SetF(1.0f);
+					}
+
+					// A lane drops out once its transmittance falls below the epsilon, the break of CompositeFrontToBack.
+					auto const laneCounts = V::LoadI(reinterpret_cast<uint32_t const*>(counts));
+					auto const epsilon = V::SetF(context.TransmittanceEpsilon);
+					auto isActive = V::LessI(V::SetI(0), laneCounts);
+					for (auto index = maxCount; index-- > 0 && V::Any(isActive);) {
+						auto const isBlended = V::AndMask(isActive, V::LessI(V::SetI(static_cast<uint32_t>(index)), laneCounts));
+						auto const color = V::LoadI(colors[index]);
+						auto const coverage = V::LoadI(coverages[index]);
+						auto const srcR = UnpackChannel(color, 24);
+						auto const srcG = UnpackChannel(color, 16);
+						auto const srcB = UnpackChannel(color, 8);
+						auto const srcA = UnpackChannel(color, 0);
+						auto maxTransmittance = V::SetF(0.0f);
+						for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+							auto const isCovered = V::AndMask(isBlended, V::LessI(V::SetI(0), V::AndI(coverage, V::SetI(1u << sampleIdx))));
+							auto const weight = V::Mul(transmittance[sampleIdx], srcA);
+							accumulatedR[sampleIdx] = V::Select(isCovered, accumulatedR[sampleIdx], V::Add(accumulatedR[sampleIdx], V::Mul(srcR, weight)));
+							accumulatedG[sampleIdx] = V::Select(isCovered, accumulatedG[sampleIdx], V::Add(accumulatedG[sampleIdx], V::Mul(srcG, weight)));
+							accumulatedB[sampleIdx] = V::Select(isCovered, accumulatedB[sampleIdx], V::Add(accumulatedB[sampleIdx], V::Mul(srcB, weight)));
+							accumulatedA[sampleIdx] = V::Select(isCovered, accumulatedA[sampleIdx], V::Add(accumulatedA[sampleIdx], V::Mul(srcA, weight)));
+							transmittance[sampleIdx] = V::Select(isCovered, transmittance[sampleIdx], V::Mul(transmittance[sampleIdx], V::Sub(V::SetF(1.0f), srcA)));
+							maxTransmittance = V::Max(maxTransmittance, transmittance[sampleIdx]);
+						}
+						isActive = V::AndNotMask(isActive, V::AndMask(isBlended, V::Less(maxTransmittance, epsilon)));
+					}
+
+					for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+						resolveR = V::Add(V::Add(resolveR, accumulatedR[sampleIdx]), V::Mul(backBufferR, transmittance[sampleIdx]));
+						resolveG = V::Add(V::Add(resolveG, accumulatedG[sampleIdx]), V::Mul(backBufferG, transmittance[sampleIdx]));
+						resolveB = V::Add(V::Add(resolveB, accumulatedB[sampleIdx]), V::Mul(backBufferB, transmittance[sampleIdx]));
+						resolveA = V::Add(V::Add(resolveA, accumulatedA[sampleIdx]), V::Mul(backBufferA, transmittance[sampleIdx]));
+					}
+				}
+				else {
+					typename V::Float dstR[MAX_MSAA_SAMPLES];
+					typename V::Float dstG[MAX_MSAA_SAMPLES];
+					typename V::Float dstB[MAX_MSAA_SAMPLES];
+					typename V::Float dstA[MAX_MSAA_SAMPLES];
+					for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+						dstR[sampleIdx] = backBufferR;
+						dstG[sampleIdx] = backBufferG;
+						dstB[sampleIdx] = backBufferB;
+						dstA[sampleIdx] = backBufferA;
+					}
+
+					auto const laneCounts = V::LoadI(reinterpret_cast<uint32_t const*>(counts));
+					for (int32_t index = 0; index < maxCount; index++) {
+						auto const isValid = V::LessI(V::SetI(static_cast<uint32_t>(index)), laneCounts);
+						auto const color = V::LoadI(colors[index]);
+						auto const coverage = V::LoadI(coverages[index]);
+						auto const srcR = UnpackChannel(color, 24);
+						auto const srcG = UnpackChannel(color, 16);
+						auto const srcB = UnpackChannel(color, 8);
+						auto const srcA = UnpackChannel(color, 0);
+						for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+							auto const isCovered = V::AndMask(isValid, V::LessI(V::SetI(0), V::AndI(coverage, V::SetI(1u << sampleIdx))));
+							dstR[sampleIdx] = BlendChannel(dstR[sampleIdx], srcR, srcA, isCovered);
+							dstG[sampleIdx] = BlendChannel(dstG[sampleIdx], srcG, srcA, isCovered);
+							dstB[sampleIdx] = BlendChannel(dstB[sampleIdx], srcB, srcA, isCovered);
+							dstA[sampleIdx] = BlendChannel(dstA[sampleIdx], srcA, srcA, isCovered);
+						}
+					}
+
+					for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+						resolveR = V::Add(resolveR, dstR[sampleIdx]);
+						resolveG = V::Add(resolveG, dstG[sampleIdx]);
+						resolveB = V::Add(resolveB, dstB[sampleIdx]);
+						resolveA = V::Add(resolveA, dstA[sampleIdx]);
+					}
+				}
+			}
+			else {
+				for (uint32_t sampleIdx = 0; sampleIdx < context.MSAASamples; sampleIdx++) {
+					auto const maxCount = GatherFragments(1u << sampleIdx);
+					SortFragments(maxCount);
+
+					auto const laneCounts = V::LoadI(reinterpret_cast<uint32_t const*>(counts));
+					auto dstR = backBufferR;
+					auto dstG = backBufferG;
+					auto dstB = backBufferB;
+					auto dstA = backBufferA;
+					for (int32_t index = 0; index < maxCount; index++) {
+						auto const isValid = V::LessI(V::SetI(static_cast<uint32_t>(index)), laneCounts);
+						auto const color = V::LoadI(colors[index]);
+						auto const srcR = UnpackChannel(color, 24);
+						auto const srcG = UnpackChannel(color, 16);
+						auto const srcB = UnpackChannel(color, 8);
+						auto const srcA = UnpackChannel(color, 0);
+						dstR = BlendChannel(dstR, srcR, srcA, isValid);
+						dstG = BlendChannel(dstG, srcG, srcA, isValid);
+						dstB = BlendChannel(dstB, srcB, srcA, isValid);
+						dstA = BlendChannel(dstA, srcA, srcA, isValid);
+					}
+					resolveR = V::Add(resolveR, dstR);
+					resolveG = V::Add(resolveG, dstG);
+					resolveB = V::Add(resolveB, dstB);
+					resolveA = V::Add(resolveA, dstA);
+				}
+			}
+
+			auto const sampleCount = V::SetF(static_cast<float>(context.MSAASamples));
+			auto const result = V::OrI(V::OrI(StoreChannel(V::Div(resolveR, sampleCount), 0), StoreChannel(V::Div(resolveG, sampleCount), 8)),
+			                           V::OrI(StoreChannel(V::Div(resolveB, sampleCount), 16), StoreChannel(V::Div(resolveA, sampleCount), 24)));
+			V::StoreI(texels, result);
+
+			for (uint32_t laneIdx = 0; laneIdx < LANE_COUNT; laneIdx++)
+				if (isResolved[laneIdx])
+					context.pBackBuffer[pixelIndices[laneIdx]] = texels[laneIdx];
+		}
+	}
+
+	// IS_ARRAY reads the contiguous fragment arrays of ResolveContext instead of the lists, like ResolveArrayGroup.
+	template<typename V, bool IS_ARRAY = false>
+	auto ResolveGroupSIMD(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		switch (context.Mode) {
+			case ResolveMode::SingleTraversal: ResolveGroupSIMDImpl<V, IS_ARRAY, ResolveMode::SingleTraversal>(context, minX, minY, statistics); break;
+			case ResolveMode::FrontToBack:     ResolveGroupSIMDImpl<V, IS_ARRAY, ResolveMode::FrontToBack>(context, minX, minY, statistics); break;
+			default:                           ResolveGroupSIMDImpl<V, IS_ARRAY, ResolveMode::PerSample>(context, minX, minY, statistics); break;
+		}
+	}
+
+}
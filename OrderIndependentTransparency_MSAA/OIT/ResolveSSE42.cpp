@@ -0,0 +1,58 @@
+#include <nmmintrin.h>
+
+#include "ResolveSIMD.inl"
+
+namespace OIT {
+
+	namespace {
+
+		struct VectorSSE42 {
+			static constexpr uint32_t LANE_COUNT = 4;
+
+			using Float = __m128;
+			using Int   = __m128i;
+			using Mask  = __m128;
+
+			static auto SetF(float value) -> Float { return _mm_set1_ps(value); }
+			static auto SetI(uint32_t value) -> Int { return _mm_set1_epi32(static_cast<int32_t>(value)); }
+			static auto LoadF(float const* pData) -> Float { return _mm_load_ps(pData); }
+			static auto LoadI(uint32_t const* pData) -> Int { return _mm_load_si128(reinterpret_cast<__m128i const*>(pData)); }
+			static auto StoreF(float* pData, Float value) -> void { _mm_store_ps(pData, value); }
+			static auto StoreI(uint32_t* pData, Int value) -> void { _mm_store_si128(reinterpret_cast<__m128i*>(pData), value); }
+
+			static auto Add(Float a, Float b) -> Float { return _mm_add_ps(a, b); }
+			static auto Sub(Float a, Float b) -> Float { return _mm_sub_ps(a, b); }
+			static auto Mul(Float a, Float b) -> Float { return _mm_mul_ps(a, b); }
+			static auto Div(Float a, Float b) -> Float { return _mm_div_ps(a, b); }
+			static auto Min(Float a, Float b) -> Float { return _mm_min_ps(a, b); }
+			static auto Max(Float a, Float b) -> Float { return _mm_max_ps(a, b); }
+
+			static auto AndI(Int a, Int b) -> Int { return _mm_and_si128(a, b); }
+			static auto OrI(Int a, Int b) -> Int { return _mm_or_si128(a, b); }
+			static auto ShiftLeftI(Int a, int shift) -> Int { return _mm_slli_epi32(a, shift); }
+			static auto ShiftRightI(Int a, int shift) -> Int { return _mm_srli_epi32(a, shift); }
+			static auto ToFloat(Int a) -> Float { return _mm_cvtepi32_ps(a); }
+			static auto Truncate(Float a) -> Int { return _mm_cvttps_epi32(a); }
+
+			static auto Less(Float a, Float b) -> Mask { return _mm_cmplt_ps(a, b); }
+			static auto Equal(Float a, Float b) -> Mask { return _mm_cmpeq_ps(a, b); }
+			static auto LessI(Int a, Int b) -> Mask { return _mm_castsi128_ps(_mm_cmplt_epi32(a, b)); }
+			static auto AndMask(Mask a, Mask b) -> Mask { return _mm_and_ps(a, b); }
+			static auto OrMask(Mask a, Mask b) -> Mask { return _mm_or_ps(a, b); }
+			static auto AndNotMask(Mask a, Mask b) -> Mask { return _mm_andnot_ps(b, a); }
+			static auto Any(Mask mask) -> bool { return _mm_movemask_ps(mask) != 0; }
+			static auto Select(Mask mask, Float a, Float b) -> Float { return _mm_blendv_ps(a, b, mask); }
+			static auto SelectI(Mask mask, Int a, Int b) -> Int { return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), mask)); }
+		};
+
+	}
+
+	auto ResolveGroupSSE42(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		ResolveGroupSIMD<VectorSSE42>(context, minX, minY, statistics);
+	}
+
+	auto ResolveArrayGroupSSE42(ResolveContext const& context, uint32_t minX, uint32_t minY, ResolveStatistics& statistics) -> void {
+		ResolveGroupSIMD<VectorSSE42, true>(context, minX, minY, statistics);
+	}
+
+}
@@ -0,0 +1,141 @@
+#include "Scenes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace OIT {
+
+	namespace {
+
+		// PCG32 (O'Neill, pcg-random.org). The standard distributions are implementation defined, so floats are
+		// derived from the raw bits here.
+		class Random {
+		public:
+			explicit Random(uint64_t seed) {
+				Next();
+				m_State += seed;
+				Next();
+			}
+
+			auto Next() -> uint32_t {
+				auto const state = m_State;
+				m_State = state * 6364136223846793005ull + 1442695040888963407ull;
+				auto const xorShifted = static_cast<uint32_t>(((state >> 18) ^ state) >> 27);
+				auto const rotation = static_cast<uint32_t>(state >> 59);
+				return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+			}
+
+			// Uniform in [0, 1).
+			auto NextFloat() -> float {
+				return static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f);
+			}
+
+			auto NextFloat(float min, float max) -> float {
+				return min + NextFloat() * (max - min);
+			}
+
+		private:
+			uint64_t m_State = 0;
+		};
+
+		auto CreateColor(Random& random, float alpha) -> Color4 {
+			return { random.NextFloat(0.1f, 1.0f), random.NextFloat(0.1f, 1.0f), random.NextFloat(0.1f, 1.0f), alpha };
+		}
+
+		// Two triangles spanning [minX, maxX] x [minY, maxY] with the given depth at every corner.
+		auto AddQuad(std::vector<Triangle>& triangles, float minX, float minY, float maxX, float maxY, float const (&depths)[4], Color4 const& color) -> void {
+			Vertex const v00 = { minX, minY, depths[0], color };
+			Vertex const v10 = { maxX, minY, depths[1], color };
+			Vertex const v01 = { minX, maxY, depths[2], color };
+			Vertex const v11 = { maxX, maxY, depths[3], color };
+			triangles.push_back({ { v00, v10, v11 } });
+			triangles.push_back({ { v00, v11, v01 } });
+		}
+
+		auto CreateUniformLayers(SceneDesc const& desc, Random& random) -> Scene {
+			Scene scene;
+			for (uint32_t layerIdx = 0; layerIdx < desc.Layers; layerIdx++) {
+				auto const depth = 0.1f + 0.8f * (static_cast<float>(layerIdx) + 0.5f) / static_cast<float>(desc.Layers);
+				AddQuad(scene.TransparentTriangles, -1.0f, -1.0f, 1.0f, 1.0f, { depth, depth, depth, depth }, CreateColor(random, desc.Alpha));
+			}
+			return scene;
+		}
+
+		auto CreateHeavyTail(SceneDesc const& desc, Random& random) -> Scene {
+			// Side lengths follow a Pareto distribution with shape 2 and scale TriangleSize, capped at the screen, so
+			// quad areas have a tail of shape 1. Inverting the CDF only needs sqrt, which is exact everywhere.
+			Scene scene;
+			for (uint32_t quadIdx = 0; quadIdx < desc.TriangleCount / 2; quadIdx++) {
+				auto const size = std::min(desc.TriangleSize / std::sqrt(1.0f - random.NextFloat()), 2.0f);
+				auto const centerX = random.NextFloat(-1.0f, 1.0f);
+				auto const centerY = random.NextFloat(-1.0f, 1.0f);
+				auto const depth = random.NextFloat(0.05f, 0.95f);
+				AddQuad(scene.TransparentTriangles, centerX - 0.5f * size, centerY - 0.5f * size, centerX + 0.5f * size, centerY + 0.5f * size, { depth, depth, depth, depth }, CreateColor(random, desc.Alpha));
+			}
+			return scene;
+		}
+
+		auto CreateTinyTriangles(SceneDesc const& desc, Random& random) -> Scene {
+			Scene scene;
+			for (uint32_t triangleIdx = 0; triangleIdx < desc.TriangleCount; triangleIdx++) {
+				auto const centerX = random.NextFloat(-1.0f, 1.0f);
+				auto const centerY = random.NextFloat(-1.0f, 1.0f);
+				auto const depth = random.NextFloat(0.05f, 0.95f);
+				auto const color = CreateColor(random, desc.Alpha);
+
+				Triangle triangle;
+				for (auto& vertex : triangle.Vertices)
+					vertex = { centerX + random.NextFloat(-desc.TriangleSize, desc.TriangleSize), centerY + random.NextFloat(-desc.TriangleSize, desc.TriangleSize), depth, color };
+				scene.TransparentTriangles.push_back(triangle);
+			}
+			return scene;
+		}
+
+		auto CreateGlassPanes(SceneDesc const& desc, Random& random) -> Scene {
+			Scene scene;
+			for (uint32_t layerIdx = 0; layerIdx < desc.Layers; layerIdx++) {
+				// Every pane spans a random depth interval from one screen edge to the opposite one.
+				auto const depthA = random.NextFloat(0.05f, 0.95f);
+				auto const depthB = random.NextFloat(0.05f, 0.95f);
+				auto const isHorizontal = (random.Next() & 1) != 0;
+				auto const depths = isHorizontal ? std::array<float, 4>{ depthA, depthB, depthA, depthB } : std::array<float, 4>{ depthA, depthA, depthB, depthB };
+				AddQuad(scene.TransparentTriangles, -1.0f, -1.0f, 1.0f, 1.0f, { depths[0], depths[1], depths[2], depths[3] }, CreateColor(random, desc.Alpha));
+			}
+			return scene;
+		}
+
+	}
+
+	auto CreateScene(SceneDesc const& desc) -> Scene {
+		Random random(desc.Seed);
+		switch (desc.Kind) {
+			case SceneKind::Default:       return CreateDefaultScene();
+			case SceneKind::UniformLayers: return CreateUniformLayers(desc, random);
+			case SceneKind::HeavyTail:     return CreateHeavyTail(desc, random);
+			case SceneKind::TinyTriangles: return CreateTinyTriangles(desc, random);
+			case SceneKind::GlassPanes:    return CreateGlassPanes(desc, random);
+			default:                       throw std::invalid_argument("Unknown scene kind");
+		}
+	}
+
+	auto ToString(SceneKind kind) -> char const* {
+		switch (kind) {
+			case SceneKind::Default:       return "default";
+			case SceneKind::UniformLayers: return "uniform";
+			case SceneKind::HeavyTail:     return "heavy-tail";
+			case SceneKind::TinyTriangles: return "tiny";
+			case SceneKind::GlassPanes:    return "glass";
+			default:                       return "unknown";
+		}
+	}
+
+	auto ParseSceneKind(std::string const& name) -> SceneKind {
+		for (auto const candidate : { SceneKind::Default, SceneKind::UniformLayers, SceneKind::HeavyTail, SceneKind::TinyTriangles, SceneKind::GlassPanes })
+			if (name == ToString(candidate))
+				return candidate;
+		throw std::invalid_argument("Unknown scene: " + name);
+	}
+
+}
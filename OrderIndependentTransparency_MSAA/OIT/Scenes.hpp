@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Rasterizer.hpp"
+
+namespace OIT {
+
+	enum class SceneKind {
+		// CreateDefaultScene: the five triangles per pass drawn by main().
+		Default,
+		// Layers full-screen panes at evenly spaced depths, exactly Layers fragments per pixel.
+		UniformLayers,
+		// TriangleCount / 2 axis-aligned quads with Pareto distributed sizes: most pixels see a few fragments, a few
+		// see many times more.
+		HeavyTail,
+		// TriangleCount triangles of about TriangleSize NDC units each, spread over the screen.
+		TinyTriangles,
+		// Layers full-screen panes tilted in depth so that they intersect and the order changes across the screen.
+		GlassPanes
+	};
+
+	// Everything a synthetic scene depends on. The generator uses its own random number generator, so equal
+	// descriptions produce the same triangles on every platform.
+	struct SceneDesc {
+		SceneKind Kind          = SceneKind::Default;
+		uint32_t  Layers        = 8;
+		uint32_t  TriangleCount = 20000;
+		float     TriangleSize  = 0.01f;
+		float     Alpha         = 0.5f;
+		uint32_t  Seed          = 1;
+	};
+
+	auto CreateScene(SceneDesc const& desc) -> Scene;
+
+	auto ToString(SceneKind kind) -> char const*;
+
+	auto ParseSceneKind(std::string const& name) -> SceneKind;
+
+}
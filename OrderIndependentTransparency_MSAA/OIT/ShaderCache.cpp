@@ -0,0 +1,239 @@
+#include "ShaderCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace OIT {
+
+	namespace {
+
+		// Bumped whenever the entry layout or the key material changes.
+		constexpr char     CACHE_MAGIC[8] = { 'O', 'I', 'T', 'S', 'H', 'C', '0', '1' };
+		constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+		constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+
+		struct EntryHeader {
+			char     Magic[8];
+			uint64_t Key;
+			uint64_t BytecodeSize;
+		};
+
+		auto HashBytes(uint64_t hash, void const* pData, size_t size) -> uint64_t {
+			auto const pBytes = static_cast<uint8_t const*>(pData);
+			for (size_t byteIdx = 0; byteIdx < size; byteIdx++) {
+				hash ^= pBytes[byteIdx];
+				hash *= FNV_PRIME;
+			}
+			return hash;
+		}
+
+		// Strings are hashed with their terminator so that adjacent fields cannot run into each other.
+		auto HashString(uint64_t hash, std::string const& value) -> uint64_t {
+			return HashBytes(hash, value.c_str(), value.size() + 1);
+		}
+
+		auto ReadFile(std::filesystem::path const& fileName, std::string& contents) -> bool {
+			std::ifstream file(fileName, std::ios::binary);
+			if (!file)
+				return false;
+			contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			return true;
+		}
+
+		// Names of the #include "..." and #include <...> directives of a file, in order.
+		auto FindIncludes(std::string const& contents) -> std::vector<std::string> {
+			std::vector<std::string> includes;
+			std::istringstream stream(contents);
+			std::string line;
+			while (std::getline(stream, line)) {
+				auto position = line.find_first_not_of(" \t");
+				if (position == std::string::npos || line[position] != '#')
+					continue;
+				position = line.find_first_not_of(" \t", position + 1);
+				if (position == std::string::npos || line.compare(position, 7, "include") != 0)
+					continue;
+				position = line.find_first_of("\"<", position + 7);
+				if (position == std::string::npos)
+					continue;
+				auto const end = line.find(line[position] == '"' ? '"' : '>', position + 1);
+				if (end != std::string::npos)
+					includes.push_back(line.substr(position + 1, end - position - 1));
+			}
+			return includes;
+		}
+
+		auto HashSourceTree(uint64_t hash, std::filesystem::path const& fileName, std::filesystem::path const& rootDirectory, std::set<std::filesystem::path>& visited) -> uint64_t {
+			std::string contents;
+			if (!ReadFile(fileName, contents))
+				return HashString(hash, "<missing>" + fileName.generic_string());
+			hash = HashString(hash, contents);
+
+			for (auto const& include : FindIncludes(contents)) {
+				auto includePath = fileName.parent_path() / include;
+				if (!std::filesystem::exists(includePath))
+					includePath = rootDirectory / include;
+				auto const canonicalPath = std::filesystem::weakly_canonical(includePath);
+				if (visited.insert(canonicalPath).second)
+					hash = HashSourceTree(hash, includePath, rootDirectory, visited);
+			}
+			return hash;
+		}
+
+	}
+
+#if defined(_WIN32)
+	MappedFile::MappedFile(std::filesystem::path const& fileName) {
+		auto const hFile = CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+			return;
+		m_hFile = hFile;
+
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+			return;
+
+		m_hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_hMapping)
+			return;
+
+		m_pData = static_cast<uint8_t const*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+		m_Size = m_pData ? static_cast<size_t>(size.QuadPart) : 0;
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+		if (m_hMapping)
+			CloseHandle(m_hMapping);
+		if (m_hFile)
+			CloseHandle(m_hFile);
+	}
+#else
+	MappedFile::MappedFile(std::filesystem::path const& fileName) {
+		auto const descriptor = open(fileName.c_str(), O_RDONLY);
+		if (descriptor < 0)
+			return;
+
+		struct stat status = {};
+		if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+			auto const pData = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (pData != MAP_FAILED) {
+				m_pData = static_cast<uint8_t const*>(pData);
+				m_Size = static_cast<size_t>(status.st_size);
+			}
+		}
+		// The mapping stays valid after the descriptor is closed.
+		close(descriptor);
+	}
+
+	MappedFile::~MappedFile() {
+		if (m_pData)
+			munmap(const_cast<uint8_t*>(m_pData), m_Size);
+	}
+#endif
+
+	ShaderCache::ShaderCache(std::filesystem::path directory)
+		: m_Directory(std::move(directory)) {
+		std::error_code error;
+		std::filesystem::create_directories(m_Directory, error);
+	}
+
+	auto ShaderCache::ComputeKey(std::filesystem::path const& fileName, std::string const& entryPoint, std::string const& target,
+		std::vector<std::pair<std::string, std::string>> const& defines, uint32_t flags, uint32_t compilerVersion) const -> uint64_t {
+
+		auto hash = HashBytes(FNV_OFFSET_BASIS, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		std::set<std::filesystem::path> visited = { std::filesystem::weakly_canonical(fileName) };
+		hash = HashSourceTree(hash, fileName, fileName.parent_path(), visited);
+		hash = HashString(hash, entryPoint);
+		hash = HashString(hash, target);
+		for (auto const& [name, value] : defines) {
+			hash = HashString(hash, name);
+			hash = HashString(hash, value);
+		}
+		hash = HashBytes(hash, &flags, sizeof(flags));
+		return HashBytes(hash, &compilerVersion, sizeof(compilerVersion));
+	}
+
+	auto ShaderCache::Load(uint64_t key) -> std::unique_ptr<CachedShader> {
+		auto pFile = std::make_unique<MappedFile>(GetEntryPath(key));
+
+		EntryHeader header = {};
+		if (pFile->IsValid() && pFile->GetSize() > sizeof(header))
+			std::memcpy(&header, pFile->GetData(), sizeof(header));
+
+		// A truncated or foreign file is treated like a missing one and gets overwritten by the next Store.
+		if (std::memcmp(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.Key != key || header.BytecodeSize != pFile->GetSize() - sizeof(header)) {
+			m_Misses++;
+			return nullptr;
+		}
+
+		m_Hits++;
+		return std::make_unique<CachedShader>(std::move(pFile), sizeof(header), static_cast<size_t>(header.BytecodeSize));
+	}
+
+	auto ShaderCache::Store(uint64_t key, void const* pBytecode, size_t size) -> void {
+		EntryHeader header = {};
+		std::memcpy(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		header.Key = key;
+		header.BytecodeSize = size;
+
+		// Written under a name of its own and renamed into place, so concurrent writers and readers of the same key
+		// never see a partial entry.
+		auto const entryPath = GetEntryPath(key);
+		auto temporaryPath = entryPath;
+		temporaryPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		{
+			std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			file.write(static_cast<char const*>(pBytecode), static_cast<std::streamsize>(size));
+			if (!file) {
+				file.close();
+				std::error_code error;
+				std::filesystem::remove(temporaryPath, error);
+				return;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporaryPath, entryPath, error);
+		if (error)
+			std::filesystem::remove(temporaryPath, error);
+		else
+			m_Stores++;
+	}
+
+	auto ShaderCache::GetStatistics() const -> ShaderCacheStatistics {
+		ShaderCacheStatistics statistics;
+		statistics.Hits = m_Hits;
+		statistics.Misses = m_Misses;
+		statistics.Stores = m_Stores;
+		return statistics;
+	}
+
+	auto ShaderCache::GetEntryPath(uint64_t key) const -> std::filesystem::path {
+		char name[32] = {};
+		std::snprintf(name, sizeof(name), "%016llx.cso", static_cast<unsigned long long>(key));
+		return m_Directory / name;
+	}
+
+}
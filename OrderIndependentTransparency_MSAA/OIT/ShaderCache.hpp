@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OIT {
+
+	// Read-only memory mapping of a whole file. Invalid when the file is missing, empty or cannot be mapped.
+	class MappedFile {
+	public:
+		MappedFile() = default;
+
+		explicit MappedFile(std::filesystem::path const& fileName);
+
+		MappedFile(MappedFile const&) = delete;
+
+		auto operator=(MappedFile const&) -> MappedFile& = delete;
+
+		~MappedFile();
+
+		auto IsValid() const -> bool { return m_pData != nullptr; }
+
+		auto GetData() const -> uint8_t const* { return m_pData; }
+
+		auto GetSize() const -> size_t { return m_Size; }
+
+	private:
+		uint8_t const* m_pData = nullptr;
+		size_t         m_Size = 0;
+#if defined(_WIN32)
+		void*          m_hFile = nullptr;
+		void*          m_hMapping = nullptr;
+#endif
+	};
+
+	// Bytecode of a cache hit, pointing into the mapped cache file.
+	class CachedShader {
+	public:
+		CachedShader(std::unique_ptr<MappedFile> pFile, size_t offset, size_t size)
+			: m_pFile(std::move(pFile)), m_Offset(offset), m_Size(size) {}
+
+		auto GetBytecode() const -> void const* { return m_pFile->GetData() + m_Offset; }
+
+		auto GetBytecodeSize() const -> size_t { return m_Size; }
+
+	private:
+		std::unique_ptr<MappedFile> m_pFile;
+		size_t                      m_Offset = 0;
+		size_t                      m_Size = 0;
+	};
+
+	struct ShaderCacheStatistics {
+		uint32_t Hits   = 0;
+		uint32_t Misses = 0;
+		uint32_t Stores = 0;
+	};
+
+	// Content-addressed store of compiled shaders, one file per key in a directory. The key hashes the contents
+	// of the source file and of every file it includes, so editing any of them misses without an explicit
+	// invalidation. Failures to read or write the cache only cost a recompile. Safe to use from several threads.
+	class ShaderCache {
+	public:
+		explicit ShaderCache(std::filesystem::path directory);
+
+		// Includes are found by scanning for #include directives, relative to the including file and then to the
+		// source file, which is how D3D_COMPILE_STANDARD_FILE_INCLUDE resolves them. Directives that the
+		// preprocessor skips are hashed as well, which can only cause spurious misses.
+		auto ComputeKey(std::filesystem::path const& fileName, std::string const& entryPoint, std::string const& target,
+			std::vector<std::pair<std::string, std::string>> const& defines, uint32_t flags, uint32_t compilerVersion) const -> uint64_t;
+
+		auto Load(uint64_t key) -> std::unique_ptr<CachedShader>;
+
+		auto Store(uint64_t key, void const* pBytecode, size_t size) -> void;
+
+		auto GetStatistics() const -> ShaderCacheStatistics;
+
+	private:
+		auto GetEntryPath(uint64_t key) const -> std::filesystem::path;
+
+	private:
+		std::filesystem::path m_Directory;
+		std::atomic<uint32_t> m_Hits = 0;
+		std::atomic<uint32_t> m_Misses = 0;
+		std::atomic<uint32_t> m_Stores = 0;
+	};
+
+}
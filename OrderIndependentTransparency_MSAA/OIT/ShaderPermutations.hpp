@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace OIT {
+
+	// Fragment caps and MSAA sample counts shader variants can be built for.
+	inline constexpr uint32_t PERMUTATION_FRAGMENT_COUNTS[] = { 4, 8, 16, 32, 64 };
+	inline constexpr uint32_t PERMUTATION_SAMPLE_COUNTS[]   = { 1, 2, 4, 8 };
+
+	// Compile-time options a shader can depend on, combined into the options mask of a PermutationRegistry.
+	enum PermutationOption : uint32_t {
+		PERMUTATION_FRAGMENT_COUNT = 1 << 0,
+		PERMUTATION_SAMPLE_COUNT   = 1 << 1
+	};
+
+	// Values of the compile-time options of one variant, FRAGMENT_COUNT and MSAA_SAMPLE_COUNT in the shaders.
+	struct ShaderPermutation {
+		uint32_t FragmentCount = 0;
+		uint32_t SampleCount   = 0;
+
+		auto operator<(ShaderPermutation const& other) const -> bool {
+			return std::tie(FragmentCount, SampleCount) < std::tie(other.FragmentCount, other.SampleCount);
+		}
+	};
+
+	// Defines selecting the variant, limited to the options in the mask.
+	inline auto GetPermutationDefines(ShaderPermutation const& permutation, uint32_t options) -> std::vector<std::pair<std::string, std::string>> {
+		std::vector<std::pair<std::string, std::string>> defines;
+		if (options & PERMUTATION_FRAGMENT_COUNT)
+			defines.push_back({ "FRAGMENT_COUNT", std::to_string(permutation.FragmentCount) });
+		if (options & PERMUTATION_SAMPLE_COUNT)
+			defines.push_back({ "MSAA_SAMPLE_COUNT", std::to_string(permutation.SampleCount) });
+		return defines;
+	}
+
+	// Variants of one shader, built by the factory on a thread pool the first time they are requested and kept for
+	// the lifetime of the registry. Options outside the mask are cleared from every request, so permutations that
+	// only differ in them share a variant. Prefetch queues a build without waiting for it; Get waits. Safe to use
+	// from several threads, concurrent requests of a variant share one build.
+	template<typename T>
+	class PermutationRegistry {
+	public:
+		using Factory = std::function<T(ShaderPermutation const& permutation)>;
+
+		PermutationRegistry(Factory factory, uint32_t options, ThreadPool& threadPool)
+			: m_Factory(std::move(factory)), m_Options(options), m_ThreadPool(threadPool) {}
+
+		auto Prefetch(ShaderPermutation const& permutation) -> void { Request(permutation); }
+
+		auto Get(ShaderPermutation const& permutation) -> T { return Request(permutation).get(); }
+
+		auto IsReady(ShaderPermutation const& permutation) -> bool {
+			return Request(permutation).wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+		auto GetOptions() const -> uint32_t { return m_Options; }
+
+		auto GetVariantCount() -> size_t {
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_Variants.size();
+		}
+
+	private:
+		auto Request(ShaderPermutation permutation) -> std::shared_future<T> {
+			permutation.FragmentCount = (m_Options & PERMUTATION_FRAGMENT_COUNT) ? permutation.FragmentCount : 0;
+			permutation.SampleCount = (m_Options & PERMUTATION_SAMPLE_COUNT) ? permutation.SampleCount : 0;
+			if (permutation.FragmentCount && std::find(std::begin(PERMUTATION_FRAGMENT_COUNTS), std::end(PERMUTATION_FRAGMENT_COUNTS), permutation.FragmentCount) == std::end(PERMUTATION_FRAGMENT_COUNTS))
+				throw std::invalid_argument("Unsupported FRAGMENT_COUNT permutation: " + std::to_string(permutation.FragmentCount));
+			if (permutation.SampleCount && std::find(std::begin(PERMUTATION_SAMPLE_COUNTS), std::end(PERMUTATION_SAMPLE_COUNTS), permutation.SampleCount) == std::end(PERMUTATION_SAMPLE_COUNTS))
+				throw std::invalid_argument("Unsupported MSAA_SAMPLE_COUNT permutation: " + std::to_string(permutation.SampleCount));
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			auto const iterator = m_Variants.find(permutation);
+			if (iterator != m_Variants.end())
+				return iterator->second;
+
+			// The job owns a copy of the factory, so queued builds do not outlive the registry they came from.
+			auto variant = m_ThreadPool.Submit([factory = m_Factory, permutation] { return factory(permutation); }).share();
+			m_Variants.emplace(permutation, variant);
+			return variant;
+		}
+
+	private:
+		Factory                                            m_Factory;
+		uint32_t                                           m_Options = 0;
+		ThreadPool&                                        m_ThreadPool;
+		std::mutex                                         m_Mutex;
+		std::map<ShaderPermutation, std::shared_future<T>> m_Variants;
+	};
+
+}
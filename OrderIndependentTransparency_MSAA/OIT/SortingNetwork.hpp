@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+namespace OIT {
+
+	// Longest list sorted by a network; longer lists fall back to the insertion sort of CSMain. Shaders/SortingNetwork.hlsli
+	// defines the same value.
+	constexpr uint32_t SORTING_NETWORK_MAX_COUNT = 8;
+
+	struct SortingNetworkPair {
+		uint8_t A;
+		uint8_t B;
+	};
+
+	// Minimal-size networks for 2..8 keys (Knuth, TAOCP vol. 3, 5.3.4). Every pair is a compare-exchange with A < B.
+	template<uint32_t N>
+	struct SortingNetwork;
+
+	template<>
+	struct SortingNetwork<2> {
+		static constexpr SortingNetworkPair Pairs[] = { { 0, 1 } };
+	};
+
+	template<>
+	struct SortingNetwork<3> {
+		static constexpr SortingNetworkPair Pairs[] = { { 0, 2 }, { 0, 1 }, { 1, 2 } };
+	};
+
+	template<>
+	struct SortingNetwork<4> {
+		static constexpr SortingNetworkPair Pairs[] = { { 0, 1 }, { 2, 3 }, { 0, 2 }, { 1, 3 }, { 1, 2 } };
+	};
+
+	template<>
+	struct SortingNetwork<5> {
+		static constexpr SortingNetworkPair Pairs[] = { { 0, 3 }, { 1, 4 }, { 0, 2 }, { 1, 3 }, { 0, 1 }, { 2, 4 }, { 1, 2 }, { 3, 4 }, { 2, 3 } };
+	};
+
+	template<>
+	struct SortingNetwork<6> {
+		static constexpr SortingNetworkPair Pairs[] = { { 0, 5 }, { 1, 3 }, { 2, 4 }, { 1, 2 }, { 3, 4 }, { 0, 3 }, { 2, 5 }, { 0, 1 }, { 2, 3 }, { 4, 5 }, { 1, 2 }, { 3, 4 } };
+	};
+
+	template<>
+	struct SortingNetwork<7> {
+		static constexpr SortingNetworkPair Pairs[] = { { 0, 6 }, { 2, 3 }, { 4, 5 }, { 0, 2 }, { 1, 4 }, { 3, 6 }, { 0, 1 }, { 2, 5 }, { 3, 4 }, { 1, 2 }, { 4, 6 }, { 2, 3 }, { 4, 5 }, { 1, 2 }, { 3, 4 }, { 5, 6 } };
+	};
+
+	template<>
+	struct SortingNetwork<8> {
+		static constexpr SortingNetworkPair Pairs[] = { { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }, { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, { 2, 4 }, { 3, 5 }, { 1, 4 }, { 3, 6 }, { 1, 2 }, { 3, 4 }, { 5, 6 } };
+	};
+
+	template<uint32_t N, typename CompareExchange, size_t... I>
+	inline auto ApplySortingNetwork(CompareExchange&& compareExchange, std::index_sequence<I...>) -> void {
+		(compareExchange(SortingNetwork<N>::Pairs[I].A, SortingNetwork<N>::Pairs[I].B), ...);
+	}
+
+	// Fully unrolled network: compareExchange(a, b) is called with compile-time constant positions.
+	template<uint32_t N, typename CompareExchange>
+	inline auto ApplySortingNetwork(CompareExchange&& compareExchange) -> void {
+		ApplySortingNetwork<N>(compareExchange, std::make_index_sequence<std::size(SortingNetwork<N>::Pairs)>{});
+	}
+
+	// Picks the network specialized for count. Returns false when count has none and the caller has to sort itself.
+	template<typename CompareExchange>
+	inline auto DispatchSortingNetwork(uint32_t count, CompareExchange&& compareExchange) -> bool {
+		switch (count) {
+			case 0:
+			case 1:  return true;
+			case 2:  ApplySortingNetwork<2>(compareExchange); return true;
+			case 3:  ApplySortingNetwork<3>(compareExchange); return true;
+			case 4:  ApplySortingNetwork<4>(compareExchange); return true;
+			case 5:  ApplySortingNetwork<5>(compareExchange); return true;
+			case 6:  ApplySortingNetwork<6>(compareExchange); return true;
+			case 7:  ApplySortingNetwork<7>(compareExchange); return true;
+			case 8:  ApplySortingNetwork<8>(compareExchange); return true;
+			default: return false;
+		}
+	}
+
+}
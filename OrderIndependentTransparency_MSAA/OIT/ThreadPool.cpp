@@ -0,0 +1,114 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace OIT {
+
+	ThreadPool::ThreadPool(uint32_t threadCount) {
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		for (uint32_t threadIdx = 1; threadIdx < threadCount; threadIdx++)
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, threadIdx);
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_IsStopping = true;
+		}
+		m_WakeCondition.notify_all();
+		for (auto& worker : m_Workers)
+			worker.join();
+	}
+
+	auto ThreadPool::ParallelFor(uint32_t count, Task const& task) -> void {
+		if (count == 0)
+			return;
+
+		if (m_Workers.empty() || count == 1) {
+			for (uint32_t index = 0; index < count; index++)
+				task(index, 0);
+			return;
+		}
+
+		std::lock_guard<std::mutex> parallelForLock(m_ParallelForMutex);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_pTask = &task;
+			m_TaskCount = count;
+			m_NextIndex.store(0, std::memory_order_relaxed);
+			m_IsTaskOpen = true;
+			m_Generation++;
+		}
+		m_WakeCondition.notify_all();
+
+		// The calling thread keeps taking indices until none are left, so the task completes even if no worker is free.
+		// Closing it stops late workers from joining; the ones already in may still be running their last index.
+		Execute(0);
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_IsTaskOpen = false;
+		m_DoneCondition.wait(lock, [this] { return m_ActiveWorkers == 0; });
+		m_pTask = nullptr;
+	}
+
+	auto ThreadPool::Enqueue(std::function<void()> job) -> void {
+		if (m_Workers.empty()) {
+			job();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Jobs.push_back(std::move(job));
+		}
+		m_WakeCondition.notify_one();
+	}
+
+	auto ThreadPool::WorkerLoop(uint32_t threadIdx) -> void {
+		uint64_t generation = 0;
+		while (true) {
+			// An open ParallelFor goes first, it finishes sooner with every free worker joining in.
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				auto const IsTaskPending = [&] { return m_IsTaskOpen && m_Generation != generation; };
+				m_WakeCondition.wait(lock, [&] { return m_IsStopping || IsTaskPending() || !m_Jobs.empty(); });
+				if (IsTaskPending()) {
+					generation = m_Generation;
+					m_ActiveWorkers++;
+				}
+				else {
+					if (m_Jobs.empty())
+						return;
+					job = std::move(m_Jobs.front());
+					m_Jobs.pop_front();
+				}
+			}
+
+			if (job) {
+				job();
+				continue;
+			}
+
+			Execute(threadIdx);
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_ActiveWorkers--;
+			}
+			m_DoneCondition.notify_one();
+		}
+	}
+
+	auto ThreadPool::Execute(uint32_t threadIdx) -> void {
+		while (true) {
+			auto const index = m_NextIndex.fetch_add(1, std::memory_order_relaxed);
+			if (index >= m_TaskCount)
+				break;
+			(*m_pTask)(index, threadIdx);
+		}
+	}
+
+}
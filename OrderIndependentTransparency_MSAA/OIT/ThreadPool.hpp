@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace OIT {
+
+	class ThreadPool {
+	public:
+		using Task = std::function<void(uint32_t index, uint32_t threadIdx)>;
+
+		explicit ThreadPool(uint32_t threadCount = 0);
+
+		~ThreadPool();
+
+		ThreadPool(ThreadPool const&) = delete;
+
+		auto operator=(ThreadPool const&) -> ThreadPool& = delete;
+
+		auto GetThreadCount() const -> uint32_t { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+
+		// Runs task(index, threadIdx) for every index in [0, count). The calling thread takes part as threadIdx 0 and
+		// only waits for the workers that picked the task up, so workers busy with a job never hold it back and a job
+		// may call ParallelFor itself. Concurrent calls run one after the other, so a task must not call it.
+		auto ParallelFor(uint32_t count, Task const& task) -> void;
+
+		// Queues job() for the worker threads, which take jobs in submission order while no ParallelFor is open.
+		// Without workers the job runs right away on the calling thread. The destructor finishes queued jobs.
+		template<typename Job>
+		auto Submit(Job&& job) -> std::future<std::invoke_result_t<std::decay_t<Job>>> {
+			using Result = std::invoke_result_t<std::decay_t<Job>>;
+			auto const pTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Job>(job));
+			auto future = pTask->get_future();
+			Enqueue([pTask] { (*pTask)(); });
+			return future;
+		}
+
+	private:
+		auto Enqueue(std::function<void()> job) -> void;
+
+		auto WorkerLoop(uint32_t threadIdx) -> void;
+
+		auto Execute(uint32_t threadIdx) -> void;
+
+	private:
+		std::vector<std::thread> m_Workers;
+		std::mutex               m_Mutex;
+		std::mutex               m_ParallelForMutex;
+		std::condition_variable  m_WakeCondition;
+		std::condition_variable  m_DoneCondition;
+		std::deque<std::function<void()>> m_Jobs;
+		Task const*              m_pTask = nullptr;
+		uint32_t                 m_TaskCount = 0;
+		uint64_t                 m_Generation = 0;
+		uint32_t                 m_ActiveWorkers = 0;
+		bool                     m_IsTaskOpen = false;
+		bool                     m_IsStopping = false;
+		std::atomic<uint32_t>    m_NextIndex{ 0 };
+	};
+
+}
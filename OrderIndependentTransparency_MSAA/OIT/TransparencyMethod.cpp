@@ -0,0 +1,31 @@
+#include "TransparencyMethod.hpp"
+
+#include <stdexcept>
+
+namespace OIT {
+
+	auto ToString(TransparencyMethod method) -> char const* {
+		switch (method) {
+			case TransparencyMethod::LinkedList:              return "linked-list";
+			case TransparencyMethod::WeightedBlended:         return "weighted";
+			case TransparencyMethod::MultiLayerAlphaBlending: return "mlab";
+			case TransparencyMethod::AdaptiveTransparency:    return "adaptive";
+			case TransparencyMethod::MomentBased:             return "moments";
+			case TransparencyMethod::DepthPeeling:            return "depth-peeling";
+			case TransparencyMethod::PrefixSum:               return "prefix-sum";
+			default:                                          return "unknown";
+		}
+	}
+
+	auto IsRasterizerOrdered(TransparencyMethod method) -> bool {
+		return method == TransparencyMethod::MultiLayerAlphaBlending || method == TransparencyMethod::AdaptiveTransparency;
+	}
+
+	auto ParseTransparencyMethod(std::string const& name) -> TransparencyMethod {
+		for (auto const candidate : TRANSPARENCY_METHODS)
+			if (name == ToString(candidate))
+				return candidate;
+		throw std::invalid_argument("Unknown transparency method: " + name);
+	}
+
+}
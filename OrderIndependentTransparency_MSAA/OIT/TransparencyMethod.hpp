@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+namespace OIT {
+
+	// How the transparent pass stores fragments and how they are resolved.
+	enum class TransparencyMethod {
+		// Per-pixel linked lists, sorted and blended exactly by CSMain of ResolveGeometry.hlsl. Memory grows with
+		// the depth complexity.
+		LinkedList,
+		// Weighted blended OIT of McGuire and Bavoil: order-independent sums in an accumulation and a revealage
+		// target, composited in one pass. Constant memory, approximate ordering.
+		WeightedBlended,
+		// Multi-layer alpha blending (Salvi and Vaidyanathan), a k-buffer: a fixed number of sorted layers per
+		// sample, the farthest two merged whenever a fragment does not fit. Bounded memory, exact up to the layer
+		// count.
+		MultiLayerAlphaBlending,
+		// Adaptive transparency (Salvi et al.): the visibility function of every sample compressed into a fixed
+		// number of nodes as fragments arrive, with the colors folded in. Bounded memory and a resolve without any
+		// sort, approximate once the node count is exceeded.
+		AdaptiveTransparency,
+		// Moment-based OIT (Muenstermann et al.): power moments of the absorbance over depth accumulated in a first
+		// geometry pass, the transmittance in front of every fragment reconstructed from them in a second one.
+		// Constant memory, approximate ordering, exact total opacity.
+		MomentBased,
+		// Depth peeling: one rasterization of the transparent geometry per layer, back to front, each blending the
+		// next farthest fragment of every sample. No fragment cap, so it is the exact reference of the other methods.
+		// CPU engine only.
+		DepthPeeling,
+		// Per-pixel arrays instead of lists: the transparent geometry is rasterized once to count the fragments of
+		// every pixel, an exclusive prefix sum over the counts gives each pixel its offset, and a second
+		// rasterization writes the fragments into their contiguous ranges. The fragment buffer holds exactly the
+		// total and the resolve reads every pixel linearly.
+		PrefixSum
+	};
+
+	constexpr TransparencyMethod TRANSPARENCY_METHODS[] = { TransparencyMethod::LinkedList, TransparencyMethod::WeightedBlended, TransparencyMethod::MultiLayerAlphaBlending, TransparencyMethod::AdaptiveTransparency, TransparencyMethod::MomentBased, TransparencyMethod::DepthPeeling, TransparencyMethod::PrefixSum };
+
+	// Methods whose transparent pass updates per-sample storage in place and needs rasterizer ordered views on the GPU.
+	auto IsRasterizerOrdered(TransparencyMethod method) -> bool;
+
+	auto ToString(TransparencyMethod method) -> char const*;
+
+	auto ParseTransparencyMethod(std::string const& name) -> TransparencyMethod;
+
+}
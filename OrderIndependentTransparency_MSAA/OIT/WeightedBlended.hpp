@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Common.hpp"
+
+namespace OIT {
+
+	// Bytes per sample of the GPU targets: R16G16B16A16_FLOAT accumulation and R16_FLOAT revealage.
+	constexpr uint32_t WEIGHTED_SAMPLE_SIZE = 8 + 2;
+
+	// Mirror of the two render targets of PSAccumulate in WeightedBlended.hlsl for one MSAA sample. The cleared
+	// state is no coverage at all.
+	struct WeightedSample {
+		Color4 Accumulation = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float  Revealage    = 1.0f;
+	};
+
+	// Depth weight of equation 10 of McGuire and Bavoil, "Weighted Blended Order-Independent Transparency". The
+	// clamp keeps a few dozen layers inside the range of the R16G16B16A16_FLOAT accumulation target.
+	inline auto GetWeightedBlendWeight(float depth, float alpha) -> float {
+		auto const distance = 1.0f - depth;
+		return alpha * std::clamp(3.0e3f * distance * distance * distance, 1.0e-2f, 3.0e3f);
+	}
+
+	// Output of PSAccumulate for one fragment. The pixel shader runs once per pixel, so every covered sample that
+	// passes the depth test receives the same values.
+	struct WeightedFragment {
+		Color4 Accumulation;
+		float  Transmittance;
+	};
+
+	inline auto GetWeightedFragment(Color4 const& color, float depth) -> WeightedFragment {
+		auto const alpha = Saturate(color.A);
+		auto const weight = GetWeightedBlendWeight(depth, alpha);
+		return { { Saturate(color.R) * alpha * weight, Saturate(color.G) * alpha * weight, Saturate(color.B) * alpha * weight, alpha * weight }, 1.0f - alpha };
+	}
+
+	// Blend state of PSAccumulate: ONE/ONE on the accumulation, ZERO/INV_SRC_COLOR on the revealage.
+	inline auto AccumulateWeighted(WeightedSample& sample, WeightedFragment const& fragment) -> void {
+		sample.Accumulation = sample.Accumulation + fragment.Accumulation;
+		sample.Revealage *= fragment.Transmittance;
+	}
+
+	// CSComposite for one sample: the weighted average color covers the background by 1 - revealage.
+	inline auto CompositeWeighted(WeightedSample const& sample, Color4 const& background) -> Color4 {
+		auto const weight = std::max(sample.Accumulation.A, 1.0e-5f);
+		Color4 const average = { sample.Accumulation.R / weight, sample.Accumulation.G / weight, sample.Accumulation.B / weight, 1.0f };
+		return Lerp(background, average, 1.0f - sample.Revealage);
+	}
+
+}
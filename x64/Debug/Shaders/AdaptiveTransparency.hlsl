@@ -0,0 +1,129 @@
+#include "Common.hlsli"
+
+#ifndef MSAA_SAMPLE_COUNT
+#define MSAA_SAMPLE_COUNT 4
+#endif
+
+// Visibility nodes per MSAA sample, at most OIT::MAX_AT_NODE_COUNT.
+#ifndef NODE_COUNT
+#define NODE_COUNT 4
+#endif
+
+// Adaptive transparency (Salvi et al. 2011): the visibility function of every MSAA sample compressed into NODE_COUNT
+// nodes kept front to back, with the premultiplied colors folded in as fragments arrive. PSInsert draws the
+// transparent geometry with the VSMain of TransparentGeometry.hlsl and needs rasterizer ordered views like
+// MultiLayerAlphaBlending.hlsl. CSComposite sums the nodes without any sort. OIT/AdaptiveTransparency.hpp mirrors both.
+
+// Bits of every field of an empty slot, cleared with ClearUnorderedAccessViewUint. The depth is +INF, so empty slots
+// sort behind every fragment and the filled nodes always form a prefix.
+#define EMPTY_NODE_BITS 0x7F800000
+
+struct AdaptiveNode {
+    float  Depth;
+    // Visibility right behind Depth.
+    float  Transmittance;
+    // Premultiplied and attenuated by the visibility in front of the node.
+    float3 Color;
+};
+
+cbuffer AdaptiveConstants : register(b0) {
+    uint Width;
+};
+
+StructuredBuffer<AdaptiveNode>                  NodesSRV   : register(t0);
+RWTexture2D<unorm float4>                       BackBuffer : register(u0);
+RasterizerOrderedStructuredBuffer<AdaptiveNode> NodesROV   : register(u1);
+
+// The fragment attenuates every node behind it. Once NODE_COUNT + 1 nodes exist the one whose removal changes the
+// area under the visibility curve least is folded into its predecessor, keeping the summed color.
+void InsertNode(uint baseIdx, float depth, float4 color) {
+    AdaptiveNode nodes[NODE_COUNT + 1];
+
+    uint count = 0;
+    uint insertIdx = 0;
+    [unroll] for (uint nodeIdx = 0; nodeIdx < NODE_COUNT; nodeIdx++) {
+        AdaptiveNode node = NodesROV[baseIdx + nodeIdx];
+        bool isFilled = asuint(node.Depth) != EMPTY_NODE_BITS;
+        count += isFilled;
+        insertIdx += isFilled && node.Depth <= depth;
+        nodes[nodeIdx] = node;
+    }
+
+    float visibility = insertIdx > 0 ? nodes[insertIdx - 1].Transmittance : 1.0;
+    for (uint nodeIdx = count; nodeIdx > insertIdx; nodeIdx--) {
+        nodes[nodeIdx] = nodes[nodeIdx - 1];
+        nodes[nodeIdx].Transmittance *= 1.0 - color.a;
+        nodes[nodeIdx].Color *= 1.0 - color.a;
+    }
+    nodes[insertIdx].Depth = depth;
+    nodes[insertIdx].Transmittance = visibility * (1.0 - color.a);
+    nodes[insertIdx].Color = color.rgb * color.a * visibility;
+    count++;
+
+    if (count > NODE_COUNT) {
+        uint removeIdx = 1;
+        float minArea = asfloat(EMPTY_NODE_BITS);
+        [unroll] for (uint nodeIdx = 1; nodeIdx < NODE_COUNT + 1; nodeIdx++) {
+            float area = (nodes[nodeIdx - 1].Transmittance - nodes[nodeIdx].Transmittance) * (nodes[nodeIdx].Depth - nodes[nodeIdx - 1].Depth);
+            if (area < minArea) {
+                minArea = area;
+                removeIdx = nodeIdx;
+            }
+        }
+
+        nodes[removeIdx - 1].Transmittance = nodes[removeIdx].Transmittance;
+        nodes[removeIdx - 1].Color += nodes[removeIdx].Color;
+        for (uint nodeIdx = removeIdx; nodeIdx < NODE_COUNT; nodeIdx++)
+            nodes[nodeIdx] = nodes[nodeIdx + 1];
+        count--;
+    }
+
+    for (uint nodeIdx = 0; nodeIdx < count; nodeIdx++)
+        NodesROV[baseIdx + nodeIdx] = nodes[nodeIdx];
+}
+
+// Same [earlydepthstencil] and SV_Coverage rules as PSMain: every covered sample receives the fragment. The color
+// goes through the 8-bit packing of the list nodes.
+[earlydepthstencil]
+void PSInsert(float4 position : SV_Position, uint coverage : SV_Coverage, float4 color : TEXCOORD) {
+    float4 fragmentColor = UnpackColor(PackColor(color));
+
+    uint pixelIdx = uint(position.y) * Width + uint(position.x);
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        if (coverage & (1 << sampleIdx))
+            InsertNode((pixelIdx * MSAA_SAMPLE_COUNT + sampleIdx) * NODE_COUNT, position.z, fragmentColor);
+    }
+}
+
+[numthreads(8, 8, 1)]
+void CSComposite(uint3 id: SV_DispatchThreadID) {
+
+    // Threads past the right edge would read the nodes of the next row.
+    if (id.x >= Width)
+        return;
+
+    float4 backBuffer    = BackBuffer[id.xy];
+    float4 resolveBuffer = float4(0.0, 0.0, 0.0, 0.0);
+    bool isCovered = false;
+
+    uint pixelIdx = id.y * Width + id.x;
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        uint baseIdx = (pixelIdx * MSAA_SAMPLE_COUNT + sampleIdx) * NODE_COUNT;
+
+        float3 color = float3(0.0, 0.0, 0.0);
+        float transmittance = 1.0;
+        for (uint nodeIdx = 0; nodeIdx < NODE_COUNT; nodeIdx++) {
+            AdaptiveNode node = NodesSRV[baseIdx + nodeIdx];
+            if (asuint(node.Depth) == EMPTY_NODE_BITS)
+                break;
+            color += node.Color;
+            transmittance = node.Transmittance;
+            isCovered = true;
+        }
+        resolveBuffer += float4(color + backBuffer.rgb * transmittance, lerp(1.0, backBuffer.a, transmittance));
+    }
+
+    // Untouched pixels keep the resolved opaque color, like the empty lists of CSMain.
+    if (isCovered)
+        BackBuffer[id.xy] = resolveBuffer / MSAA_SAMPLE_COUNT;
+}
@@ -0,0 +1,90 @@
+#include "Common.hlsli"
+
+// Same permutation as ResolveGeometry.hlsl, so the walk stops where CSMain stops.
+#ifndef FRAGMENT_COUNT
+#define FRAGMENT_COUNT    32
+#endif
+
+#ifndef MSAA_SAMPLE_COUNT
+#define MSAA_SAMPLE_COUNT 4
+#endif
+
+#ifndef RESOLVE_SINGLE_TRAVERSAL
+#define RESOLVE_SINGLE_TRAVERSAL 0
+#endif
+
+#include "FrontToBack.hlsli"
+#include "NodeEncoding.hlsli"
+
+// Histogram bins, OIT::DEPTH_COMPLEXITY_BIN_COUNT. The last bin also counts every longer list.
+#define BIN_COUNT 256
+
+// Depth complexity of the linked lists, the GPU side of OIT::Engine::MeasureDepthComplexity. CSCount walks the list
+// of every pixel once to count its nodes and again like CSMain to count the nodes it loads. StatisticsUAV holds
+// BIN_COUNT histogram bins followed by the maximum node count, the total nodes, the nodes CSMain loads and the pixels
+// where it leaves out a node of at least one sample. The host clears it to zero.
+
+Texture2D<uint>                         HeadPointersSRV : register(t0);
+#if NODE_LAYOUT_SOA
+StructuredBuffer<StoredListNodeLink>    LinkedListSRV   : register(t1);
+#else
+StructuredBuffer<StoredListNode>        LinkedListSRV   : register(t1);
+#endif
+RWTexture2D<uint>                       NodeCountsUAV   : register(u0);
+RWByteAddressBuffer                     StatisticsUAV   : register(u1);
+
+// Next and Coverage of a node, the payload is never needed.
+ListNode LoadListNodeLink(uint nodeIdx) {
+#if NODE_LAYOUT_SOA
+    return UnpackListNodeLink(LinkedListSRV[nodeIdx]);
+#else
+    return UnpackListNode(LinkedListSRV[nodeIdx]);
+#endif
+}
+
+[numthreads(8, 8, 1)]
+void CSCount(uint3 id: SV_DispatchThreadID) {
+    uint width, height;
+    NodeCountsUAV.GetDimensions(width, height);
+    if (id.x >= width || id.y >= height)
+        return;
+
+    uint nodeHead = HeadPointersSRV[id.xy];
+    uint count = 0;
+    for (uint nodeIdx = nodeHead; nodeIdx != 0xFFFFFFFF; nodeIdx = LoadListNodeLink(nodeIdx).Next)
+        count++;
+
+    NodeCountsUAV[id.xy] = count;
+    StatisticsUAV.InterlockedAdd(4 * min(count, BIN_COUNT - 1), 1);
+    if (count == 0)
+        return;
+
+#if RESOLVE_SINGLE_TRAVERSAL
+    uint visited = min(count, FRAGMENT_COUNT);
+    bool isTruncated = count > FRAGMENT_COUNT;
+#else
+    uint visited = 0;
+    bool isTruncated = false;
+    for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        uint sampleCount = 0;
+        uint nodeIdx = nodeHead;
+        while (nodeIdx != 0xFFFFFFFF && sampleCount < FRAGMENT_COUNT) {
+            ListNode link = LoadListNodeLink(nodeIdx);
+            sampleCount += (link.Coverage >> sampleIdx) & 1;
+            nodeIdx = link.Next;
+            visited++;
+        }
+        while (nodeIdx != 0xFFFFFFFF && !isTruncated) {
+            ListNode link = LoadListNodeLink(nodeIdx);
+            isTruncated = ((link.Coverage >> sampleIdx) & 1) != 0;
+            nodeIdx = link.Next;
+        }
+    }
+#endif
+
+    StatisticsUAV.InterlockedMax(4 * BIN_COUNT, count);
+    StatisticsUAV.InterlockedAdd(4 * (BIN_COUNT + 1), count);
+    StatisticsUAV.InterlockedAdd(4 * (BIN_COUNT + 2), visited);
+    if (isTruncated)
+        StatisticsUAV.InterlockedAdd(4 * (BIN_COUNT + 3), 1);
+}
@@ -0,0 +1,311 @@
+#include "Common.hlsli"
+
+// Same permutation as ResolveGeometry.hlsl, so CSResolve sorts and blends like CSMain.
+#ifndef FRAGMENT_COUNT
+#define FRAGMENT_COUNT    32
+#endif
+
+#ifndef MSAA_SAMPLE_COUNT
+#define MSAA_SAMPLE_COUNT 4
+#endif
+
+#ifndef RESOLVE_SINGLE_TRAVERSAL
+#define RESOLVE_SINGLE_TRAVERSAL 0
+#endif
+
+#ifndef RESOLVE_SORTING_NETWORKS
+#define RESOLVE_SORTING_NETWORKS 1
+#endif
+
+// 1: the ranges are numbered like the tiled head pointers of OIT/HeadAddressing.hpp, every 8x8 tile of CSResolve
+// contiguous with its pixels in Z-order. Used by the compacted lists, the prefix sum method numbers them row by row.
+#ifndef FRAGMENT_SLOTS_TILED
+#define FRAGMENT_SLOTS_TILED 0
+#endif
+
+#include "FrontToBack.hlsli"
+#include "NodeEncoding.hlsli"
+#include "SortingNetwork.hlsli"
+
+// Elements one thread group of CSScanGroups scans, one per thread.
+#define SCAN_GROUP_SIZE 1024
+
+// Per-pixel fragment arrays built in two geometry passes, OIT::TransparencyMethod::PrefixSum. PSCount draws the
+// transparent geometry with the VSMain of TransparentGeometry.hlsl and counts the fragments of every pixel. The
+// counts buffer has one element more than there are pixels, always zero, so the exclusive prefix sum of CSScanGroups,
+// CSScanGroupSums and CSAddGroupOffsets ends in the total fragment count, which the host reads back to size the
+// fragment buffer. PSFill draws the geometry again and counts back down to place every fragment in the range of its
+// pixel. CSResolve reads each range linearly, there are no links. OIT/Engine.cpp mirrors all passes.
+//
+// The linked lists can be compacted into the same arrays before their resolve, OIT::EngineDesc::CompactNodes.
+// CSCountLists walks every list once to count it, the scan runs as above and CSCompactLists walks the lists again
+// to copy their nodes, in list order, into the range of their pixel. The lists keep their single geometry pass.
+
+cbuffer FragmentArrayConstants : register(b0) {
+    uint Width;
+    // Pixels + 1, the elements of the counts and offsets buffers.
+    uint ElementCount;
+    uint Height;
+};
+
+RWStructuredBuffer<uint>           CountsUAV    : register(u1);
+RWStructuredBuffer<ListSubNodeMS>  FragmentsUAV : register(u2);
+
+StructuredBuffer<uint>             CountsSRV    : register(t0);
+RWStructuredBuffer<uint>           OffsetsUAV   : register(u0);
+RWStructuredBuffer<uint>           GroupSumsUAV : register(u1);
+
+StructuredBuffer<uint>             OffsetsSRV   : register(t0);
+StructuredBuffer<ListSubNodeMS>    FragmentsSRV : register(t1);
+RWTexture2D<unorm float4>          BackBuffer   : register(u0);
+
+Texture2D<uint>                         HeadPointersSRV      : register(t2);
+#if NODE_LAYOUT_SOA
+StructuredBuffer<StoredListNodeLink>    LinkedListSRV        : register(t3);
+StructuredBuffer<StoredListNodePayload> LinkedListPayloadSRV : register(t4);
+#else
+StructuredBuffer<StoredListNode>        LinkedListSRV        : register(t3);
+#endif
+
+// Same as in ResolveGeometry.hlsl.
+ListNode LoadListNodeLink(uint nodeIdx) {
+#if NODE_LAYOUT_SOA
+    return UnpackListNodeLink(LinkedListSRV[nodeIdx]);
+#else
+    return UnpackListNode(LinkedListSRV[nodeIdx]);
+#endif
+}
+
+ListNode LoadListNodePayload(uint nodeIdx, ListNode node) {
+#if NODE_LAYOUT_SOA
+    return UnpackListNodePayload(node, LinkedListPayloadSRV[nodeIdx]);
+#else
+    return node;
+#endif
+}
+
+// Spreads the low 3 bits of value to the even bits, MortonEncode of OIT/HeadAddressing.hpp within a tile.
+uint SpreadBits3(uint value) {
+    value &= 0x7;
+    value = (value | (value << 2)) & 0x13;
+    value = (value | (value << 1)) & 0x15;
+    return value;
+}
+
+uint GetFragmentSlot(uint2 pixel) {
+#if FRAGMENT_SLOTS_TILED
+    uint tileCountX = (Width + 7) / 8;
+    uint tileIdx = (pixel.y / 8) * tileCountX + pixel.x / 8;
+    return tileIdx * 64 + (SpreadBits3(pixel.x % 8) | (SpreadBits3(pixel.y % 8) << 1));
+#else
+    return pixel.y * Width + pixel.x;
+#endif
+}
+
+groupshared uint ScanBuffer[2][SCAN_GROUP_SIZE];
+
+// Exclusive prefix sum of value over the threads of the group, Hillis and Steele on two buffers. Returns the sum in
+// front of threadIdx and sets total to the sum of the whole group. The first barrier keeps a previous call that is
+// still reading the total apart from this one.
+uint ScanGroup(uint threadIdx, uint value, out uint total) {
+    uint src = 0;
+    GroupMemoryBarrierWithGroupSync();
+    ScanBuffer[src][threadIdx] = value;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll] for (uint stride = 1; stride < SCAN_GROUP_SIZE; stride *= 2) {
+        uint sum = ScanBuffer[src][threadIdx];
+        if (threadIdx >= stride)
+            sum += ScanBuffer[src][threadIdx - stride];
+        ScanBuffer[1 - src][threadIdx] = sum;
+        src = 1 - src;
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    total = ScanBuffer[src][SCAN_GROUP_SIZE - 1];
+    return ScanBuffer[src][threadIdx] - value;
+}
+
+[earlydepthstencil]
+void PSCount(float4 position : SV_Position, uint coverage : SV_Coverage, float4 color : TEXCOORD) {
+    InterlockedAdd(CountsUAV[GetFragmentSlot(uint2(position.xy))], 1);
+}
+
+// One thread per pixel of the tiles, the padding of the last ones counts zero.
+[numthreads(8, 8, 1)]
+void CSCountLists(uint3 id : SV_DispatchThreadID) {
+    uint count = 0;
+    if (id.x < Width && id.y < Height) {
+        for (uint nodeIdx = HeadPointersSRV[id.xy]; nodeIdx != 0xFFFFFFFF; nodeIdx = LoadListNodeLink(nodeIdx).Next)
+            count++;
+    }
+    CountsUAV[GetFragmentSlot(id.xy)] = count;
+}
+
+// Offsets within each group of SCAN_GROUP_SIZE pixels, and the sum of every group.
+[numthreads(SCAN_GROUP_SIZE, 1, 1)]
+void CSScanGroups(uint3 id : SV_DispatchThreadID, uint3 threadId : SV_GroupThreadID, uint3 groupId : SV_GroupID) {
+    uint value = id.x < ElementCount ? CountsSRV[id.x] : 0;
+    uint total;
+    uint offset = ScanGroup(threadId.x, value, total);
+    if (id.x < ElementCount)
+        OffsetsUAV[id.x] = offset;
+    if (threadId.x == 0)
+        GroupSumsUAV[groupId.x] = total;
+}
+
+// Exclusive prefix sum of the group sums in place, a single group stepping through them with a running total.
+[numthreads(SCAN_GROUP_SIZE, 1, 1)]
+void CSScanGroupSums(uint3 threadId : SV_GroupThreadID) {
+    uint groupCount = (ElementCount + SCAN_GROUP_SIZE - 1) / SCAN_GROUP_SIZE;
+    uint runningTotal = 0;
+    for (uint baseIdx = 0; baseIdx < groupCount; baseIdx += SCAN_GROUP_SIZE) {
+        uint groupIdx = baseIdx + threadId.x;
+        uint value = groupIdx < groupCount ? GroupSumsUAV[groupIdx] : 0;
+        uint total;
+        uint offset = ScanGroup(threadId.x, value, total);
+        if (groupIdx < groupCount)
+            GroupSumsUAV[groupIdx] = runningTotal + offset;
+        runningTotal += total;
+    }
+}
+
+[numthreads(SCAN_GROUP_SIZE, 1, 1)]
+void CSAddGroupOffsets(uint3 id : SV_DispatchThreadID, uint3 groupId : SV_GroupID) {
+    if (id.x < ElementCount)
+        OffsetsUAV[id.x] += GroupSumsUAV[groupId.x];
+}
+
+// Same fragments as PSCount. The ranges fill from their end; fragments past a fragment buffer sized for an earlier
+// frame are dropped.
+[earlydepthstencil]
+void PSFill(float4 position : SV_Position, uint coverage : SV_Coverage, float4 color : TEXCOORD) {
+    uint slot = GetFragmentSlot(uint2(position.xy));
+    uint count;
+    InterlockedAdd(CountsUAV[slot], 0xFFFFFFFF, count);
+
+    uint fragmentIdx = OffsetsSRV[slot] + count - 1;
+    uint fragmentCapacity, fragmentStride;
+    FragmentsUAV.GetDimensions(fragmentCapacity, fragmentStride);
+    if (fragmentIdx >= fragmentCapacity)
+        return;
+
+    ListSubNodeMS fragment;
+    fragment.Depth = position.z;
+    fragment.Color = PackColor(color);
+    fragment.Coverage = coverage;
+    FragmentsUAV[fragmentIdx] = fragment;
+}
+
+// Copies every list into the range of its pixel in list order, so the resolve keeps the order of ties. Lists past a
+// fragment buffer sized for an earlier frame are cut.
+[numthreads(8, 8, 1)]
+void CSCompactLists(uint3 id : SV_DispatchThreadID) {
+    if (id.x >= Width || id.y >= Height)
+        return;
+
+    uint fragmentCapacity, fragmentStride;
+    FragmentsUAV.GetDimensions(fragmentCapacity, fragmentStride);
+    uint fragmentIdx = OffsetsSRV[GetFragmentSlot(id.xy)];
+    for (uint nodeIdx = HeadPointersSRV[id.xy]; nodeIdx != 0xFFFFFFFF && fragmentIdx < fragmentCapacity; fragmentIdx++) {
+        ListNode node = LoadListNodePayload(nodeIdx, LoadListNodeLink(nodeIdx));
+        ListSubNodeMS fragment;
+        fragment.Depth = asfloat(node.Depth);
+        fragment.Color = node.Color;
+        fragment.Coverage = node.Coverage;
+        FragmentsUAV[fragmentIdx] = fragment;
+        nodeIdx = node.Next;
+    }
+}
+
+[numthreads(8, 8, 1)]
+void CSResolve(uint3 id : SV_DispatchThreadID) {
+    if (id.x >= Width || id.y >= Height)
+        return;
+
+    uint slot = GetFragmentSlot(id.xy);
+    uint fragmentCapacity, fragmentStride;
+    FragmentsSRV.GetDimensions(fragmentCapacity, fragmentStride);
+    uint begin = OffsetsSRV[slot];
+    uint end = min(OffsetsSRV[slot + 1], fragmentCapacity);
+    if (begin >= end)
+        return;
+
+    float4 backBuffer    = BackBuffer[id.xy];
+    float4 resolveBuffer = float4(0.0, 0.0, 0.0, 0.0f);
+
+#if RESOLVE_SINGLE_TRAVERSAL
+    ListSubNodeMS nodes[FRAGMENT_COUNT];
+
+    uint count = min(end - begin, FRAGMENT_COUNT);
+    for (uint index = 0; index < count; index++)
+        nodes[index] = FragmentsSRV[begin + index];
+
+    bool isSorted = false;
+#if RESOLVE_SORTING_NETWORKS
+    SORTING_NETWORK(ListSubNodeMS, isSorted)
+#endif
+    for (uint i = 1; i < count && !isSorted; i++) {
+        ListSubNodeMS t = nodes[i];
+        uint j = i;
+        while (j > 0 && (nodes[j - 1].Depth < t.Depth)) {
+            nodes[j] = nodes[j - 1];
+            j--;
+        }
+        nodes[j] = t;
+    }
+
+#if RESOLVE_FRONT_TO_BACK
+    resolveBuffer = CompositeFrontToBack(nodes, count, backBuffer);
+#else
+    float4 dstPixelColors[MSAA_SAMPLE_COUNT];
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++)
+        dstPixelColors[sampleIdx] = backBuffer;
+
+    for (uint index = 0; index < count; index++) {
+        float4 srcPixelColor = UnpackColor(nodes[index].Color);
+        [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+            if (nodes[index].Coverage & (1 << sampleIdx))
+                dstPixelColors[sampleIdx] = lerp(dstPixelColors[sampleIdx], srcPixelColor, srcPixelColor.a);
+        }
+    }
+
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++)
+        resolveBuffer += dstPixelColors[sampleIdx];
+#endif
+#else
+    ListSubNode nodes[FRAGMENT_COUNT];
+    for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+
+        uint count = 0;
+        for (uint fragmentIdx = begin; fragmentIdx < end && count < FRAGMENT_COUNT; fragmentIdx++) {
+            ListSubNodeMS fragment = FragmentsSRV[fragmentIdx];
+            if (fragment.Coverage & (1 << sampleIdx)) {
+                nodes[count].Depth = fragment.Depth;
+                nodes[count].Color = fragment.Color;
+                count++;
+            }
+        }
+
+        bool isSorted = false;
+#if RESOLVE_SORTING_NETWORKS
+        SORTING_NETWORK(ListSubNode, isSorted)
+#endif
+        for (uint i = 1; i < count && !isSorted; i++) {
+            ListSubNode t = nodes[i];
+            uint j = i;
+            while (j > 0 && (nodes[j - 1].Depth < t.Depth)) {
+                nodes[j] = nodes[j - 1];
+                j--;
+            }
+            nodes[j] = t;
+        }
+
+        float4 dstPixelColor = backBuffer;
+        for (uint index = 0; index < count; index++)
+            dstPixelColor = BlendListSubNode(dstPixelColor, nodes[index]);
+        resolveBuffer += dstPixelColor;
+    }
+#endif
+    BackBuffer[id.xy] = resolveBuffer / MSAA_SAMPLE_COUNT;
+}
@@ -0,0 +1,49 @@
+// Front to back compositing of the sorted single traversal nodes, mirroring OIT::ResolveMode::FrontToBack. Included
+// after FRAGMENT_COUNT and MSAA_SAMPLE_COUNT are defined.
+
+// 1: composite the sorted nodes front to back and stop once every sample lets less than
+// RESOLVE_TRANSMITTANCE_EPSILON of the nodes behind through. Walks the lists like RESOLVE_SINGLE_TRAVERSAL.
+#ifndef RESOLVE_FRONT_TO_BACK
+#define RESOLVE_FRONT_TO_BACK 0
+#endif
+
+// OIT::EngineDesc::ResolveTransmittanceEpsilon.
+#ifndef RESOLVE_TRANSMITTANCE_EPSILON
+#define RESOLVE_TRANSMITTANCE_EPSILON (1.0f / 512.0f)
+#endif
+
+#if RESOLVE_FRONT_TO_BACK
+#undef  RESOLVE_SINGLE_TRAVERSAL
+#define RESOLVE_SINGLE_TRAVERSAL 1
+#endif
+
+// Takes the nodes sorted back to front and walks them from the end, so equal depths stay mirrored like in the back
+// to front blend. Returns the sum of the samples.
+float4 CompositeFrontToBack(ListSubNodeMS nodes[FRAGMENT_COUNT], uint count, float4 backBuffer) {
+    float4 accumulated[MSAA_SAMPLE_COUNT];
+    float  transmittance[MSAA_SAMPLE_COUNT];
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        accumulated[sampleIdx] = float4(0.0f, 0.0f, 0.0f, 0.0f);
+        transmittance[sampleIdx] = 1.0f;
+    }
+
+    for (uint index = count; index > 0; index--) {
+        ListSubNodeMS node = nodes[index - 1];
+        float4 srcPixelColor = UnpackColor(node.Color);
+        float maxTransmittance = 0.0f;
+        [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+            if (node.Coverage & (1 << sampleIdx)) {
+                accumulated[sampleIdx] += srcPixelColor * (transmittance[sampleIdx] * srcPixelColor.a);
+                transmittance[sampleIdx] *= 1.0f - srcPixelColor.a;
+            }
+            maxTransmittance = max(maxTransmittance, transmittance[sampleIdx]);
+        }
+        if (maxTransmittance < RESOLVE_TRANSMITTANCE_EPSILON)
+            break;
+    }
+
+    float4 resolveBuffer = float4(0.0f, 0.0f, 0.0f, 0.0f);
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++)
+        resolveBuffer += accumulated[sampleIdx] + backBuffer * transmittance[sampleIdx];
+    return resolveBuffer;
+}
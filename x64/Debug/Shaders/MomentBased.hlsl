@@ -0,0 +1,137 @@
+#include "Common.hlsli"
+
+#ifndef MSAA_SAMPLE_COUNT
+#define MSAA_SAMPLE_COUNT 4
+#endif
+
+// Moment-based OIT (Muenstermann et al. 2018) with four power moments. PSGenerate draws the transparent geometry with
+// the VSMain of TransparentGeometry.hlsl and sums the absorbance and its power moments over depth into two MSAA
+// targets. PSResolve draws it a second time, reconstructs the transmittance in front of every fragment from the
+// moments and sums the attenuated colors. CSComposite renormalizes that sum to the exact total transmittance. Both
+// geometry passes shade per sample. OIT/MomentBased.hpp mirrors all three.
+
+// Bias towards the moments of a uniform distribution, for 32-bit moments, and the weight of the fragment's own depth
+// in the reconstructed absorbance.
+#define MOMENT_BIAS           5.0e-7
+#define MOMENT_OVERESTIMATION 0.25
+
+Texture2DMS<float>         Moment0SRV      : register(t0);
+Texture2DMS<float4>        MomentsSRV      : register(t1);
+Texture2DMS<float4>        AccumulationSRV : register(t2);
+RWTexture2D<unorm float4>  BackBuffer      : register(u0);
+
+float GetMomentDepth(float depth) {
+    return 2.0 * depth - 1.0;
+}
+
+// The alpha is clamped so that an opaque fragment does not produce an infinity.
+float GetMomentAbsorbance(float alpha) {
+    return -log(1.0 - min(saturate(alpha), 0.999));
+}
+
+// Hamburger bound of algorithm 2 of "Moment Shadow Mapping" (Peters and Klein) on the normalized power moments.
+float ComputeTransmittance(float moment0, float4 moments, float depth) {
+    if (moment0 < 1.0e-3)
+        return 1.0;
+
+    float4 b = lerp(moments / moment0, float4(0.0, 0.375, 0.0, 0.375), MOMENT_BIAS);
+
+    // Cholesky factorization of the Hankel matrix, only the non-trivial entries.
+    float z0 = GetMomentDepth(depth);
+    float l21d11 = b[2] - b[0] * b[1];
+    float d11 = b[1] - b[0] * b[0];
+    float invD11 = 1.0 / d11;
+    float l21 = l21d11 * invD11;
+    float squaredDepthVariance = b[3] - b[1] * b[1];
+    float d22 = squaredDepthVariance - l21d11 * l21;
+
+    // Solve B c = (1, z0, z0^2) by forward substitution, scaling and backward substitution.
+    float3 c = float3(1.0, z0, z0 * z0);
+    c[1] -= b[0];
+    c[2] -= b[1] + l21 * c[1];
+    c[1] *= invD11;
+    c[2] /= d22;
+    c[1] -= l21 * c[2];
+    c[0] -= c[1] * b[0] + c[2] * b[1];
+
+    // Cancellation-free roots: when z0 is a support point c2 vanishes, z1 stays finite and z2 goes to infinity.
+    float r = sqrt(max(c[1] * c[1] - 4.0 * c[0] * c[2], 0.0));
+    float t = -0.5 * (c[1] + (c[1] < 0.0 ? -r : r));
+    float z1 = c[0] / t;
+    float z2 = t / c[2];
+
+    float f0 = MOMENT_OVERESTIMATION;
+    float f1 = z1 < z0 ? 1.0 : 0.0;
+    float f2 = z2 < z0 ? 1.0 : 0.0;
+    float f01 = (f1 - f0) / (z1 - z0);
+    float f12 = (f2 - f1) / (z2 - z1);
+    float f012 = (f12 - f01) / (z2 - z0);
+
+    float3 polynomial;
+    polynomial[0] = f012;
+    polynomial[1] = polynomial[0];
+    polynomial[0] = f01 - polynomial[0] * z1;
+    polynomial[2] = polynomial[1];
+    polynomial[1] = polynomial[0] - polynomial[1] * z0;
+    polynomial[0] = f0 - polynomial[0] * z0;
+
+    float absorbance = polynomial[0] + polynomial[1] * b[0] + polynomial[2] * b[1];
+    if (!isfinite(absorbance))
+        absorbance = f0;
+    return saturate(exp(-moment0 * absorbance));
+}
+
+struct GenerateOutput {
+    float  Moment0 : SV_Target0;
+    float4 Moments : SV_Target1;
+};
+
+// Blended with ONE/ONE into both targets. SV_SampleIndex runs the shader per sample, so every sample receives the
+// moments of its own depth.
+GenerateOutput PSGenerate(float4 position : SV_Position, float4 color : TEXCOORD, uint sampleIdx : SV_SampleIndex) {
+    float absorbance = GetMomentAbsorbance(color.a);
+    float z = GetMomentDepth(position.z);
+    float z2 = z * z;
+
+    GenerateOutput output;
+    output.Moment0 = absorbance;
+    output.Moments = absorbance * float4(z, z2, z2 * z, z2 * z2);
+    return output;
+}
+
+// Blended with ONE/ONE into the accumulation.
+float4 PSResolve(float4 position : SV_Position, float4 color : TEXCOORD, uint sampleIdx : SV_SampleIndex) : SV_Target {
+    color = saturate(color);
+    int2 location = int2(position.xy);
+    float transmittance = ComputeTransmittance(Moment0SRV.Load(location, sampleIdx), MomentsSRV.Load(location, sampleIdx), position.z);
+    return float4(color.rgb, 1.0) * color.a * transmittance;
+}
+
+[numthreads(8, 8, 1)]
+void CSComposite(uint3 id: SV_DispatchThreadID) {
+
+    float moment0[MSAA_SAMPLE_COUNT];
+    bool isCovered = false;
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        moment0[sampleIdx] = Moment0SRV.Load(id.xy, sampleIdx);
+        isCovered = isCovered || moment0[sampleIdx] > 0.0;
+    }
+
+    // Untouched pixels keep the resolved opaque color, like the empty lists of CSMain.
+    if (!isCovered)
+        return;
+
+    float4 backBuffer    = BackBuffer[id.xy];
+    float4 resolveBuffer = float4(0.0, 0.0, 0.0, 0.0);
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        float4 accumulation = AccumulationSRV.Load(id.xy, sampleIdx);
+        float transmittance = exp(-moment0[sampleIdx]);
+        if (accumulation.a < 1.0e-5) {
+            resolveBuffer += backBuffer;
+            continue;
+        }
+        float3 color = accumulation.rgb * (1.0 - transmittance) / accumulation.a + backBuffer.rgb * transmittance;
+        resolveBuffer += float4(color, lerp(1.0, backBuffer.a, transmittance));
+    }
+    BackBuffer[id.xy] = resolveBuffer / MSAA_SAMPLE_COUNT;
+}
@@ -1,7 +1,13 @@
 #include "Common.hlsli"
+#include "NodeEncoding.hlsli"
 
-globallycoherent RWTexture2D<uint>            HeadPointersUAV : register(u0);
-globallycoherent RWStructuredBuffer<ListNode> LinkedListUAV   : register(u1);
+globallycoherent RWTexture2D<uint>                         HeadPointersUAV      : register(u0);
+#if NODE_LAYOUT_SOA
+globallycoherent RWStructuredBuffer<StoredListNodeLink>    LinkedListUAV        : register(u1);
+globallycoherent RWStructuredBuffer<StoredListNodePayload> LinkedListPayloadUAV : register(u2);
+#else
+globallycoherent RWStructuredBuffer<StoredListNode>        LinkedListUAV        : register(u1);
+#endif
 
 
 void VSMain(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID, out float4 position : SV_Position, out float4 color : TEXCOORD) {
@@ -18,6 +24,13 @@ void VSMain(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID, out fl
 [earlydepthstencil]
 void PSMain(float4 position : SV_Position, uint coverage : SV_Coverage, float4 color : TEXCOORD) {
     uint nodeIdx = LinkedListUAV.IncrementCounter();
+
+    // Pool exhausted: drop the fragment before it is linked. The counter keeps counting, so the value read back
+    // on the CPU is the number of nodes this frame asked for.
+    uint nodeCapacity, nodeStride;
+    LinkedListUAV.GetDimensions(nodeCapacity, nodeStride);
+    if (nodeIdx >= nodeCapacity)
+        return;
    
     uint prevHead;
     InterlockedExchange(HeadPointersUAV[uint2(position.xy)], nodeIdx, prevHead);
@@ -28,6 +41,11 @@ void PSMain(float4 position : SV_Position, uint coverage : SV_Coverage, float4 c
     node.Next = prevHead;
     node.Coverage = coverage;
     
-    LinkedListUAV[nodeIdx] = node;   
+#if NODE_LAYOUT_SOA
+    LinkedListUAV[nodeIdx] = PackListNodeLink(node);
+    LinkedListPayloadUAV[nodeIdx] = PackListNodePayload(node);
+#else
+    LinkedListUAV[nodeIdx] = PackListNode(node);
+#endif   
 }
 
@@ -11,6 +11,12 @@ struct ListSubNode {
     uint   Color;
 };
 
+struct ListSubNodeMS {
+    float  Depth;
+    uint   Color;
+    uint   Coverage;
+};
+
 uint PackColor(float4 color) {
     return (uint(color.r * 255) << 24) | (uint(color.g * 255) << 16) | (uint(color.b * 255) << 8) | uint(color.a * 255);
 }
@@ -23,3 +29,9 @@ float4 UnpackColor(uint color) {
     result.a = float((color >> 0)  & 0x000000FF) / 255.0f;
     return saturate(result);
 }
+
+// One step of the back to front blend of CSMain, shared by every resolve that ends in sorted layers.
+float4 BlendListSubNode(float4 dstPixelColor, ListSubNode node) {
+    float4 srcPixelColor = UnpackColor(node.Color);
+    return lerp(dstPixelColor, srcPixelColor, srcPixelColor.a);
+}
@@ -0,0 +1,127 @@
+#include "Common.hlsli"
+
+#ifndef MSAA_SAMPLE_COUNT
+#define MSAA_SAMPLE_COUNT 4
+#endif
+
+// Layers per MSAA sample, at most OIT::MAX_MLAB_LAYER_COUNT.
+#ifndef LAYER_COUNT
+#define LAYER_COUNT 4
+#endif
+
+// Multi-layer alpha blending (Salvi and Vaidyanathan 2014), a k-buffer of LAYER_COUNT ListSubNodes per MSAA sample
+// kept back to front. PSInsert draws the transparent geometry with the VSMain of TransparentGeometry.hlsl. It needs
+// rasterizer ordered views (D3D11.3, ROVsSupported) so the layers of a pixel are updated in primitive order, but no
+// node counter and no links. CSComposite blends the layers like CSMain. OIT/MultiLayerAlphaBlending.hpp mirrors both.
+
+// Bits of both fields of an empty slot, cleared with ClearUnorderedAccessViewUint. The depth is -INF, so empty
+// slots sort behind every fragment and the filled layers always form a prefix.
+#define EMPTY_LAYER_BITS 0xFF800000
+
+cbuffer LayerConstants : register(b0) {
+    uint Width;
+};
+
+StructuredBuffer<ListSubNode>                  LayersSRV  : register(t0);
+RWTexture2D<unorm float4>                      BackBuffer : register(u0);
+RasterizerOrderedStructuredBuffer<ListSubNode> LayersROV  : register(u1);
+
+// Single layer that blends like farLayer followed by nearLayer, at the depth of nearLayer.
+ListSubNode MergeLayers(ListSubNode farLayer, ListSubNode nearLayer) {
+    float4 farColor  = UnpackColor(farLayer.Color);
+    float4 nearColor = UnpackColor(nearLayer.Color);
+    float farWeight = farColor.a * (1.0 - nearColor.a);
+    float alpha = farWeight + nearColor.a;
+
+    float4 color = float4(0.0, 0.0, 0.0, 0.0);
+    if (alpha > 0.0)
+        color = float4((farColor.rgb * farWeight + nearColor.rgb * nearColor.a) / alpha, alpha);
+
+    ListSubNode result;
+    result.Depth = nearLayer.Depth;
+    result.Color = PackColor(saturate(color));
+    return result;
+}
+
+// A fragment goes in front of layers of equal depth, the tie order of the list resolve. Once every slot is taken the
+// two farthest of the LAYER_COUNT + 1 layers are merged into the tail.
+void InsertLayer(uint baseIdx, ListSubNode fragment) {
+    if (asuint(LayersROV[baseIdx + LAYER_COUNT - 1].Depth) == EMPTY_LAYER_BITS) {
+        uint layerIdx = LAYER_COUNT - 1;
+        while (layerIdx > 0 && LayersROV[baseIdx + layerIdx - 1].Depth <= fragment.Depth) {
+            LayersROV[baseIdx + layerIdx] = LayersROV[baseIdx + layerIdx - 1];
+            layerIdx--;
+        }
+        LayersROV[baseIdx + layerIdx] = fragment;
+        return;
+    }
+
+    ListSubNode farthest = LayersROV[baseIdx];
+    if (fragment.Depth >= farthest.Depth) {
+        LayersROV[baseIdx] = MergeLayers(fragment, farthest);
+        return;
+    }
+
+#if LAYER_COUNT == 1
+    LayersROV[baseIdx] = MergeLayers(farthest, fragment);
+#else
+    ListSubNode next = LayersROV[baseIdx + 1];
+    if (fragment.Depth >= next.Depth) {
+        LayersROV[baseIdx] = MergeLayers(farthest, fragment);
+        return;
+    }
+
+    LayersROV[baseIdx] = MergeLayers(farthest, next);
+    uint layerIdx = 1;
+    while (layerIdx + 1 < LAYER_COUNT && LayersROV[baseIdx + layerIdx + 1].Depth > fragment.Depth) {
+        LayersROV[baseIdx + layerIdx] = LayersROV[baseIdx + layerIdx + 1];
+        layerIdx++;
+    }
+    LayersROV[baseIdx + layerIdx] = fragment;
+#endif
+}
+
+// Same [earlydepthstencil] and SV_Coverage rules as PSMain: every covered sample receives the fragment.
+[earlydepthstencil]
+void PSInsert(float4 position : SV_Position, uint coverage : SV_Coverage, float4 color : TEXCOORD) {
+    ListSubNode fragment;
+    fragment.Depth = position.z;
+    fragment.Color = PackColor(color);
+
+    uint pixelIdx = uint(position.y) * Width + uint(position.x);
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        if (coverage & (1 << sampleIdx))
+            InsertLayer((pixelIdx * MSAA_SAMPLE_COUNT + sampleIdx) * LAYER_COUNT, fragment);
+    }
+}
+
+[numthreads(8, 8, 1)]
+void CSComposite(uint3 id: SV_DispatchThreadID) {
+
+    // Threads past the right edge would read the layers of the next row.
+    if (id.x >= Width)
+        return;
+
+    float4 backBuffer    = BackBuffer[id.xy];
+    float4 resolveBuffer = float4(0.0, 0.0, 0.0, 0.0);
+    bool isCovered = false;
+
+    uint pixelIdx = id.y * Width + id.x;
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        uint baseIdx = (pixelIdx * MSAA_SAMPLE_COUNT + sampleIdx) * LAYER_COUNT;
+
+        float4 dstPixelColor = backBuffer;
+        for (uint layerIdx = 0; layerIdx < LAYER_COUNT; layerIdx++) {
+            ListSubNode layer = LayersSRV[baseIdx + layerIdx];
+            if (asuint(layer.Depth) == EMPTY_LAYER_BITS)
+                break;
+            dstPixelColor = BlendListSubNode(dstPixelColor, layer);
+            isCovered = true;
+        }
+        resolveBuffer += dstPixelColor;
+    }
+
+    // Untouched pixels keep the resolved opaque color, like the empty lists of CSMain.
+    if (isCovered)
+        BackBuffer[id.xy] = resolveBuffer / MSAA_SAMPLE_COUNT;
+}
@@ -0,0 +1,261 @@
+// Storage encodings of ListNode. Included by the shaders after Common.hlsli and by OIT/NodeEncoding.hpp on the
+// CPU side, so everything below has to stay in the subset both languages accept: uint arithmetic, asuint,
+// asfloat, saturate, typedefs and plain structs.
+//
+// NODE_ENCODING 16: ListNode as declared in Common.hlsli.
+// NODE_ENCODING 12: Next, Color and a word holding 24-bit unorm depth above the 8-bit coverage mask.
+// NODE_ENCODING 8:  24-bit Next above the 8-bit coverage mask and 16-bit unorm depth above RGBA4444 color.
+//                   Lossy, and the pool is limited to LIST_NODE_MAX_COUNT nodes.
+//
+// Quantized depth turns nearby fragments into ties, which both resolves keep in list order.
+//
+// NODE_LAYOUT_SOA 1 splits every node into a link part, which holds Next and the coverage mask (plus the depth
+// sharing its word in the 12-byte encoding), and a payload part holding the rest, each in its own buffer. A list
+// walk that filters by coverage then only reads the payload of the nodes it keeps.
+
+#ifndef NODE_ENCODING
+#define NODE_ENCODING 16
+#endif
+
+#ifndef NODE_LAYOUT_SOA
+#define NODE_LAYOUT_SOA 0
+#endif
+
+#ifndef NODE_ENCODING_INLINE
+#define NODE_ENCODING_INLINE
+#endif
+
+static const uint NODE_DEPTH24_MAX    = 0x00FFFFFF;
+static const uint NODE_DEPTH16_MAX    = 0x0000FFFF;
+static const uint NODE_NEXT24_INVALID = 0x00FFFFFF;
+
+struct ListNodeCompact12 {
+    uint Next;
+    uint Color;
+    uint DepthCoverage;
+};
+
+struct ListNodeCompact8 {
+    uint NextCoverage;
+    uint DepthColor;
+};
+
+struct ListNodeLink {
+    uint Next;
+    uint Coverage;
+};
+
+struct ListNodePayload {
+    uint Color;
+    uint Depth;
+};
+
+struct ListNodeLinkCompact12 {
+    uint Next;
+    uint DepthCoverage;
+};
+
+struct ListNodePayloadCompact12 {
+    uint Color;
+};
+
+struct ListNodeLinkCompact8 {
+    uint NextCoverage;
+};
+
+struct ListNodePayloadCompact8 {
+    uint DepthColor;
+};
+
+NODE_ENCODING_INLINE uint EncodeDepthUnorm(float depth, uint maxValue) {
+    return uint(saturate(depth) * float(maxValue) + 0.5f);
+}
+
+NODE_ENCODING_INLINE float DecodeDepthUnorm(uint bits, uint maxValue) {
+    return float(bits) / float(maxValue);
+}
+
+// Color channels are rounded to 4 bits and expanded back by replication (x * 17).
+NODE_ENCODING_INLINE uint PackColor4444(uint color) {
+    uint result = 0;
+    for (uint shift = 0; shift < 32; shift += 8)
+        result |= ((((color >> shift) & 0xFF) * 15 + 127) / 255) << (shift / 2);
+    return result;
+}
+
+NODE_ENCODING_INLINE uint UnpackColor4444(uint color) {
+    uint result = 0;
+    for (uint shift = 0; shift < 32; shift += 8)
+        result |= (((color >> (shift / 2)) & 0xF) * 17) << shift;
+    return result;
+}
+
+NODE_ENCODING_INLINE uint PackDepthCoverage24(ListNode node) {
+    return (EncodeDepthUnorm(asfloat(node.Depth), NODE_DEPTH24_MAX) << 8) | (node.Coverage & 0xFF);
+}
+
+NODE_ENCODING_INLINE uint PackNextCoverage24(ListNode node) {
+    return (node.Next << 8) | (node.Coverage & 0xFF);
+}
+
+NODE_ENCODING_INLINE uint PackDepthColor16(ListNode node) {
+    return (EncodeDepthUnorm(asfloat(node.Depth), NODE_DEPTH16_MAX) << 16) | PackColor4444(node.Color);
+}
+
+NODE_ENCODING_INLINE ListNode UnpackDepthCoverage24(ListNode node, uint depthCoverage) {
+    node.Depth = asuint(DecodeDepthUnorm(depthCoverage >> 8, NODE_DEPTH24_MAX));
+    node.Coverage = depthCoverage & 0xFF;
+    return node;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackNextCoverage24(ListNode node, uint nextCoverage) {
+    uint next = nextCoverage >> 8;
+    node.Next = next == NODE_NEXT24_INVALID ? 0xFFFFFFFF : next;
+    node.Coverage = nextCoverage & 0xFF;
+    return node;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackDepthColor16(ListNode node, uint depthColor) {
+    node.Depth = asuint(DecodeDepthUnorm(depthColor >> 16, NODE_DEPTH16_MAX));
+    node.Color = UnpackColor4444(depthColor & 0xFFFF);
+    return node;
+}
+
+NODE_ENCODING_INLINE ListNode EmptyListNode() {
+    ListNode node;
+    node.Next = 0xFFFFFFFF;
+    node.Color = 0;
+    node.Depth = 0;
+    node.Coverage = 0;
+    return node;
+}
+
+// StoredListNode is the element type of the node buffer, PackListNode and UnpackListNode convert at its boundary.
+// StoredListNodeLink and StoredListNodePayload are the element types of the two NODE_LAYOUT_SOA buffers.
+// UnpackListNodeLink fills Next and Coverage, UnpackListNodePayload completes the node with the remaining fields.
+#if NODE_ENCODING == 16
+typedef ListNode        StoredListNode;
+typedef ListNodeLink    StoredListNodeLink;
+typedef ListNodePayload StoredListNodePayload;
+
+static const uint LIST_NODE_MAX_COUNT = 0xFFFFFFFF;
+
+NODE_ENCODING_INLINE StoredListNode PackListNode(ListNode node) {
+    return node;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNode(StoredListNode node) {
+    return node;
+}
+
+NODE_ENCODING_INLINE StoredListNodeLink PackListNodeLink(ListNode node) {
+    StoredListNodeLink result;
+    result.Next = node.Next;
+    result.Coverage = node.Coverage;
+    return result;
+}
+
+NODE_ENCODING_INLINE StoredListNodePayload PackListNodePayload(ListNode node) {
+    StoredListNodePayload result;
+    result.Color = node.Color;
+    result.Depth = node.Depth;
+    return result;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNodeLink(StoredListNodeLink link) {
+    ListNode result = EmptyListNode();
+    result.Next = link.Next;
+    result.Coverage = link.Coverage;
+    return result;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNodePayload(ListNode node, StoredListNodePayload payload) {
+    node.Color = payload.Color;
+    node.Depth = payload.Depth;
+    return node;
+}
+#elif NODE_ENCODING == 12
+typedef ListNodeCompact12        StoredListNode;
+typedef ListNodeLinkCompact12    StoredListNodeLink;
+typedef ListNodePayloadCompact12 StoredListNodePayload;
+
+static const uint LIST_NODE_MAX_COUNT = 0xFFFFFFFF;
+
+NODE_ENCODING_INLINE StoredListNode PackListNode(ListNode node) {
+    StoredListNode result;
+    result.Next = node.Next;
+    result.Color = node.Color;
+    result.DepthCoverage = PackDepthCoverage24(node);
+    return result;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNode(StoredListNode node) {
+    ListNode result = EmptyListNode();
+    result.Next = node.Next;
+    result.Color = node.Color;
+    return UnpackDepthCoverage24(result, node.DepthCoverage);
+}
+
+NODE_ENCODING_INLINE StoredListNodeLink PackListNodeLink(ListNode node) {
+    StoredListNodeLink result;
+    result.Next = node.Next;
+    result.DepthCoverage = PackDepthCoverage24(node);
+    return result;
+}
+
+NODE_ENCODING_INLINE StoredListNodePayload PackListNodePayload(ListNode node) {
+    StoredListNodePayload result;
+    result.Color = node.Color;
+    return result;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNodeLink(StoredListNodeLink link) {
+    ListNode result = EmptyListNode();
+    result.Next = link.Next;
+    return UnpackDepthCoverage24(result, link.DepthCoverage);
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNodePayload(ListNode node, StoredListNodePayload payload) {
+    node.Color = payload.Color;
+    return node;
+}
+#elif NODE_ENCODING == 8
+typedef ListNodeCompact8        StoredListNode;
+typedef ListNodeLinkCompact8    StoredListNodeLink;
+typedef ListNodePayloadCompact8 StoredListNodePayload;
+
+static const uint LIST_NODE_MAX_COUNT = NODE_NEXT24_INVALID;
+
+NODE_ENCODING_INLINE StoredListNode PackListNode(ListNode node) {
+    StoredListNode result;
+    result.NextCoverage = PackNextCoverage24(node);
+    result.DepthColor = PackDepthColor16(node);
+    return result;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNode(StoredListNode node) {
+    return UnpackDepthColor16(UnpackNextCoverage24(EmptyListNode(), node.NextCoverage), node.DepthColor);
+}
+
+NODE_ENCODING_INLINE StoredListNodeLink PackListNodeLink(ListNode node) {
+    StoredListNodeLink result;
+    result.NextCoverage = PackNextCoverage24(node);
+    return result;
+}
+
+NODE_ENCODING_INLINE StoredListNodePayload PackListNodePayload(ListNode node) {
+    StoredListNodePayload result;
+    result.DepthColor = PackDepthColor16(node);
+    return result;
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNodeLink(StoredListNodeLink link) {
+    return UnpackNextCoverage24(EmptyListNode(), link.NextCoverage);
+}
+
+NODE_ENCODING_INLINE ListNode UnpackListNodePayload(ListNode node, StoredListNodePayload payload) {
+    return UnpackDepthColor16(node, payload.DepthColor);
+}
+#else
+#error NODE_ENCODING must be 16, 12 or 8
+#endif
@@ -1,12 +1,56 @@
 
 #include "Common.hlsli"
 
+// Defaults of the permutation the host selects, see OIT/ShaderPermutations.hpp.
+#ifndef FRAGMENT_COUNT
 #define FRAGMENT_COUNT    32
+#endif
+
+#ifndef MSAA_SAMPLE_COUNT
 #define MSAA_SAMPLE_COUNT 4
+#endif
+
+// 1: walk and sort every list once and blend all samples in a single ordered pass using the coverage mask.
+// Matches the per-sample loop unless a list holds more than FRAGMENT_COUNT nodes.
+#ifndef RESOLVE_SINGLE_TRAVERSAL
+#define RESOLVE_SINGLE_TRAVERSAL 0
+#endif
+
+// 1: sort lists of up to 8 nodes with the specialized networks of SortingNetwork.hlsli instead of the
+// divergent insertion sort loop.
+#ifndef RESOLVE_SORTING_NETWORKS
+#define RESOLVE_SORTING_NETWORKS 1
+#endif
 
-RWTexture2D<unorm float4>  BackBuffer      : register(u0);
-Texture2D<uint>            HeadPointersSRV : register(t0);
-StructuredBuffer<ListNode> LinkedListSRV   : register(t1);
+#include "FrontToBack.hlsli"
+#include "NodeEncoding.hlsli"
+#include "SortingNetwork.hlsli"
+
+RWTexture2D<unorm float4>               BackBuffer           : register(u0);
+Texture2D<uint>                         HeadPointersSRV      : register(t0);
+#if NODE_LAYOUT_SOA
+StructuredBuffer<StoredListNodeLink>    LinkedListSRV        : register(t1);
+StructuredBuffer<StoredListNodePayload> LinkedListPayloadSRV : register(t2);
+#else
+StructuredBuffer<StoredListNode>        LinkedListSRV        : register(t1);
+#endif
+
+// Next and Coverage of a node. The AoS layout returns the whole node and LoadListNodePayload passes it through.
+ListNode LoadListNodeLink(uint nodeIdx) {
+#if NODE_LAYOUT_SOA
+    return UnpackListNodeLink(LinkedListSRV[nodeIdx]);
+#else
+    return UnpackListNode(LinkedListSRV[nodeIdx]);
+#endif
+}
+
+ListNode LoadListNodePayload(uint nodeIdx, ListNode node) {
+#if NODE_LAYOUT_SOA
+    return UnpackListNodePayload(node, LinkedListPayloadSRV[nodeIdx]);
+#else
+    return node;
+#endif
+}
 
 [numthreads(8, 8, 1)]
 void CSMain(uint3 id: SV_DispatchThreadID) {
@@ -17,24 +61,82 @@ void CSMain(uint3 id: SV_DispatchThreadID) {
     uint nodeHead = HeadPointersSRV[id.xy];
     if (nodeHead == 0xFFFFFFFF)
         return;
+
+    // The list end 0xFFFFFFFF is past any capacity, so the walks stop on it and on any index the buffer does not hold.
+    uint nodeCapacity = 0;
+    uint nodeStride = 0;
+    LinkedListSRV.GetDimensions(nodeCapacity, nodeStride);
     
+#if RESOLVE_SINGLE_TRAVERSAL
+    ListSubNodeMS nodes[FRAGMENT_COUNT];
+
+    uint count = 0;
+    uint nodeIdx = nodeHead;
+
+    while (nodeIdx < nodeCapacity && count < FRAGMENT_COUNT) {
+        ListNode node = LoadListNodePayload(nodeIdx, LoadListNodeLink(nodeIdx));
+        nodes[count].Depth = asfloat(node.Depth);
+        nodes[count].Color = node.Color;
+        nodes[count].Coverage = node.Coverage;
+        count++;
+        nodeIdx = node.Next;
+    }
+
+    bool isSorted = false;
+#if RESOLVE_SORTING_NETWORKS
+    SORTING_NETWORK(ListSubNodeMS, isSorted)
+#endif
+    for (uint i = 1; i < count && !isSorted; i++) {
+        ListSubNodeMS t = nodes[i];
+        uint j = i;
+        while (j > 0 && (nodes[j - 1].Depth < t.Depth)) {
+            nodes[j] = nodes[j - 1];
+            j--;
+        }
+        nodes[j] = t;
+    }
+
+#if RESOLVE_FRONT_TO_BACK
+    resolveBuffer = CompositeFrontToBack(nodes, count, backBuffer);
+#else
+    float4 dstPixelColors[MSAA_SAMPLE_COUNT];
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++)
+        dstPixelColors[sampleIdx] = backBuffer;
+
+    for (uint index = 0; index < count; index++) {
+        float4 srcPixelColor = UnpackColor(nodes[index].Color);
+        [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+            if (nodes[index].Coverage & (1 << sampleIdx))
+                dstPixelColors[sampleIdx] = lerp(dstPixelColors[sampleIdx], srcPixelColor, srcPixelColor.a);
+        }
+    }
+
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++)
+        resolveBuffer += dstPixelColors[sampleIdx];
+#endif
+#else
     ListSubNode nodes[FRAGMENT_COUNT]; 
     for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
        
         uint count = 0;
         uint nodeIdx = nodeHead;
      
-        while (nodeIdx != 0xFFFFFFFF && count < FRAGMENT_COUNT) {
-            ListNode node = LinkedListSRV[nodeIdx];
-            if (node.Coverage & (1 << sampleIdx)) {
+        while (nodeIdx < nodeCapacity && count < FRAGMENT_COUNT) {
+            ListNode link = LoadListNodeLink(nodeIdx);
+            if (link.Coverage & (1 << sampleIdx)) {
+                ListNode node = LoadListNodePayload(nodeIdx, link);
                 nodes[count].Depth = asfloat(node.Depth);
                 nodes[count].Color = node.Color;
                 count++;
             }
-            nodeIdx = node.Next;
+            nodeIdx = link.Next;
         }
               
-        for (uint i = 1; i < count; i++) {
+        bool isSorted = false;
+#if RESOLVE_SORTING_NETWORKS
+        SORTING_NETWORK(ListSubNode, isSorted)
+#endif
+        for (uint i = 1; i < count && !isSorted; i++) {
             ListSubNode t = nodes[i];
             uint j = i;
             while (j > 0 && (nodes[j - 1].Depth < t.Depth)) {
@@ -45,11 +147,10 @@ void CSMain(uint3 id: SV_DispatchThreadID) {
         }
          
         float4 dstPixelColor = backBuffer;
-        for (uint index = 0; index < count; index++) {
-            float4 srcPixelColor = UnpackColor(nodes[index].Color);
-            dstPixelColor = lerp(dstPixelColor, srcPixelColor, srcPixelColor.a);
-        }
+        for (uint index = 0; index < count; index++)
+            dstPixelColor = BlendListSubNode(dstPixelColor, nodes[index]);
         resolveBuffer += dstPixelColor;
     }  
+#endif
     BackBuffer[id.xy] = resolveBuffer / MSAA_SAMPLE_COUNT;
 }
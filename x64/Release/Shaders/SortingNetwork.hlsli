@@ -0,0 +1,154 @@
+// Sorting networks for the short per-pixel lists that dominate typical scenes, mirroring OIT/SortingNetwork.hpp.
+// The macros work on the local arrays `nodes` (any ListSubNode type) and `order` (original positions) so that depth
+// ties keep their list order and the result equals the insertion sort. A case only exists when FRAGMENT_COUNT can
+// reach it; longer lists fall through to the caller's insertion sort.
+
+// Longest list with a network, equal to SORTING_NETWORK_MAX_COUNT of OIT/SortingNetwork.hpp.
+#define SORTING_NETWORK_MAX_COUNT 8
+
+#define COMPARE_EXCHANGE(NodeType, a, b) {                                                   \
+    NodeType nodeA = nodes[a];                                                              \
+    NodeType nodeB = nodes[b];                                                              \
+    uint orderA = order[a];                                                                 \
+    uint orderB = order[b];                                                                 \
+    [flatten] if (nodeA.Depth < nodeB.Depth || (nodeA.Depth == nodeB.Depth && orderB < orderA)) { \
+        nodes[a] = nodeB;                                                                   \
+        nodes[b] = nodeA;                                                                   \
+        order[a] = orderB;                                                                  \
+        order[b] = orderA;                                                                  \
+    }                                                                                       \
+}
+
+#if FRAGMENT_COUNT >= 2
+#define SORTING_NETWORK_CASE_2(NodeType) case 2: \
+    COMPARE_EXCHANGE(NodeType, 0, 1) \
+    break;
+#else
+#define SORTING_NETWORK_CASE_2(NodeType)
+#endif
+
+#if FRAGMENT_COUNT >= 3
+#define SORTING_NETWORK_CASE_3(NodeType) case 3: \
+    COMPARE_EXCHANGE(NodeType, 0, 2) \
+    COMPARE_EXCHANGE(NodeType, 0, 1) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    break;
+#else
+#define SORTING_NETWORK_CASE_3(NodeType)
+#endif
+
+#if FRAGMENT_COUNT >= 4
+#define SORTING_NETWORK_CASE_4(NodeType) case 4: \
+    COMPARE_EXCHANGE(NodeType, 0, 1) \
+    COMPARE_EXCHANGE(NodeType, 2, 3) \
+    COMPARE_EXCHANGE(NodeType, 0, 2) \
+    COMPARE_EXCHANGE(NodeType, 1, 3) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    break;
+#else
+#define SORTING_NETWORK_CASE_4(NodeType)
+#endif
+
+#if FRAGMENT_COUNT >= 5
+#define SORTING_NETWORK_CASE_5(NodeType) case 5: \
+    COMPARE_EXCHANGE(NodeType, 0, 3) \
+    COMPARE_EXCHANGE(NodeType, 1, 4) \
+    COMPARE_EXCHANGE(NodeType, 0, 2) \
+    COMPARE_EXCHANGE(NodeType, 1, 3) \
+    COMPARE_EXCHANGE(NodeType, 0, 1) \
+    COMPARE_EXCHANGE(NodeType, 2, 4) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    COMPARE_EXCHANGE(NodeType, 3, 4) \
+    COMPARE_EXCHANGE(NodeType, 2, 3) \
+    break;
+#else
+#define SORTING_NETWORK_CASE_5(NodeType)
+#endif
+
+#if FRAGMENT_COUNT >= 6
+#define SORTING_NETWORK_CASE_6(NodeType) case 6: \
+    COMPARE_EXCHANGE(NodeType, 0, 5) \
+    COMPARE_EXCHANGE(NodeType, 1, 3) \
+    COMPARE_EXCHANGE(NodeType, 2, 4) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    COMPARE_EXCHANGE(NodeType, 3, 4) \
+    COMPARE_EXCHANGE(NodeType, 0, 3) \
+    COMPARE_EXCHANGE(NodeType, 2, 5) \
+    COMPARE_EXCHANGE(NodeType, 0, 1) \
+    COMPARE_EXCHANGE(NodeType, 2, 3) \
+    COMPARE_EXCHANGE(NodeType, 4, 5) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    COMPARE_EXCHANGE(NodeType, 3, 4) \
+    break;
+#else
+#define SORTING_NETWORK_CASE_6(NodeType)
+#endif
+
+#if FRAGMENT_COUNT >= 7
+#define SORTING_NETWORK_CASE_7(NodeType) case 7: \
+    COMPARE_EXCHANGE(NodeType, 0, 6) \
+    COMPARE_EXCHANGE(NodeType, 2, 3) \
+    COMPARE_EXCHANGE(NodeType, 4, 5) \
+    COMPARE_EXCHANGE(NodeType, 0, 2) \
+    COMPARE_EXCHANGE(NodeType, 1, 4) \
+    COMPARE_EXCHANGE(NodeType, 3, 6) \
+    COMPARE_EXCHANGE(NodeType, 0, 1) \
+    COMPARE_EXCHANGE(NodeType, 2, 5) \
+    COMPARE_EXCHANGE(NodeType, 3, 4) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    COMPARE_EXCHANGE(NodeType, 4, 6) \
+    COMPARE_EXCHANGE(NodeType, 2, 3) \
+    COMPARE_EXCHANGE(NodeType, 4, 5) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    COMPARE_EXCHANGE(NodeType, 3, 4) \
+    COMPARE_EXCHANGE(NodeType, 5, 6) \
+    break;
+#else
+#define SORTING_NETWORK_CASE_7(NodeType)
+#endif
+
+#if FRAGMENT_COUNT >= 8
+#define SORTING_NETWORK_CASE_8(NodeType) case 8: \
+    COMPARE_EXCHANGE(NodeType, 0, 2) \
+    COMPARE_EXCHANGE(NodeType, 1, 3) \
+    COMPARE_EXCHANGE(NodeType, 4, 6) \
+    COMPARE_EXCHANGE(NodeType, 5, 7) \
+    COMPARE_EXCHANGE(NodeType, 0, 4) \
+    COMPARE_EXCHANGE(NodeType, 1, 5) \
+    COMPARE_EXCHANGE(NodeType, 2, 6) \
+    COMPARE_EXCHANGE(NodeType, 3, 7) \
+    COMPARE_EXCHANGE(NodeType, 0, 1) \
+    COMPARE_EXCHANGE(NodeType, 2, 3) \
+    COMPARE_EXCHANGE(NodeType, 4, 5) \
+    COMPARE_EXCHANGE(NodeType, 6, 7) \
+    COMPARE_EXCHANGE(NodeType, 2, 4) \
+    COMPARE_EXCHANGE(NodeType, 3, 5) \
+    COMPARE_EXCHANGE(NodeType, 1, 4) \
+    COMPARE_EXCHANGE(NodeType, 3, 6) \
+    COMPARE_EXCHANGE(NodeType, 1, 2) \
+    COMPARE_EXCHANGE(NodeType, 3, 4) \
+    COMPARE_EXCHANGE(NodeType, 5, 6) \
+    break;
+#else
+#define SORTING_NETWORK_CASE_8(NodeType)
+#endif
+
+// Sorts nodes[0..count) with the network for count and sets isSorted, or leaves isSorted false for longer lists.
+#define SORTING_NETWORK(NodeType, isSorted) {                  \
+    uint order[SORTING_NETWORK_MAX_COUNT];                     \
+    [unroll] for (uint orderIdx = 0; orderIdx < SORTING_NETWORK_MAX_COUNT; orderIdx++) \
+        order[orderIdx] = orderIdx;                            \
+    isSorted = true;                                           \
+    [forcecase] switch (count) {                               \
+        case 0:                                                \
+        case 1: break;                                         \
+        SORTING_NETWORK_CASE_2(NodeType)                       \
+        SORTING_NETWORK_CASE_3(NodeType)                       \
+        SORTING_NETWORK_CASE_4(NodeType)                       \
+        SORTING_NETWORK_CASE_5(NodeType)                       \
+        SORTING_NETWORK_CASE_6(NodeType)                       \
+        SORTING_NETWORK_CASE_7(NodeType)                       \
+        SORTING_NETWORK_CASE_8(NodeType)                       \
+        default: isSorted = false; break;                      \
+    }                                                          \
+}
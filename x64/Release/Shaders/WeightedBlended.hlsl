@@ -0,0 +1,60 @@
+#include "Common.hlsli"
+
+#ifndef MSAA_SAMPLE_COUNT
+#define MSAA_SAMPLE_COUNT 4
+#endif
+
+// Weighted blended OIT (McGuire and Bavoil 2013), the constant memory alternative to the linked lists. PSAccumulate
+// draws the transparent geometry with the VSMain of TransparentGeometry.hlsl into two MSAA targets and CSComposite
+// lays their weighted average over the resolved opaque image. OIT/WeightedBlended.hpp mirrors both.
+
+Texture2DMS<float4>        AccumulationSRV : register(t0);
+Texture2DMS<float>         RevealageSRV    : register(t1);
+RWTexture2D<unorm float4>  BackBuffer      : register(u0);
+
+// Equation 10 of the paper. The clamp keeps a few dozen layers inside the range of R16G16B16A16_FLOAT.
+float WeightedBlendWeight(float depth, float alpha) {
+    float distance = 1.0 - depth;
+    return alpha * clamp(3.0e3 * distance * distance * distance, 1.0e-2, 3.0e3);
+}
+
+struct AccumulateOutput {
+    float4 Accumulation : SV_Target0;
+    float  Revealage    : SV_Target1;
+};
+
+// Blended with ONE/ONE into the accumulation and ZERO/INV_SRC_COLOR into the revealage, so the order of the
+// fragments does not matter. The depth test runs per sample against pDSV_MSAA without writing it.
+AccumulateOutput PSAccumulate(float4 position : SV_Position, float4 color : TEXCOORD) {
+    color = saturate(color);
+    float weight = WeightedBlendWeight(position.z, color.a);
+
+    AccumulateOutput output;
+    output.Accumulation = float4(color.rgb * color.a, color.a) * weight;
+    output.Revealage = color.a;
+    return output;
+}
+
+[numthreads(8, 8, 1)]
+void CSComposite(uint3 id: SV_DispatchThreadID) {
+
+    float revealage[MSAA_SAMPLE_COUNT];
+    bool isCovered = false;
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        revealage[sampleIdx] = RevealageSRV.Load(id.xy, sampleIdx);
+        isCovered = isCovered || revealage[sampleIdx] < 1.0;
+    }
+
+    // Untouched pixels keep the resolved opaque color, like the empty lists of CSMain.
+    if (!isCovered)
+        return;
+
+    float4 backBuffer    = BackBuffer[id.xy];
+    float4 resolveBuffer = float4(0.0, 0.0, 0.0, 0.0);
+    [unroll] for (uint sampleIdx = 0; sampleIdx < MSAA_SAMPLE_COUNT; sampleIdx++) {
+        float4 accumulation = AccumulationSRV.Load(id.xy, sampleIdx);
+        float4 average = float4(accumulation.rgb / max(accumulation.a, 1.0e-5), 1.0);
+        resolveBuffer += lerp(backBuffer, average, 1.0 - revealage[sampleIdx]);
+    }
+    BackBuffer[id.xy] = resolveBuffer / MSAA_SAMPLE_COUNT;
+}